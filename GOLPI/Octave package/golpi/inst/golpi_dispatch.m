@@ -0,0 +1,65 @@
+## Copyright 2025 Stanislav Mašláň
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU Lesser General Public License as published by
+## the Free Software Foundation version 3 of the License.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU Lesser General Public License for more details.
+##
+## You should have received a copy of the GNU Lesser General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+## -*- texinfo -*-
+## @deftypefn {Function file} golpi_dispatch (@var{Id}, @var{Cmd})
+## Function evaluates command @var{Cmd} in base workspace and encloses its
+## output by begin and end markers with request @var{Id}. This is used in project
+## GOLPI (Gnu Octave to Labview Pipes Interface) for pipelining of commands:
+## LV Process sends more tagged commands without waiting and routes the output
+## of each command to its request by the markers (see @code{proc_request_send}).
+##
+## Markers are lines "\033GpRqB@var{Id}" before and "\033GpRqE@var{Id} @var{Status}"
+## after the output, where @var{Status} is 0 if command succeeded or 1 if it
+## failed. Error message of failed command is printed before the end marker,
+## so the following commands are still executed.
+##
+## Output of @var{Cmd} must not contain ESC character (0x1B), which starts the
+## markers and binary frames. Bitstream of @code{golpi_data2bits} in both codings
+## is safe, binary data must be sent by @code{golpi_stdout_send}.
+##
+## Inputs:
+## @table @samp
+## @item @var{Id} - Request id (positive integer)
+## @item @var{Cmd} - Command string
+## @end table
+##
+## Example:
+## @example
+## golpi_dispatch(1, 'x = 5')
+## @end example
+##
+## @seealso{golpi_pipe_send, golpi_pipe_receive}
+## @end deftypefn
+
+function golpi_dispatch(Id, Cmd)
+
+  if ~ischar(Cmd)
+    error('GOLPI pipe interface: Command must be string.');
+  endif
+
+  printf("\033GpRqB%d\n", Id);
+
+  Status = 0;
+  try
+    evalin('base', Cmd);
+  catch
+    Status = 1;
+    printf("error: %s\n", lasterr());
+  end_try_catch
+
+  printf("\033GpRqE%d %d\n", Id, Status);
+  fflush(stdout);
+
+endfunction
@@ -0,0 +1,62 @@
+## Copyright 2025 Stanislav Mašláň
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU Lesser General Public License as published by
+## the Free Software Foundation version 3 of the License.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU Lesser General Public License for more details.
+##
+## You should have received a copy of the GNU Lesser General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+## -*- texinfo -*-
+## @deftypefn {Function file} golpi_pipe_send_many (@var{PipeName}, @var{Name1}, @var{Name2}, ...)
+## @deftypefnx {Function file} golpi_pipe_send_many (@var{PipeName}, @var{Name1}, @var{Name2}, ..., @var{Timeout})
+## Function sends multiple variables of caller workspace to LabVIEW via named pipe
+## in a single exchange. This is used in project GOLPI (Gnu Octave to Labview Pipes
+## Interface) to get whole parameter set with one round trip.
+## Stream starts with table of all variables (name, type and dimensions), followed
+## by data of all variables. See @code{golpi_pipe_receive_many} for format.
+##
+## Inputs:
+## @table @samp
+## @item @var{PipeName} - Windows named pipe created by caller, e.g. '\\.\Pipe\GOLPI_data_pipe'
+## @item @var{Name1}, @var{Name2}, ... - Names of caller workspace variables to send
+## @item @var{Timeout} - Total data transfer timeout [s] (optional, default 3)
+## @end table
+##
+## Example:
+## @example
+## a = 5; b = [1 2 3]; c = 'test';
+## golpi_pipe_send_many('\\.\Pipe\GOLPI_data_pipe', 'a', 'b', 'c')
+## @end example
+##
+## @seealso{golpi_pipe_send, golpi_pipe_receive_many}
+## @end deftypefn
+
+function golpi_pipe_send_many(PipeName, varargin)
+
+  % optional timeout is last numeric parameter
+  Timeout = 3.0;
+  if numel(varargin) && ~ischar(varargin{end})
+    Timeout = varargin{end};
+    varargin = varargin(1:end-1);
+  endif
+
+  if ~iscellstr(varargin)
+    error('GOLPI pipe interface: Variable names must be strings.');
+  endif
+
+  % get variables from caller workspace
+  values = cell(size(varargin));
+  for k = 1:numel(varargin)
+    values{k} = evalin('caller', varargin{k});
+  endfor
+
+  __golpi_pipe_send_many__(PipeName, varargin, values, Timeout);
+
+endfunction
+
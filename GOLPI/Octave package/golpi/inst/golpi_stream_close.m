@@ -0,0 +1,45 @@
+## Copyright 2025 Stanislav Mašláň
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU Lesser General Public License as published by
+## the Free Software Foundation version 3 of the License.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU Lesser General Public License for more details.
+##
+## You should have received a copy of the GNU Lesser General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+## -*- texinfo -*-
+## @deftypefn {Function file} @var{Var} = golpi_stream_close (@var{Handle})
+## @deftypefnx {Function file} @var{Var} = golpi_stream_close (@var{Handle}, @var{Timeout})
+## Function reads rest of data of stream opened by @code{golpi_stream_open},
+## confirms the transfer to LabVIEW and closes the stream.
+## If the rest of data does not arrive in time, stream is closed with error.
+##
+## Inputs:
+## @table @samp
+## @item @var{Handle} - Stream handle
+## @item @var{Timeout} - Total timeout for rest of data [s] (optional, default 3)
+## @end table
+##
+## Outputs:
+## @table @samp
+## @item @var{Var} - Complete streamed variable
+## @end table
+##
+## @seealso{golpi_stream_open, golpi_stream_read}
+## @end deftypefn
+
+function Var = golpi_stream_close(Handle, Timeout)
+
+  if nargin < 2
+    Timeout = 3.0;
+  endif
+
+  Var = __golpi_stream__('close', Handle, Timeout);
+
+endfunction
+
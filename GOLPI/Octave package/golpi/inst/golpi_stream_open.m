@@ -0,0 +1,71 @@
+## Copyright 2025 Stanislav Mašláň
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU Lesser General Public License as published by
+## the Free Software Foundation version 3 of the License.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU Lesser General Public License for more details.
+##
+## You should have received a copy of the GNU Lesser General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+## -*- texinfo -*-
+## @deftypefn {Function file} @var{Handle} = golpi_stream_open (@var{PipeName}, @var{Type}, @var{Dims})
+## Function opens chunked stream of variable from LabVIEW via named pipe.
+## Destination variable of given type and size is preallocated and its data
+## are appended as they arrive by @code{golpi_stream_read}, so the record can be
+## processed block by block while LabVIEW still sends the rest. This is used in
+## project GOLPI (Gnu Octave to Labview Pipes Interface).
+## LabVIEW sends raw variable data in any chunks (column-major order, complex
+## as re,im,re,im, ...) and waits for ACK after the last one, which is sent by
+## @code{golpi_stream_close}.
+##
+## Inputs:
+## @table @samp
+## @item @var{PipeName} - Windows named pipe created by caller, e.g. '\\.\Pipe\GOLPI_data_pipe'
+## @item @var{Type} - Variable type: 'char', 'int8', 'uint8', 'int16', 'uint16',
+##      'int32', 'uint32', 'int64', 'uint64', 'double', 'complex', 'single',
+##      'single complex', 'logical' or numeric GOLPI type id
+## @item @var{Dims} - Variable dimensions [rows, columns]
+## @end table
+##
+## Outputs:
+## @table @samp
+## @item @var{Handle} - Stream handle
+## @end table
+##
+## Example:
+## @example
+## h = golpi_stream_open('\\.\Pipe\GOLPI_data_pipe', 'double', [1e6 1]);
+## [count, block] = golpi_stream_read(h, 1.0);
+## y = golpi_stream_close(h);
+## @end example
+##
+## @seealso{golpi_stream_read, golpi_stream_close, golpi_pipe_receive}
+## @end deftypefn
+
+function Handle = golpi_stream_open(PipeName, Type, Dims)
+
+  % type names in order of GOLPI type ids
+  types = {'char','int8','uint8','int16','uint16','int32','uint32','double','complex','single','single complex','int64','uint64','logical'};
+
+  if ischar(Type)
+    type_id = find(strcmpi(Type, types));
+    if isempty(type_id)
+      error('GOLPI pipe interface: Unknown stream variable type ''%s''.', Type);
+    endif
+  else
+    type_id = Type;
+  endif
+
+  if numel(Dims) ~= 2
+    error('GOLPI pipe interface: Stream dimensions must be [rows, columns].');
+  endif
+
+  Handle = __golpi_stream__('open', PipeName, type_id, Dims(1), Dims(2));
+
+endfunction
+
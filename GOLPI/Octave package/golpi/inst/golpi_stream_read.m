@@ -0,0 +1,61 @@
+## Copyright 2025 Stanislav Mašláň
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU Lesser General Public License as published by
+## the Free Software Foundation version 3 of the License.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU Lesser General Public License for more details.
+##
+## You should have received a copy of the GNU Lesser General Public License
+## along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+## -*- texinfo -*-
+## @deftypefn {Function file} @var{Count} = golpi_stream_read (@var{Handle})
+## @deftypefnx {Function file} [@var{Count}, @var{Block}] = golpi_stream_read (@var{Handle}, @var{Timeout})
+## Function appends data of stream opened by @code{golpi_stream_open}, which
+## arrived since the last call, to the preallocated variable. It does not wait
+## for the whole variable.
+##
+## Inputs:
+## @table @samp
+## @item @var{Handle} - Stream handle
+## @item @var{Timeout} - Max time to wait for first new data [s] (optional, default 0 - just take what is in the pipe)
+## @end table
+##
+## Outputs:
+## @table @samp
+## @item @var{Count} - Total count of elements received so far
+## @item @var{Block} - Column vector of elements received by this call
+## @end table
+##
+## Example:
+## @example
+## h = golpi_stream_open('\\.\Pipe\GOLPI_data_pipe', 'single', [1e6 1]);
+## count = 0;
+## while count < 1e6
+##   [count, block] = golpi_stream_read(h, 1.0);
+##   % process block ...
+## endwhile
+## y = golpi_stream_close(h);
+## @end example
+##
+## @seealso{golpi_stream_open, golpi_stream_close}
+## @end deftypefn
+
+function [Count, Block] = golpi_stream_read(Handle, Timeout)
+
+  if nargin < 2
+    Timeout = 0.0;
+  endif
+
+  if nargout > 1
+    [Count, Block] = __golpi_stream__('read', Handle, Timeout);
+  else
+    Count = __golpi_stream__('read', Handle, Timeout);
+  endif
+
+endfunction
+
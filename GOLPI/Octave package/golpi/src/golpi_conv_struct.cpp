@@ -0,0 +1,339 @@
+//------------------------------------------------------------------------------
+// Native serializer of structure content into binary stream for structure to
+// cluster transfer in GOLPI. Replaces golpi_conv_struct.m with the same stream
+// format. Output size is evaluated by first pass over the structure, second
+// pass writes the items into single preallocated buffer and fills the item
+// sizes and cell offset tables in place, so the conversion is linear in the
+// number of items.
+//
+// Stream format:
+//   DWORD - items count
+//   for each item:
+//     DWORD - item record size (without this DWORD)
+//     BYTE  - item name length
+//     BYTES - item name (no '\0' at the end, empty for string or structure
+//             array input)
+//     BYTE  - item type (0bC000TTTT, C - complex, TTTT: 0 - int32, 2 - single,
+//             3 - double, 4 - string, 5 - array of items)
+//     DWORD - rows count
+//     DWORD - columns count
+//     for array of items:
+//       DWORD - byte offset of each element relative to end of this table
+//       BYTES - elements, each is stream of this format (nested call)
+//     else:
+//       BYTES - item data, little-endian
+//
+// Usage:
+//   [bin] = golpi_conv_struct(Data)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+#include <octave/Cell.h>
+#include <stdint.h>
+#include <string.h>
+
+// item types
+#define ITYPE_NONE -1
+#define ITYPE_INT32 0
+#define ITYPE_SGL 2
+#define ITYPE_DBL 3
+#define ITYPE_STRING 4
+#define ITYPE_ARRAY 5
+#define ITYPE_COMPLEX 0x80
+
+// max stream size (32bit sizes and offsets)
+#define MAX_STREAM_SIZE 0xFFFFFFFFull
+
+// item header size without name: record size, name length, type, rows, columns
+#define ITEM_HEAD_SIZE (4 + 1 + 1 + 4 + 4)
+
+static uint64_t conv_size_stream(const octave_value &data);
+static char *conv_write_stream(char *dst, const octave_value &data);
+
+
+// check dimensions are 2D vector
+static bool is_vector(const dim_vector &dims)
+{
+    return(dims.length() == 2 && (dims(0) == 1 || dims(1) == 1));
+}
+
+// identify item type and size of one element of its data
+static int item_get_type(const octave_value &it, size_t &elem_size)
+{
+    elem_size = 0;
+    if(it.ndims() > 2)
+        return(ITYPE_NONE);
+    if(it.is_map() || it.class_name().compare("cell") == 0)
+        return(ITYPE_ARRAY);
+    if(it.is_string())
+    {
+        elem_size = 1;
+        return(is_vector(it.dims()) ? ITYPE_STRING : ITYPE_NONE);
+    }
+    int type = ITYPE_NONE;
+    if(it.is_int32_type())
+    {
+        type = ITYPE_INT32;
+        elem_size = 4;
+    }
+    else if(it.is_single_type())
+    {
+        type = ITYPE_SGL;
+        elem_size = 4;
+    }
+    else if(it.is_double_type())
+    {
+        type = ITYPE_DBL;
+        elem_size = 8;
+    }
+    if(type != ITYPE_NONE && it.is_complex_type())
+    {
+        type |= ITYPE_COMPLEX;
+        elem_size *= 2;
+    }
+    return(type);
+}
+
+// get elements of array item (struct array is handled as cell array of structs)
+static Cell item_get_elements(const octave_value &it)
+{
+    if(it.is_map())
+    {
+        octave_map map = it.map_value();
+        Cell cell(map.dims());
+        for(octave_idx_type k = 0; k < map.numel(); k++)
+            cell(k) = map.checkelem(k);
+        return(cell);
+    }
+    return(it.cell_value());
+}
+
+// size of item record
+static uint64_t conv_size_item(const std::string &name, const octave_value &it)
+{
+    size_t elem_size;
+    int type = item_get_type(it, elem_size);
+    if(type == ITYPE_NONE)
+        return(0);
+    uint64_t size = ITEM_HEAD_SIZE + name.size();
+    if(type != ITYPE_ARRAY)
+        return(size + (uint64_t)it.numel()*elem_size);
+
+    Cell cell = item_get_elements(it);
+    size += 4*(uint64_t)cell.numel();
+    for(octave_idx_type k = 0; k < cell.numel(); k++)
+        size += conv_size_stream(cell(k));
+    return(size);
+}
+
+// size of stream of structure, string or anything else
+static uint64_t conv_size_stream(const octave_value &data)
+{
+    uint64_t size = 4;
+    if(data.is_string())
+        size += conv_size_item("", data);
+    else if(data.is_map() && data.numel() != 1)
+        size += conv_size_item("", data);
+    else if(data.is_map())
+    {
+        octave_scalar_map map = data.scalar_map_value();
+        string_vector keys = map.keys();
+        for(octave_idx_type f = 0; f < keys.numel(); f++)
+            size += conv_size_item(keys(f), map.contents(keys(f)));
+    }
+    return(size);
+}
+
+// write DWORD
+static inline char *write_dword(char *dst, uint64_t value)
+{
+    uint32_t v = (uint32_t)value;
+    memcpy((void*)dst, (void*)&v, 4);
+    return(dst + 4);
+}
+
+// write item record, returns NULL if item is not supported
+static char *conv_write_item(char *dst, const std::string &name, const octave_value &it)
+{
+    size_t elem_size;
+    int type = item_get_type(it, elem_size);
+    if(type == ITYPE_NONE)
+        return(NULL);
+
+    // item header (record size is filled when done)
+    char *item = dst;
+    dst += 4;
+    *dst++ = (char)(name.size() > 255 ? 255 : name.size());
+    memcpy((void*)dst, (void*)name.data(), name.size());
+    dst += name.size();
+    *dst++ = (char)type;
+    dst = write_dword(dst, it.rows());
+    dst = write_dword(dst, it.columns());
+
+    size_t size = it.numel()*elem_size;
+    switch(type)
+    {
+        case ITYPE_INT32:
+            memcpy((void*)dst, (void*)it.int32_array_value().data(), size);
+            break;
+        case ITYPE_SGL:
+            memcpy((void*)dst, (void*)it.float_array_value().data(), size);
+            break;
+        case ITYPE_SGL|ITYPE_COMPLEX:
+            memcpy((void*)dst, (void*)it.float_complex_array_value().data(), size);
+            break;
+        case ITYPE_DBL:
+            memcpy((void*)dst, (void*)it.array_value().data(), size);
+            break;
+        case ITYPE_DBL|ITYPE_COMPLEX:
+            memcpy((void*)dst, (void*)it.complex_array_value().data(), size);
+            break;
+        case ITYPE_STRING:
+            memcpy((void*)dst, (void*)it.char_array_value().data(), size);
+            break;
+        case ITYPE_ARRAY:
+        {
+            // offsets table followed by element streams, offsets are relative to end of table
+            Cell cell = item_get_elements(it);
+            char *offsets = dst;
+            char *base = dst + 4*cell.numel();
+            dst = base;
+            for(octave_idx_type k = 0; k < cell.numel(); k++)
+            {
+                offsets = write_dword(offsets, dst - base);
+                dst = conv_write_stream(dst, cell(k));
+            }
+            size = 0;
+            break;
+        }
+    }
+    dst += size;
+
+    // store item record size
+    write_dword(item, dst - item - 4);
+    return(dst);
+}
+
+// write stream of structure, string or anything else
+static char *conv_write_stream(char *dst, const octave_value &data)
+{
+    char *stream = dst;
+    uint32_t count = 0;
+    dst += 4;
+    if(data.is_string())
+    {
+        // string is sent as fake structure with single unnamed item
+        char *next = conv_write_item(dst, "", data);
+        if(next)
+        {
+            dst = next;
+            count++;
+        }
+    }
+    else if(data.is_map() && data.numel() != 1)
+    {
+        // structure array is sent as fake structure with single unnamed array item
+        char *next = conv_write_item(dst, "", data);
+        if(next)
+        {
+            dst = next;
+            count++;
+        }
+    }
+    else if(data.is_map())
+    {
+        octave_scalar_map map = data.scalar_map_value();
+        string_vector keys = map.keys();
+        for(octave_idx_type f = 0; f < keys.numel(); f++)
+        {
+            char *next = conv_write_item(dst, keys(f), map.contents(keys(f)));
+            if(next)
+            {
+                dst = next;
+                count++;
+            }
+        }
+    }
+
+    // store items count
+    write_dword(stream, count);
+    return(dst);
+}
+
+
+// convert structure to binary stream
+DEFUN_DLD(golpi_conv_struct, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn {Loadable Function} @var{BIN} = golpi_conv_struct (@var{Data} )\n\
+Function codes structure content into binary stream @var{BIN} of 'uint8'.\n\
+This is useful for simple transfer of structures to LabVIEW via GOLPI\n\
+(Gnu Octave to Labview Pipes Interface). Nested structures, arrays of structures\n\
+and cell arrays are supported. Function can process only two dimensional matrices/arrays.\n\
+\n\
+Format of the output stream:\n\
+Stream starts with uint32, which is the number of items in the @var{Data}.\n\
+Stream continues with items, each item contains:\n\
+@table @asis\n\
+@item uint32 - size of the rest of the item record in bytes,\n\
+@item uint8 - length of name of the item,\n\
+@item string - name of the item with no '\\0' at the end, if @var{Data} was char\n\
+@item        string this string will be empty,\n\
+@item uint8 - item data type format (see lower),\n\
+@item uint32 - rows count,\n\
+@item uint32 - columns count,\n\
+@item optional for array/cell array of items - for each cell/array item:\n\
+@table @asis\n\
+@item uint32 - byte offset of the cell stream relative to end of offsets list,\n\
+@end table\n\
+@item uint8 - item data converted to uint8, little-endian.\n\
+@end table\n\
+\n\
+Item data type format 0bC000TTTT:\n\
+@table @asis\n\
+@item C    - is complex\n\
+@item TTTT - data type:\n\
+@item  0 - int32\n\
+@item  2 - single real\n\
+@item  3 - double real\n\
+@item  4 - single string\n\
+@item  5 - array or cell array of items\n\
+@end table\n\
+\n\
+When structure item is another structure or array of structures or\n\
+cell array of anything, the binary item data are streams of the same\n\
+format, one per each cell. Items of other types are skipped.\n\
+If @var{Data} itself is an array of structures (also when nested in cell),\n\
+the stream contains single unnamed array item with stream of each element.\n\
+\n\
+Example:\n\
+@example\n\
+s.a=5; s.b = \"test\";\n\
+golpi_conv_struct(s)\n\
+@end example\n\
+\n\
+@seealso{GOLPI}\n\
+@end deftypefn")
+{
+    octave_value_list res;
+
+    if(args.length() != 1)
+        print_usage();
+    octave_value data = args(0);
+
+    // first pass: total stream size
+    uint64_t size = conv_size_stream(data);
+    if(size > MAX_STREAM_SIZE)
+        error("golpi_conv_struct: Stream size exceeds 4 GB.");
+
+    // second pass: write stream to preallocated buffer
+    uint8NDArray bin(dim_vector(size, 1));
+    char *end = conv_write_stream((char*)bin.fortran_vec(), data);
+    if((uint64_t)(end - (char*)bin.fortran_vec()) != size)
+        error("golpi_conv_struct: Internal error, stream size mismatch.");
+
+    res(0) = bin;
+    return res;
+}
+
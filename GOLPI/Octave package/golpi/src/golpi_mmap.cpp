@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+// Memory mapped files shared by golpi_mmap_load() and golpi_mmap_save().
+// Whole file is mapped into single view, so the data are copied directly
+// between the system file cache and the Octave arrays.
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include <stdint.h>
+#include <ctype.h>
+#include "golpi_mmap.hpp"
+
+// init empty mapped file
+static void map_init(TMapFile *mf)
+{
+    mf->file = INVALID_HANDLE_VALUE;
+    mf->map = NULL;
+    mf->data = NULL;
+    mf->size = 0;
+}
+
+// map whole file into view
+static DWORD map_view(TMapFile *mf, bool write)
+{
+    if(mf->size > (uint64_t)(SIZE_T)-1)
+        return(ERROR_NOT_ENOUGH_MEMORY);
+    mf->map = CreateFileMapping(mf->file, NULL, write ? PAGE_READWRITE : PAGE_READONLY, (DWORD)(mf->size >> 32), (DWORD)mf->size, NULL);
+    if(!mf->map)
+        return(GetLastError());
+    mf->data = (char*)MapViewOfFile(mf->map, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, (SIZE_T)mf->size);
+    if(!mf->data)
+        return(GetLastError());
+    return(0);
+}
+
+// map whole existing file for reading, returns 0 if ok
+DWORD map_open(TMapFile *mf, std::string path)
+{
+    map_init(mf);
+
+    // file may be still opened by caller (e.g. temp files pool of LV Process)
+    mf->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if(mf->file == INVALID_HANDLE_VALUE)
+        return(GetLastError());
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(mf->file, &size))
+        return(GetLastError());
+    mf->size = size.QuadPart;
+
+    // empty file cannot be mapped
+    if(!mf->size)
+        return(0);
+    return(map_view(mf, false));
+}
+
+// create file of given size and map it for writing, returns 0 if ok
+DWORD map_create(TMapFile *mf, std::string path, uint64_t size)
+{
+    map_init(mf);
+
+    mf->file = CreateFileA(path.c_str(), GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(mf->file == INVALID_HANDLE_VALUE)
+        return(GetLastError());
+    mf->size = size;
+
+    // mapping extends the file to its size
+    if(!mf->size)
+        return(0);
+    return(map_view(mf, true));
+}
+
+// unmap and close file
+void map_close(TMapFile *mf)
+{
+    if(mf->data)
+        UnmapViewOfFile(mf->data);
+    if(mf->map)
+        CloseHandle(mf->map);
+    if(mf->file != INVALID_HANDLE_VALUE)
+        CloseHandle(mf->file);
+    map_init(mf);
+}
+
+// check variable name is valid identifier
+bool mat4_check_name(std::string name)
+{
+    if(name.empty() || isdigit((unsigned char)name[0]))
+        return(false);
+    for(size_t k = 0; k < name.size(); k++)
+        if(!isalnum((unsigned char)name[k]) && name[k] != '_')
+            return(false);
+    return(true);
+}
@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+// Memory mapped MAT-4 files shared by golpi_mmap_load() and golpi_mmap_save().
+//
+// MAT-4 record format:
+//   INT32 - MOPT type (M*1000 + O*100 + P*10 + T), M: 0 - little-endian,
+//           1 - big-endian, O: 0, P: 0 - double, 1 - single, 2 - int32,
+//           3 - int16, 4 - uint16, 5 - uint8, T: 0 - numeric, 1 - text,
+//           2 - sparse
+//   INT32 - rows count
+//   INT32 - columns count
+//   INT32 - imaginary flag
+//   INT32 - name length including '\0'
+//   BYTES - name
+//   BYTES - real part, column-major
+//   BYTES - imaginary part, column-major (if imaginary flag set)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+//#include <octave/oct.h>
+//#include <windows.h>
+//#include <stdint.h>
+
+// MAT-4 record header size
+#define MAT4_HEAD_SIZE 20
+
+// MAT-4 precisions
+#define MAT4_PREC_DBL 0
+#define MAT4_PREC_SGL 1
+#define MAT4_PREC_INT32 2
+#define MAT4_PREC_INT16 3
+#define MAT4_PREC_UINT16 4
+#define MAT4_PREC_UINT8 5
+
+// MAT-4 matrix types
+#define MAT4_TYPE_NUMERIC 0
+#define MAT4_TYPE_TEXT 1
+#define MAT4_TYPE_SPARSE 2
+
+// --- Mapped file ---
+typedef struct{
+    HANDLE file;
+    HANDLE map;
+    char *data; /* view of whole file */
+    uint64_t size; /* file size */
+}TMapFile;
+
+// map whole existing file for reading, returns 0 if ok
+DWORD map_open(TMapFile *mf, std::string path);
+
+// create file of given size and map it for writing, returns 0 if ok
+DWORD map_create(TMapFile *mf, std::string path, uint64_t size);
+
+// unmap and close file
+void map_close(TMapFile *mf);
+
+// check variable name is valid identifier
+bool mat4_check_name(std::string name);
@@ -321,3 +321,386 @@ DWORD ReadFileTimeout(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, d
 
 
 
+// read whatever data are available, up to size, waiting max timeout for the first data
+// returns non-zero only on pipe failure, on timeout it returns zero with *read_bytes = 0
+DWORD ReadFileTimeoutSome(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, double timeout)
+{
+    *read_bytes = 0;
+
+    // empty data?
+    if(!size)
+        return(0);
+
+    // create ReadFile() async wait event
+    HANDLE hEvent = CreateEvent(NULL, true, false, NULL);
+    if(!hEvent)
+        return(1);
+    OVERLAPPED overlap;
+    overlap.Offset = 0;
+    overlap.OffsetHigh = 0;
+    overlap.hEvent = hEvent;
+
+    // start async ReadFile() - it completes as soon as some data are in the pipe
+    if(!ReadFile(file, data, size, NULL, &overlap))
+    {
+        DWORD err = GetLastError();
+        if(err != ERROR_IO_PENDING && err != ERROR_MORE_DATA)
+        {
+            if(DEBUG_PRN)
+                octave_stdout << "read io not pending (err = " << err << ")\n";
+            CloseHandle(hEvent);
+            return(1);
+        }
+    }
+
+    // wait with timeout
+    if(WaitForSingleObject(hEvent, (DWORD)(timeout*1000.0)) == WAIT_TIMEOUT)
+        CancelIo(file);
+
+    // get ReadFile() result, wait for cancellation so no data are lost when read completed meanwhile
+    DWORD read = 0;
+    if(!GetOverlappedResult(file, &overlap, &read, true))
+    {
+        DWORD err = GetLastError();
+        if(err != ERROR_OPERATION_ABORTED && err != ERROR_MORE_DATA)
+        {
+            CloseHandle(hEvent);
+            return(1);
+        }
+    }
+    *read_bytes = read;
+
+    if(DEBUG_PRN)
+        octave_stdout << "read some, read = " << read << "\n";
+
+    // cleanup
+    CloseHandle(hEvent);
+
+    return(0);
+}
+
+
+
+// read synchronous (anonymous) pipe with timeout, e.g. stdin of Octave process
+// overlapped reads are not possible on these, so the pipe is polled and only the available data are read
+// 'some' returns as soon as some data are read, on its timeout it returns zero with *read_bytes = 0
+DWORD ReadPipeSyncTimeout(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, double timeout, bool some)
+{
+    *read_bytes = 0;
+
+    TTimer timer;
+    timer_init(&timer);
+
+    char *p = (char*)data;
+    DWORD read_total = 0;
+    int idle = 0;
+    while(read_total < size)
+    {
+        DWORD avail;
+        if(!PeekNamedPipe(file, NULL, 0, NULL, &avail, NULL))
+            return(1);
+        if(avail)
+        {
+            DWORD read;
+            if(!ReadFile(file, (void*)&p[read_total], min(avail, size - read_total), &read, NULL))
+                return(1);
+            read_total += read;
+            *read_bytes = read_total;
+            idle = 0;
+            if(some)
+                break;
+            continue;
+        }
+
+        if(timer_get(&timer) >= timeout)
+        {
+            if(DEBUG_PRN)
+                octave_stdout << "sync read timeout\n";
+            return(some ? 0 : 1);
+        }
+
+        // yield first, then sleep, so short gaps do not cost whole scheduler tick
+        if(idle++ < 100)
+            SwitchToThread();
+        else
+            Sleep(1);
+    }
+
+    return(0);
+}
+
+
+
+// write binary frame to synchronous pipe (stdout of Octave process)
+DWORD WriteFrame(HANDLE file, DWORD channel, DWORD flags, const void *data, DWORD size)
+{
+    char head[FRAME_OUT_HEAD_SIZE];
+    memcpy((void*)head, (void*)FRAME_OUT_ID, FRAME_OUT_ID_LEN);
+    head[FRAME_OUT_ID_LEN] = (char)channel;
+    head[FRAME_OUT_ID_LEN + 1] = (char)flags;
+    memcpy((void*)&head[FRAME_OUT_ID_LEN + 2], (void*)&size, sizeof(DWORD));
+
+    // reader thread of LV Process drains stdout all the time, so plain blocking writes
+    const char *parts[2] = {head, (const char*)data};
+    DWORD sizes[2] = {FRAME_OUT_HEAD_SIZE, size};
+    for(int k = 0; k < 2; k++)
+    {
+        while(sizes[k])
+        {
+            DWORD written;
+            if(!WriteFile(file, (void*)parts[k], sizes[k], &written, NULL))
+                return(1);
+            parts[k] += written;
+            sizes[k] -= written;
+        }
+    }
+    return(0);
+}
+
+
+
+// open existing data pipe created by caller
+HANDLE OpenDataPipe(std::string pipe_name)
+{
+    return CreateFileA(
+		    pipe_name.c_str(), 
+		    GENERIC_READ | GENERIC_WRITE, // access
+        0, // sharing
+        NULL, // security
+        OPEN_EXISTING, // create mode
+        FILE_FLAG_OVERLAPPED, // other
+        NULL // template
+        );
+}
+
+// send ACK or NACK message
+DWORD SendACK(HANDLE file, bool ack)
+{
+    char state = (ack)?'a':'n';
+    DWORD written;
+    WriteFile(file, &state, 1, &written, NULL);  
+    char res;    
+    ReadFileTimeout(file, &res, 1, NULL, 1.0);
+    if(DEBUG_PRN)
+        octave_stdout << "ack response " << (int)res << "\n";
+    return(written);    
+}
+
+// wait for ACK message and confirm it
+DWORD WaitACK(HANDLE file)
+{
+    char res;
+    if(ReadFileTimeout(file, &res, 1, NULL, 1.0))
+        return(0);
+    if(WriteFileTimeout(file, &res, 1, NULL, 0, 0.1))      
+        return(0);
+    return(1);    
+}
+
+
+// --- Buffered writer of ACK blocks ---
+
+// init writer for pipe
+DWORD writer_init(TPipeWriter *wr, HANDLE file, DWORD block_size, double timeout)
+{
+    wr->file = file;
+    wr->block_size = (block_size)?block_size:65536;
+    wr->used = 0;
+    wr->timeout = timeout;
+    wr->channel = -1;
+    timer_init(&wr->timer);
+    wr->buf = (char*)malloc(wr->block_size);
+    if(!wr->buf)
+        return(1);
+    return(0);
+}
+
+// send blocks as stdout frames of given channel instead of ACK blocks
+void writer_set_frames(TPipeWriter *wr, int channel)
+{
+    wr->channel = channel;
+}
+
+// send data as ACK blocks or frames
+static DWORD writer_send(TPipeWriter *wr, const void *data, DWORD size)
+{
+    if(wr->channel >= 0)
+        return(WriteFrame(wr->file, wr->channel, 0, data, size));
+    double timeout = wr->timeout - timer_get(&wr->timer);
+    if(timeout <= 0.0 || WriteFileTimeoutACK(wr->file, (void*)data, size, NULL, wr->block_size, timeout))
+        return(1);
+    return(0);
+}
+
+// write data (buffered)
+DWORD writer_write(TPipeWriter *wr, const void *data, DWORD size)
+{
+    const char *pdata = (const char*)data;
+    
+    // fill pending block first
+    if(wr->used)
+    {
+        DWORD tocpy = min(size, wr->block_size - wr->used);
+        memcpy((void*)&wr->buf[wr->used], (void*)pdata, tocpy);
+        wr->used += tocpy;
+        pdata += tocpy;
+        size -= tocpy;
+        if(wr->used == wr->block_size && writer_flush(wr))
+            return(1);
+    }
+    
+    // send whole blocks directly from source data
+    if(size >= wr->block_size)
+    {
+        DWORD direct = size - size%wr->block_size;
+        if(writer_send(wr, (void*)pdata, direct))
+            return(1);
+        pdata += direct;
+        size -= direct;
+    }
+    
+    // store remainder
+    if(size)
+    {
+        memcpy((void*)&wr->buf[wr->used], (void*)pdata, size);
+        wr->used += size;
+    }
+    
+    return(0);
+}
+
+// send buffered data
+DWORD writer_flush(TPipeWriter *wr)
+{
+    if(!wr->used)
+        return(0);
+    if(writer_send(wr, (void*)wr->buf, wr->used))
+        return(1);
+    wr->used = 0;
+    return(0);
+}
+
+// free writer buffer
+void writer_free(TPipeWriter *wr)
+{
+    if(wr->buf)
+        free((void*)wr->buf);
+    wr->buf = NULL;
+    wr->used = 0;
+}
+
+
+// --- Buffered reader ---
+
+// init reader for pipe
+DWORD reader_init(TPipeReader *rd, HANDLE file, DWORD block_size, double timeout)
+{
+    rd->file = file;
+    rd->block_size = (block_size)?block_size:65536;
+    rd->pos = 0;
+    rd->used = 0;
+    rd->timeout = timeout;
+    rd->sync = false;
+    rd->limited = false;
+    rd->remain = 0;
+    timer_init(&rd->timer);
+    rd->buf = (char*)malloc(rd->block_size);
+    if(!rd->buf)
+        return(1);
+    return(0);
+}
+
+// limit reads from pipe to 'limit' bytes, so the reader never takes data following the record
+void reader_set_limit(TPipeReader *rd, DWORD limit, bool sync)
+{
+    rd->limited = true;
+    rd->remain = limit;
+    rd->sync = sync;
+}
+
+// read from pipe, up to the limit
+static DWORD reader_pipe_read(TPipeReader *rd, void *data, DWORD size, DWORD *read, double timeout, bool some)
+{
+    *read = 0;
+    if(rd->limited)
+    {
+        if(!rd->remain || (!some && size > rd->remain))
+            return(1);
+        size = min(size, rd->remain);
+    }
+    DWORD err;
+    if(rd->sync)
+        err = ReadPipeSyncTimeout(rd->file, data, size, read, timeout, some);
+    else if(some)
+        err = ReadFileTimeoutSome(rd->file, data, size, read, timeout);
+    else
+        err = ReadFileTimeout(rd->file, data, size, read, timeout);
+    if(!err && rd->limited)
+        rd->remain -= *read;
+    return(err);
+}
+
+// read data (buffered)
+DWORD reader_read(TPipeReader *rd, void *data, DWORD size)
+{
+    char *pdata = (char*)data;
+    
+    // take buffered data first
+    DWORD tocpy = min(size, rd->used - rd->pos);
+    memcpy((void*)pdata, (void*)&rd->buf[rd->pos], tocpy);
+    rd->pos += tocpy;
+    pdata += tocpy;
+    size -= tocpy;
+    
+    while(size)
+    {
+        double timeout = rd->timeout - timer_get(&rd->timer);
+        if(timeout <= 0.0)
+            return(1);
+    
+        // large data: read directly to destination
+        DWORD read;
+        if(size >= rd->block_size)
+            return(reader_pipe_read(rd, (void*)pdata, size, &read, timeout, false));
+        
+        // refill buffer with whatever is in the pipe
+        if(reader_pipe_read(rd, (void*)rd->buf, rd->block_size, &read, timeout, true))
+            return(1);
+        rd->pos = 0;
+        rd->used = read;
+        
+        tocpy = min(size, read);
+        memcpy((void*)pdata, (void*)rd->buf, tocpy);
+        rd->pos += tocpy;
+        pdata += tocpy;
+        size -= tocpy;
+    }
+    
+    return(0);
+}
+
+// read and drop the rest of limited data
+DWORD reader_skip(TPipeReader *rd)
+{
+    rd->pos = rd->used;
+    while(rd->limited && rd->remain)
+    {
+        double timeout = rd->timeout - timer_get(&rd->timer);
+        if(timeout <= 0.0)
+            return(1);
+        DWORD read;
+        if(reader_pipe_read(rd, (void*)rd->buf, rd->block_size, &read, timeout, true))
+            return(1);
+    }
+    return(0);
+}
+
+// free reader buffer
+void reader_free(TPipeReader *rd)
+{
+    if(rd->buf)
+        free((void*)rd->buf);
+    rd->buf = NULL;
+    rd->pos = 0;
+    rd->used = 0;
+}
@@ -20,6 +20,7 @@
 //------------------------------------------------------------------------------
 //#include <octave/oct.h>
 //#include <windows.h>
+#include <memory>
 
 // variable type IDs
 #define VTYPE_ERROR 0 /* unknown type */
@@ -34,6 +35,40 @@
 #define VTYPE_CDBL 9 /* 64bit complex float (re,im,re,im, ...) */
 #define VTYPE_SGL 10 /* 32bit float */
 #define VTYPE_CSGL 11 /* 32bit complex float (re,im,re,im, ...) */
+#define VTYPE_INT64 12 /* 64bit signed integer */
+#define VTYPE_UINT64 13 /* 64bit unsigned integer */
+#define VTYPE_LOGICAL 14 /* logical (1 byte per element) */
+#define VTYPE_CELL 15 /* cell array (nested variable records) */
+#define VTYPE_CELLSTR 16 /* cell array of strings (length prefixed strings) */
+#define VTYPE_STRUCT 17 /* struct or struct array (field names and nested variable records) */
+#define VTYPE_SPARSE 18 /* sparse 64bit float (CSC: column pointers, row indices, values) */
+#define VTYPE_SPARSE_CDBL 19 /* sparse 64bit complex float (CSC) */
+#define VTYPE_SPARSE_LOGICAL 20 /* sparse logical (CSC) */
+
+
+// --- Binary frames over process stdin/stdout ---
+// Frame format:
+//   BYTES - FRAME_ID
+//   DWORD - record size
+//   BYTES - variable record (variable_type_id, rows_count, columns_count, data)
+#define FRAME_ID "GpFr"
+#define FRAME_ID_LEN 4
+// frame header size
+#define FRAME_HEAD_SIZE (FRAME_ID_LEN + 4)
+// marker printed to stdout when Octave waits for frame on stdin
+#define FRAME_READY "GOLPIready\n"
+// frames sent by Octave via stdout (demultiplexed from text by LV Process):
+//   BYTES - FRAME_OUT_ID
+//   BYTE  - channel
+//   BYTE  - flags (FRAME_FLAG_LAST - last frame of message, FRAME_FLAG_ERROR - discard message)
+//   DWORD - data size
+//   BYTES - data
+// message is sent as sequence of frames of the same channel
+#define FRAME_OUT_ID "\x1b" "GpFr"
+#define FRAME_OUT_ID_LEN 5
+#define FRAME_OUT_HEAD_SIZE (FRAME_OUT_ID_LEN + 1 + 1 + 4)
+#define FRAME_FLAG_LAST 0x01
+#define FRAME_FLAG_ERROR 0x02
 
 
 // enable some debug prints
@@ -55,5 +90,125 @@ double timer_get(TTimer *timer);
 
 // read file with timeout
 DWORD ReadFileTimeout(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, double timeout);
+DWORD ReadFileTimeoutSome(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, double timeout);
 DWORD WriteFileTimeout(HANDLE file, LPVOID data, DWORD size, DWORD *written_bytes, DWORD block_size, double timeout);
-DWORD WriteFileTimeoutACK(HANDLE file, LPVOID data, DWORD size, DWORD *written_bytes, DWORD block_size, double total_timeout);
\ No newline at end of file
+DWORD WriteFileTimeoutACK(HANDLE file, LPVOID data, DWORD size, DWORD *written_bytes, DWORD block_size, double total_timeout);
+
+// read synchronous (anonymous) pipe with timeout, e.g. stdin of Octave process
+// 'some' returns as soon as some data are read, on its timeout it returns zero with *read_bytes = 0
+DWORD ReadPipeSyncTimeout(HANDLE file, LPVOID data, DWORD size, DWORD *read_bytes, double timeout, bool some);
+
+// write binary frame to synchronous pipe (stdout of Octave process)
+DWORD WriteFrame(HANDLE file, DWORD channel, DWORD flags, const void *data, DWORD size);
+
+// open existing data pipe created by caller
+HANDLE OpenDataPipe(std::string pipe_name);
+
+// ACK handshakes
+DWORD SendACK(HANDLE file, bool ack);
+DWORD WaitACK(HANDLE file);
+
+// --- Buffered writer of ACK blocks ---
+// Gathers small writes into blocks so multiple variable records can be sent in a single ACK block (or stdout frame),
+// large writes are sent directly from the source buffer.
+typedef struct{
+    HANDLE file;
+    char *buf; /* block buffer */
+    DWORD block_size; /* max ACK block size */
+    DWORD used; /* bytes waiting in buffer */
+    TTimer timer;
+    double timeout; /* total timeout */
+    int channel; /* stdout frames channel, -1 for ACK blocks */
+}TPipeWriter;
+
+// init writer for pipe
+DWORD writer_init(TPipeWriter *wr, HANDLE file, DWORD block_size, double timeout);
+
+// send blocks as stdout frames of given channel instead of ACK blocks
+void writer_set_frames(TPipeWriter *wr, int channel);
+
+// write data (buffered)
+DWORD writer_write(TPipeWriter *wr, const void *data, DWORD size);
+
+// send buffered data
+DWORD writer_flush(TPipeWriter *wr);
+
+// free writer buffer
+void writer_free(TPipeWriter *wr);
+
+
+// --- Buffered reader ---
+// Gathers small reads of nested variable records into larger pipe reads,
+// large reads are made directly to the destination buffer.
+typedef struct{
+    HANDLE file;
+    char *buf; /* read buffer */
+    DWORD block_size; /* buffer size */
+    DWORD pos; /* position of first unused byte in buffer */
+    DWORD used; /* bytes in buffer */
+    TTimer timer;
+    double timeout; /* total timeout */
+    bool sync; /* synchronous pipe (stdin), read by polling */
+    bool limited; /* pipe reads limited to 'remain' bytes */
+    DWORD remain; /* bytes left to read from pipe if limited */
+}TPipeReader;
+
+// init reader for pipe
+DWORD reader_init(TPipeReader *rd, HANDLE file, DWORD block_size, double timeout);
+
+// limit reads from pipe to 'limit' bytes, so the reader never takes data following the record
+void reader_set_limit(TPipeReader *rd, DWORD limit, bool sync);
+
+// read and drop the rest of limited data
+DWORD reader_skip(TPipeReader *rd);
+
+// read data (buffered)
+DWORD reader_read(TPipeReader *rd, void *data, DWORD size);
+
+// free reader buffer
+void reader_free(TPipeReader *rd);
+
+
+// --- Variable helpers (golpi_pipe_var.cpp) ---
+
+// identify variable type, returns VTYPE_ERROR if not supported and sets error message
+DWORD var_get_type(const octave_value &var, std::string &errstr);
+
+// get size of single element of variable type in bytes (0 for unknown type)
+DWORD var_element_size(DWORD var_type);
+
+// create new Octave variable of given type and size, returns pointer to its data storage (NULL for unknown type)
+void *var_create(DWORD var_type, DWORD m, DWORD n, octave_value &var);
+
+// get contiguous data storage of numeric or string variable (NULL for other types), 'hold' keeps the storage alive
+const void *var_get_data(const octave_value &var, DWORD var_type, std::shared_ptr<void> &hold);
+
+// read variable data of given type and size from pipe reader to new Octave variable
+DWORD var_read_data(TPipeReader *rd, DWORD var_type, DWORD m, DWORD n, octave_value &var, std::string &errstr);
+
+// write variable data to pipe writer
+DWORD var_write_data(TPipeWriter *wr, const octave_value &var, DWORD var_type);
+
+// read/write complete variable record (type, size and data), used for nested variables
+DWORD var_read_record(TPipeReader *rd, octave_value &var, std::string &errstr);
+DWORD var_write_record(TPipeWriter *wr, const octave_value &var);
+
+
+// --- Striped transfer over multiple pipes (golpi_pipe_stripe.cpp) ---
+// Data buffer is split to stripes of stripe_size bytes, stripe k goes via pipe k % pipes_count.
+// Each pipe is served by own thread, writes are sent in ACK blocks, reads are raw.
+
+// max pipes count
+#define STRIPE_MAX_PIPES 16
+
+// default stripe size in bytes
+#define STRIPE_SIZE_DEF 1048576
+
+// get bytes count going via pipe 'index'
+DWORD stripe_pipe_size(DWORD index, DWORD count, DWORD size, DWORD stripe_size);
+
+// write data striped over pipes
+DWORD stripe_write(HANDLE *pipes, DWORD count, const void *data, DWORD size, DWORD stripe_size, double timeout);
+
+// read data striped over pipes directly to destination buffer
+DWORD stripe_read(HANDLE *pipes, DWORD count, void *data, DWORD size, DWORD stripe_size, double timeout);
\ No newline at end of file
@@ -23,19 +23,6 @@
 #include "golpi_pipe.hpp"
 
 
-// send ACK or NACK message
-DWORD SendACK(HANDLE file, bool ack)
-{
-    char state = (ack)?'a':'n';
-    DWORD written;
-    WriteFile(file, &state, 1, &written, NULL);  
-    char res;    
-    ReadFileTimeout(file, &res, 1, NULL, 1.0);
-    if(DEBUG_PRN)
-        octave_stdout << "ack response " << (int)res << "\n";
-    return(written);    
-}
-
 // receive variable
 DEFUN_DLD(golpi_pipe_receive, args, nargout, "Transfer variable to Octave using named pipe")
 {
@@ -60,16 +47,7 @@ DEFUN_DLD(golpi_pipe_receive, args, nargout, "Transfer variable to Octave using
         error("GOLPI pipe interface: Second parameter must be double timeout value [s].");
         
     // try open pipe
-    HANDLE hPipe;
-    hPipe = CreateFileA(
-		    pipe_name.c_str(), 
-		    GENERIC_READ | GENERIC_WRITE, // access
-        0, // sharing
-        NULL, // security
-        OPEN_EXISTING, // create mode
-        FILE_FLAG_OVERLAPPED, // other
-        NULL // template
-        );         
+    HANDLE hPipe = OpenDataPipe(pipe_name);
   	if (hPipe == INVALID_HANDLE_VALUE)
         error("GOLPI pipe interface: Cannot access data pipe.");        
     
@@ -97,146 +75,24 @@ DEFUN_DLD(golpi_pipe_receive, args, nargout, "Transfer variable to Octave using
         CloseHandle(hPipe);
         error("GOLPI pipe interface: Timeout while transfering data size N.");
     }    
-    bool is_empty = !m && !n;
     
-    // get single element size
-    DWORD element_size;
-    switch(var_type)
-    {
-        case VTYPE_STRING: element_size = 1; break;
-        case VTYPE_INT32: element_size = sizeof(DWORD); break;
-        case VTYPE_UINT32: element_size = sizeof(DWORD); break;
-        case VTYPE_DBL: element_size = sizeof(double); break;
-        case VTYPE_CDBL: element_size = 2*sizeof(double); break;
-        case VTYPE_SGL: element_size = sizeof(float); break;
-        case VTYPE_CSGL: element_size = 2*sizeof(float); break;
-        default: element_size = 0;
-    }
-    if(!element_size)
-    {
-        // unknown type
-        SendACK(hPipe, false);
-        CloseHandle(hPipe);
-        error("GOLPI pipe interface: Unknown variable data type.");
-    }
-    DWORD data_size_bytes = m*n*element_size;
-   
-    
-   
-    if(var_type == VTYPE_STRING)
-    {
-        // 1D string
-        if(is_empty)
-        {
-            // empty string
-            res(0) = charMatrix("");
-        }
-        else
-        {    
-            // string
-            
-            // try read data
-            charMatrix str = charMatrix(m,n);
-            if(ReadFileTimeout(hPipe, (void*)str.fortran_vec(), data_size_bytes, &read, timeout))
-            {
-                SendACK(hPipe, false);
-                CloseHandle(hPipe);
-                error("GOLPI pipe interface: Timeout while transfering data.");
-            }
-            res(0) = str;
-        }
-        
-    }
-    else if(var_type == VTYPE_INT32)
-    {
-        // int32 matrix
-        
-        // try read data
-        int32NDArray array = int32NDArray({(int)m,(int)n});
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }
-    else if(var_type == VTYPE_UINT32)
-    {
-        // uint32 matrix
-        
-        // try read data
-        uint32NDArray array = uint32NDArray({(int)m,(int)n});
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }
-    else if(var_type == VTYPE_DBL)
-    {
-        // double matrix
-        
-        // try read data
-        Matrix array = Matrix(m,n);
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }
-    else if(var_type == VTYPE_SGL)
-    {
-        // single matrix
-        
-        // try read data
-        FloatMatrix array = FloatMatrix(m,n);
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }
-    else if(var_type == VTYPE_CDBL)
-    {
-        // complex double matrix
-        
-        // try read data
-        ComplexMatrix array = ComplexMatrix(m,n);
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }
-    else if(var_type == VTYPE_CSGL)
-    {
-        // complex single matrix
-        
-        // try read data
-        FloatComplexMatrix array = FloatComplexMatrix(m,n);
-        if(ReadFileTimeout(hPipe, (void*)array.fortran_vec(), data_size_bytes, &read, timeout))
-        {
-            SendACK(hPipe, false);
-            CloseHandle(hPipe);
-            error("GOLPI pipe interface: Timeout while transfering data.");
-        }
-        res(0) = array;
-    }        
+    // read variable data (buffered, so nested records of cells and structs are not read one by one)
+    octave_value var;
+    std::string errstr;
+    TPipeReader rd;
+    DWORD err = reader_init(&rd, hPipe, 0, timeout);
+    if(err)
+        errstr = "GOLPI pipe interface: Cannot allocate read buffer.";
     else
+        err = var_read_data(&rd, var_type, m, n, var, errstr);
+    reader_free(&rd);
+    if(err)
     {
         SendACK(hPipe, false);
         CloseHandle(hPipe);
-        error("GOLPI pipe interface: Unknown variable data type.");
+        error("%s", errstr.c_str());
     }
+    res(0) = var;
     
     // send ACK
     SendACK(hPipe, true);
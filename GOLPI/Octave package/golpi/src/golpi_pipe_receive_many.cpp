@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+// Script for transfering multiple variables to Octave environment via named
+// pipe in a single exchange.
+//
+// Data format to be send by caller:
+//   DWORD - variables count
+//   for each variable:
+//     DWORD - name length
+//     BYTES - name (no '\0' at the end)
+//     DWORD - variable_type_id
+//     DWORD - rows_count
+//     DWORD - columns_count
+//   for each variable:
+//     BYTES - variable data
+//
+// Usage:
+//   [vars] = golpi_pipe_receive_many(pipe_name)
+//   [vars] = golpi_pipe_receive_many(pipe_name, timeout)
+//
+// Parameters:
+//   pipe_name: Windows named pipe that has to be created by caller beforehand
+//              e.g. '\\.\Pipe\GOLPI_data_pipe'
+//   timeout: Total data read timeout value [s] (optional)
+//
+// Returns:
+//   vars: struct with received variables, field names are variable names
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <octave/utils.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+// max variable name length
+#define MAX_NAME_LEN 1024
+
+// max variables count
+#define MAX_VARS 65536
+
+
+// remaining time of total timeout [s]
+static double remain_timeout(TTimer *timer, double timeout)
+{
+    double remain = timeout - timer_get(timer);
+    return((remain > 0.0) ? remain : 0.0);
+}
+
+
+// receive variables
+DEFUN_DLD(golpi_pipe_receive_many, args, nargout, "Transfer multiple variables to Octave using named pipe")
+{
+    octave_value_list res;
+
+    // outputs
+    if(nargout != 1)
+        error("GOLPI pipe interface: One output argument expected - destination struct.");
+
+    // try get pipe name
+    if(args.length() < 1)
+        error("GOLPI pipe interface: At least name of the pipe must be passed.");
+    if(!args(0).is_string() || args(0).char_matrix_value().rows() != 1)
+        error("GOLPI pipe interface: First argument must be pipe name string.");
+    std::string pipe_name = args(0).char_matrix_value().row_as_string(0);
+
+    // try get timeout parameter
+    double timeout = 3.0;
+    if(args.length() >= 2 && args(1).array_value().numel() == 1)
+        timeout = args(1).array_value().elem(0);
+    else if(args.length() >= 2)
+        error("GOLPI pipe interface: Second parameter must be double timeout value [s].");
+
+    // try open pipe
+    HANDLE hPipe = OpenDataPipe(pipe_name);
+  	if (hPipe == INVALID_HANDLE_VALUE)
+        error("GOLPI pipe interface: Cannot access data pipe.");
+
+    // timeout is for whole exchange
+    TTimer timer;
+    timer_init(&timer);
+
+    // get variables count
+    DWORD count;
+    DWORD read;
+    if(ReadFileTimeout(hPipe, &count, sizeof(DWORD), &read, timeout))
+    {
+        SendACK(hPipe, false);
+        CloseHandle(hPipe);
+        error("GOLPI pipe interface: Timeout while transfering variables count.");
+    }
+    if(count > MAX_VARS)
+    {
+        SendACK(hPipe, false);
+        CloseHandle(hPipe);
+        error("GOLPI pipe interface: Too many variables.");
+    }
+
+    // get variables table
+    std::vector<std::string> names(count);
+    std::vector<DWORD> info(3*count);
+    for(DWORD k = 0; k < count; k++)
+    {
+        DWORD name_len;
+        if(ReadFileTimeout(hPipe, &name_len, sizeof(DWORD), &read, remain_timeout(&timer, timeout)))
+        {
+            SendACK(hPipe, false);
+            CloseHandle(hPipe);
+            error("GOLPI pipe interface: Timeout while transfering variables table.");
+        }
+        if(!name_len || name_len > MAX_NAME_LEN)
+        {
+            SendACK(hPipe, false);
+            CloseHandle(hPipe);
+            error("GOLPI pipe interface: Invalid variable name length.");
+        }
+        names[k].resize(name_len);
+        if(ReadFileTimeout(hPipe, (void*)&names[k][0], name_len, &read, remain_timeout(&timer, timeout)) ||
+           ReadFileTimeout(hPipe, (void*)&info[3*k], 3*sizeof(DWORD), &read, remain_timeout(&timer, timeout)))
+        {
+            SendACK(hPipe, false);
+            CloseHandle(hPipe);
+            error("GOLPI pipe interface: Timeout while transfering variables table.");
+        }
+        if(!octave::valid_identifier(names[k]))
+        {
+            SendACK(hPipe, false);
+            CloseHandle(hPipe);
+            error("GOLPI pipe interface: Invalid variable name '%s'.", names[k].c_str());
+        }
+    }
+
+    // read variables data
+    octave_scalar_map vars;
+    TPipeReader rd;
+    if(reader_init(&rd, hPipe, 0, remain_timeout(&timer, timeout)))
+    {
+        reader_free(&rd);
+        SendACK(hPipe, false);
+        CloseHandle(hPipe);
+        error("GOLPI pipe interface: Cannot allocate read buffer.");
+    }
+    for(DWORD k = 0; k < count; k++)
+    {
+        octave_value var;
+        std::string errstr;
+        if(var_read_data(&rd, info[3*k+0], info[3*k+1], info[3*k+2], var, errstr))
+        {
+            reader_free(&rd);
+            SendACK(hPipe, false);
+            CloseHandle(hPipe);
+            error("%s (variable '%s')", errstr.c_str(), names[k].c_str());
+        }
+        vars.assign(names[k], var);
+    }
+    reader_free(&rd);
+    res(0) = vars;
+
+    // send ACK
+    SendACK(hPipe, true);
+
+    // close pipe
+    CloseHandle(hPipe);
+
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+
+    // return stuff
+    return res;
+}
+
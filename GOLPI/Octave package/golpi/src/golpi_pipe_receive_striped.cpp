@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+// Script for transfering large variables to Octave environment via multiple
+// named pipe instances concurrently (striped transfer).
+//
+// Data format to be send by caller:
+//   pipe 0:
+//     DWORD - variable_type_id
+//     DWORD - rows_count
+//     DWORD - columns_count
+//     DWORD - pipes_count (must match count of pipe names)
+//     DWORD - stripe size in bytes
+//   pipe k (0 to pipes_count - 1):
+//     BYTES - stripes k, k + pipes_count, k + 2*pipes_count, ... of variable data
+// Caller waits for ACK on each pipe.
+// Only numeric, logical and string variables can be striped.
+//
+// Usage:
+//   [var_name] = golpi_pipe_receive_striped(pipe_names)
+//   [var_name] = golpi_pipe_receive_striped(pipe_names, timeout)
+//
+// Parameters:
+//   pipe_names: cell array of Windows named pipes that have to be created by
+//               caller beforehand e.g. {'\\.\Pipe\GOLPI_data_0', '\\.\Pipe\GOLPI_data_1'}
+//   timeout: Total data read timeout value [s] (optional)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+
+// send ACK or NACK and close all pipes
+static void close_pipes(HANDLE *pipes, DWORD count, bool ack)
+{
+    for(DWORD k = 0; k < count; k++)
+    {
+        SendACK(pipes[k], ack);
+        CloseHandle(pipes[k]);
+    }
+}
+
+// receive variable striped over multiple pipes
+DEFUN_DLD(golpi_pipe_receive_striped, args, nargout, "Transfer variable to Octave using multiple named pipes concurrently")
+{
+    octave_value_list res;
+    
+    // outputs
+    if(nargout != 1)
+        error("GOLPI pipe interface: One output argument expected - destination variable.");
+    
+    // try get pipe names
+    if(args.length() < 1)
+        error("GOLPI pipe interface: At least names of the pipes must be passed.");
+    if(args(0).class_name().compare("cell") != 0)
+        error("GOLPI pipe interface: First argument must be cell array of pipe names.");
+    Cell names = args(0).cell_value();
+    DWORD count = names.numel();
+    if(!count || count > STRIPE_MAX_PIPES)
+        error("GOLPI pipe interface: Pipes count must be 1 to %d.", STRIPE_MAX_PIPES);
+    for(DWORD k = 0; k < count; k++)
+        if(!names(k).is_string())
+            error("GOLPI pipe interface: Pipe names must be strings.");
+    
+    // try get timeout parameter
+    double timeout = 3.0;
+    if(args.length() >= 2 && args(1).array_value().numel() == 1)
+        timeout = args(1).array_value().elem(0);
+    else if(args.length() >= 2)
+        error("GOLPI pipe interface: Second parameter must be double timeout value [s].");
+    
+    // try open pipes
+    HANDLE pipes[STRIPE_MAX_PIPES];
+    for(DWORD k = 0; k < count; k++)
+    {
+        pipes[k] = OpenDataPipe(names(k).string_value());
+        if(pipes[k] == INVALID_HANDLE_VALUE)
+        {
+            for(DWORD i = 0; i < k; i++)
+                CloseHandle(pipes[i]);
+            error("GOLPI pipe interface: Cannot access data pipe '%s'.", names(k).string_value().c_str());
+        }
+    }
+    
+    // get header from first pipe
+    DWORD header[5];
+    DWORD read;
+    if(ReadFileTimeout(pipes[0], (void*)header, sizeof(header), &read, timeout))
+    {
+        close_pipes(pipes, count, false);
+        error("GOLPI pipe interface: Timeout while transfering variable header.");
+    }
+    DWORD var_type = header[0];
+    DWORD m = header[1];
+    DWORD n = header[2];
+    DWORD stripe_size = header[4];
+    if(header[3] != count)
+    {
+        close_pipes(pipes, count, false);
+        error("GOLPI pipe interface: Pipes count does not match.");
+    }
+    if(!stripe_size)
+    {
+        close_pipes(pipes, count, false);
+        error("GOLPI pipe interface: Invalid stripe size.");
+    }
+    
+    // allocate variable
+    DWORD element_size = var_element_size(var_type);
+    if(!element_size)
+    {
+        close_pipes(pipes, count, false);
+        error("GOLPI pipe interface: Unknown variable data type.");
+    }
+    octave_value var;
+    void *data = var_create(var_type, m, n, var);
+    
+    // read data via all pipes concurrently directly to the variable storage
+    DWORD size = m*n*element_size;
+    if(size && stripe_read(pipes, count, data, size, stripe_size, timeout))
+    {
+        close_pipes(pipes, count, false);
+        error("GOLPI pipe interface: Timeout while transfering data.");
+    }
+    res(0) = var;
+    
+    // send ACK to each pipe and close
+    close_pipes(pipes, count, true);
+    
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+    
+    // return stuff
+    return res;
+}
+
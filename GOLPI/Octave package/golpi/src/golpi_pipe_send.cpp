@@ -23,17 +23,6 @@
 #include "golpi_pipe.hpp"
 
 
-// send ACK or NACK message
-DWORD WaitACK(HANDLE file)
-{
-    char res;
-    if(ReadFileTimeout(file, &res, 1, NULL, 1.0))
-        return(0);
-    if(WriteFileTimeout(file, &res, 1, NULL, 0, 0.1))      
-        return(0);
-    return(1);    
-}
-
 // send variable 
 DEFUN_DLD(golpi_pipe_send, args, nargout, "Transfer variable from Octave using named pipe")
 {
@@ -61,65 +50,13 @@ DEFUN_DLD(golpi_pipe_send, args, nargout, "Transfer variable from Octave using n
     // identify data type
     auto var = args(1);
     std::string errstr;
-    DWORD var_type = VTYPE_ERROR;
-    if(var.class_name().compare("cell") == 0) /* note: workaround for old Octave 4.xx which has no iscell() method wtf??? */
-        errstr = "GOLPI pipe interface: Cell variables not supported.";
-    else if(var.ndims() > 2)
-        errstr = "GOLPI pipe interface: Variable must have max 2 dims.";
-    else if(!var.is_matrix_type() && !var.is_scalar_type() && !var.is_string())
-        errstr = "GOLPI pipe interface: Variable must be numeric type or string.";
-    else if(var.is_string())
-        var_type = VTYPE_STRING;    
-    else if(var.is_complex_matrix() || var.is_complex_scalar())
-    {
-        if(var.is_double_type())
-            var_type = VTYPE_CDBL;
-        else if(var.is_single_type())
-            var_type = VTYPE_CSGL;
-        else
-            errstr = "GOLPI pipe interface: complex variables must be single or double.";
-    }
-    else if(var.is_double_type())
-        var_type = VTYPE_DBL;
-    else if(var.is_single_type())
-        var_type = VTYPE_SGL;
-    else if(var.is_int32_type())
-        var_type = VTYPE_INT32;
-    else if(var.is_uint32_type())
-        var_type = VTYPE_UINT32;
-    else if(var.is_int16_type())
-        var_type = VTYPE_INT16;
-    else if(var.is_uint16_type())
-        var_type = VTYPE_UINT16;
-    else if(var.is_int8_type())
-        var_type = VTYPE_INT8;
-    else if(var.is_uint8_type())
-        var_type = VTYPE_UINT8;
-    else
-        errstr = "GOLPI pipe interface: unsupported variable type.";
+    DWORD var_type = var_get_type(var, errstr);
         
-    // data element size
-    DWORD element_size;
-    switch(var_type)
-    {
-        case VTYPE_STRING: element_size = 1; break;
-        case VTYPE_INT8: element_size = 1; break;
-        case VTYPE_UINT8: element_size = 1; break;
-        case VTYPE_INT16: element_size = sizeof(WORD); break;
-        case VTYPE_UINT16: element_size = sizeof(WORD); break;
-        case VTYPE_INT32: element_size = sizeof(DWORD); break;
-        case VTYPE_UINT32: element_size = sizeof(DWORD); break;
-        case VTYPE_DBL: element_size = sizeof(double); break;
-        case VTYPE_CDBL: element_size = 2*sizeof(double); break;
-        case VTYPE_SGL: element_size = sizeof(float); break;
-        case VTYPE_CSGL: element_size = 2*sizeof(float); break;
-        default: element_size = 0;
-    }
-    
     // get matrix size
     DWORD m = var.dims()(0);
     DWORD n = var.dims()(1);
-    bool is_empty = !m && !n;
+    // note: only plain matrices have no body when empty, cell, struct and sparse always have one (field names, column pointers)
+    bool is_empty = !m && !n && var_element_size(var_type);
     
     if(DEBUG_PRN)
         octave_stdout << "var type = " << var_type << ", dims count = " << (int)var.ndims() << ", m = " << m << ", n = " << n << "\n";
@@ -130,20 +67,8 @@ DEFUN_DLD(golpi_pipe_send, args, nargout, "Transfer variable from Octave using n
         n = 0;
     }
     
-    // total data size
-    DWORD data_size_bytes = m*n*element_size; 
-            
     // try open pipe
-    HANDLE hPipe;
-    hPipe = CreateFileA(
-		    pipe_name.c_str(), 
-		    GENERIC_READ | GENERIC_WRITE, // access
-        0, // sharing
-        NULL, // security
-        OPEN_EXISTING, // create mode
-        FILE_FLAG_OVERLAPPED, // other
-        NULL // template
-        );         
+    HANDLE hPipe = OpenDataPipe(pipe_name);
   	if (hPipe == INVALID_HANDLE_VALUE)
         error("GOLPI pipe interface: Cannot access data pipe.");
         
@@ -183,18 +108,18 @@ DEFUN_DLD(golpi_pipe_send, args, nargout, "Transfer variable from Octave using n
         // error
         WaitACK(hPipe);
         CloseHandle(hPipe);
-        error(errstr.c_str());
+        error("%s", errstr.c_str());
     }
     
     if(!is_empty)
     {    
-        DWORD err;
-        if(var_type == VTYPE_CDBL)
-            err = WriteFileTimeoutACK(hPipe, (void*)var.complex_matrix_value().fortran_vec(), data_size_bytes, &written, write_block, timeout);
-        else if(var_type == VTYPE_CSGL)
-            err = WriteFileTimeoutACK(hPipe, (void*)var.float_complex_matrix_value().fortran_vec(), data_size_bytes, &written, write_block, timeout);
-        else
-            err = WriteFileTimeoutACK(hPipe, (void*)var.mex_get_data(), data_size_bytes, &written, write_block, timeout);
+        TPipeWriter wr;
+        DWORD err = writer_init(&wr, hPipe, write_block, timeout);
+        if(!err)
+            err = var_write_data(&wr, var, var_type);
+        if(!err)
+            err = writer_flush(&wr);
+        writer_free(&wr);
         if(err)
         {
             // timeout - error
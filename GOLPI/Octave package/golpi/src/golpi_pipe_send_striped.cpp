@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+// Script for transfering large variables from Octave environment via multiple
+// named pipe instances concurrently (striped transfer).
+//
+// Data format send to caller:
+//   pipe 0:
+//     DWORD - variable_type_id (VTYPE_ERROR if variable cannot be sent)
+//     DWORD - rows_count
+//     DWORD - columns_count
+//     DWORD - pipes_count
+//     DWORD - stripe size in bytes
+//   pipe k (0 to pipes_count - 1):
+//     BYTES - stripes k, k + pipes_count, k + 2*pipes_count, ... of variable data
+// Data of each pipe are sent in ACK blocks, caller waits for ACK on each pipe.
+// Only numeric, logical and string variables can be striped.
+//
+// Usage:
+//   golpi_pipe_send_striped(pipe_names, variable)
+//   golpi_pipe_send_striped(pipe_names, variable, timeout)
+//   golpi_pipe_send_striped(pipe_names, variable, timeout, stripe_size)
+//
+// Parameters:
+//   pipe_names: cell array of Windows named pipes that have to be created by
+//               caller beforehand e.g. {'\\.\Pipe\GOLPI_data_0', '\\.\Pipe\GOLPI_data_1'}
+//   variable: variable to send
+//   timeout: Total data write timeout value [s] (optional)
+//   stripe_size: Stripe size in bytes (optional, default 1MB)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+
+// close all pipes
+static void close_pipes(HANDLE *pipes, DWORD count)
+{
+    for(DWORD k = 0; k < count; k++)
+        CloseHandle(pipes[k]);
+}
+
+// send variable striped over multiple pipes
+DEFUN_DLD(golpi_pipe_send_striped, args, nargout, "Transfer variable from Octave using multiple named pipes concurrently")
+{
+    octave_value_list res;
+    
+    // outputs
+    if(nargout != 0)
+        error("GOLPI pipe interface: No output arguments expected.");
+    
+    // try get pipe names
+    if(args.length() < 2)
+        error("GOLPI pipe interface: At least names of the pipes and variable to send must be passed.");
+    if(args(0).class_name().compare("cell") != 0)
+        error("GOLPI pipe interface: First argument must be cell array of pipe names.");
+    Cell names = args(0).cell_value();
+    DWORD count = names.numel();
+    if(!count || count > STRIPE_MAX_PIPES)
+        error("GOLPI pipe interface: Pipes count must be 1 to %d.", STRIPE_MAX_PIPES);
+    for(DWORD k = 0; k < count; k++)
+        if(!names(k).is_string())
+            error("GOLPI pipe interface: Pipe names must be strings.");
+    
+    // try get timeout parameter
+    double timeout = 3.0;
+    if(args.length() >= 3 && args(2).array_value().numel() == 1)
+        timeout = args(2).array_value().elem(0);
+    else if(args.length() >= 3)
+        error("GOLPI pipe interface: Third parameter must be double timeout value [s].");
+    
+    // try get stripe size parameter
+    DWORD stripe_size = STRIPE_SIZE_DEF;
+    if(args.length() >= 4 && args(3).array_value().numel() == 1 && args(3).array_value().elem(0) >= 1.0)
+        stripe_size = (DWORD)args(3).array_value().elem(0);
+    else if(args.length() >= 4)
+        error("GOLPI pipe interface: Fourth parameter must be stripe size in bytes.");
+    
+    // identify data type
+    auto var = args(1);
+    std::string errstr;
+    DWORD var_type = var_get_type(var, errstr);
+    if(var_type != VTYPE_ERROR && !var_element_size(var_type))
+    {
+        var_type = VTYPE_ERROR;
+        errstr = "GOLPI pipe interface: Only numeric, logical and string variables can be striped, use golpi_pipe_send().";
+    }
+    
+    // get matrix size
+    DWORD m = var.dims()(0);
+    DWORD n = var.dims()(1);
+    if(var_type == VTYPE_ERROR)
+    {
+        m = 0;
+        n = 0;
+    }
+    DWORD size = m*n*var_element_size(var_type);
+    
+    // get variable data storage
+    std::shared_ptr<void> hold;
+    const void *data = (size)?var_get_data(var, var_type, hold):NULL;
+    
+    // try open pipes
+    HANDLE pipes[STRIPE_MAX_PIPES];
+    for(DWORD k = 0; k < count; k++)
+    {
+        pipes[k] = OpenDataPipe(names(k).string_value());
+        if(pipes[k] == INVALID_HANDLE_VALUE)
+        {
+            close_pipes(pipes, k);
+            error("GOLPI pipe interface: Cannot access data pipe '%s'.", names(k).string_value().c_str());
+        }
+    }
+    
+    // sync with caller
+    for(DWORD k = 0; k < count; k++)
+    {
+        char sync;
+        ReadFileTimeout(pipes[k], &sync, 1, NULL, 1.0);
+    }
+    
+    // write header to first pipe
+    DWORD header[5] = {var_type, m, n, count, stripe_size};
+    DWORD written;
+    if(WriteFileTimeout(pipes[0], (void*)header, sizeof(header), &written, 0, timeout))
+    {
+        close_pipes(pipes, count);
+        error("GOLPI pipe interface: Cannot write variable header to pipe");
+    }
+    
+    if(var_type == VTYPE_ERROR)
+    {
+        // error
+        WaitACK(pipes[0]);
+        close_pipes(pipes, count);
+        error("%s", errstr.c_str());
+    }
+    
+    // write data via all pipes concurrently
+    if(size && stripe_write(pipes, count, data, size, stripe_size, timeout))
+    {
+        // timeout - error
+        close_pipes(pipes, count);
+        error("GOLPI pipe interface: Timeout while transfering variable data.");
+    }
+    
+    // wait for ACK of each pipe
+    for(DWORD k = 0; k < count; k++)
+        WaitACK(pipes[k]);
+    close_pipes(pipes, count);
+    
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+    return res;
+}
+
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+// Striped transfer of data buffer over multiple named pipe instances shared
+// by golpi_pipe_send_striped() and golpi_pipe_receive_striped().
+//
+// Data buffer is split to stripes of stripe_size bytes, stripe k is sent via
+// pipe k % pipes_count, so pipe k carries stripes k, k + pipes_count, ...
+// in this order. All pipes are served concurrently by worker threads.
+// Octave to caller direction uses ACK blocks per pipe (see TPipeWriter),
+// caller to Octave direction is raw data.
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+// worker thread state
+typedef struct{
+    HANDLE file;
+    char *data; /* whole data buffer */
+    DWORD size; /* whole data buffer size */
+    DWORD stripe_size;
+    DWORD index; /* pipe index */
+    DWORD count; /* pipes count */
+    double timeout; /* total timeout */
+    bool write; /* write or read */
+    DWORD err; /* result */
+}TStripeWorker;
+
+
+// get bytes count going via pipe 'index'
+DWORD stripe_pipe_size(DWORD index, DWORD count, DWORD size, DWORD stripe_size)
+{
+    DWORD total = 0;
+    for(unsigned long long offset = (unsigned long long)index*stripe_size; offset < size; offset += (unsigned long long)count*stripe_size)
+        total += min(stripe_size, size - (DWORD)offset);
+    return(total);
+}
+
+// worker thread: transfer all stripes of one pipe
+// note: no Octave API can be used here
+static DWORD WINAPI stripe_thread(LPVOID arg)
+{
+    TStripeWorker *wk = (TStripeWorker*)arg;
+    TTimer timer;
+    timer_init(&timer);
+    
+    TPipeWriter wr;
+    DWORD err = 0;
+    if(wk->write)
+    {
+        // write block size (must be smaller than pipe buffer size!)
+        DWORD out_buf_size,in_buf_size;
+        GetNamedPipeInfo(wk->file, NULL, &out_buf_size, &in_buf_size, NULL);
+        err = writer_init(&wr, wk->file, 0.9*in_buf_size, wk->timeout);
+    }
+    
+    for(unsigned long long offset = (unsigned long long)wk->index*wk->stripe_size; offset < wk->size && !err; offset += (unsigned long long)wk->count*wk->stripe_size)
+    {
+        DWORD chunk = min(wk->stripe_size, wk->size - (DWORD)offset);
+        if(wk->write)
+            err = writer_write(&wr, (void*)&wk->data[offset], chunk);
+        else
+        {
+            double timeout = wk->timeout - timer_get(&timer);
+            err = (timeout <= 0.0) || ReadFileTimeout(wk->file, (void*)&wk->data[offset], chunk, NULL, timeout);
+        }
+    }
+    
+    if(wk->write)
+    {
+        if(!err)
+            err = writer_flush(&wr);
+        writer_free(&wr);
+    }
+    
+    wk->err = err;
+    return(0);
+}
+
+// run worker for each pipe and wait for all of them
+static DWORD stripe_run(HANDLE *pipes, DWORD count, char *data, DWORD size, DWORD stripe_size, double timeout, bool write)
+{
+    if(!count || count > STRIPE_MAX_PIPES || !stripe_size)
+        return(1);
+    
+    TStripeWorker workers[STRIPE_MAX_PIPES];
+    HANDLE threads[STRIPE_MAX_PIPES];
+    DWORD started = 0;
+    DWORD err = 0;
+    for(DWORD k = 0; k < count; k++)
+    {
+        TStripeWorker *wk = &workers[k];
+        wk->file = pipes[k];
+        wk->data = data;
+        wk->size = size;
+        wk->stripe_size = stripe_size;
+        wk->index = k;
+        wk->count = count;
+        wk->timeout = timeout;
+        wk->write = write;
+        wk->err = 1;
+        threads[k] = CreateThread(NULL, 0, stripe_thread, (LPVOID)wk, 0, NULL);
+        if(!threads[k])
+        {
+            err = 1;
+            break;
+        }
+        started++;
+    }
+    
+    // wait for workers, each one has its own timeout
+    if(started)
+        WaitForMultipleObjects(started, threads, true, INFINITE);
+    for(DWORD k = 0; k < started; k++)
+    {
+        err |= workers[k].err;
+        CloseHandle(threads[k]);
+    }
+    
+    return(err);
+}
+
+// write data striped over pipes
+DWORD stripe_write(HANDLE *pipes, DWORD count, const void *data, DWORD size, DWORD stripe_size, double timeout)
+{
+    return(stripe_run(pipes, count, (char*)data, size, stripe_size, timeout, true));
+}
+
+// read data striped over pipes directly to destination buffer
+DWORD stripe_read(HANDLE *pipes, DWORD count, void *data, DWORD size, DWORD stripe_size, double timeout)
+{
+    return(stripe_run(pipes, count, (char*)data, size, stripe_size, timeout, false));
+}
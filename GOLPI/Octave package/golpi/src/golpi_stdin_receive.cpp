@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+// Script for transfering variables to Octave environment via its own stdin
+// pipe, for callers that cannot create named pipes. The function prints
+// FRAME_READY mark to stdout, then the caller sends single binary frame to
+// stdin. Nothing else may be sent to stdin before the mark, because Octave's
+// command reader could buffer it.
+//
+// Data format to be send by caller (see golpi_pipe.hpp):
+//   BYTES - FRAME_ID ("GpFr")
+//   DWORD - record size (bytes of the rest of frame)
+//   DWORD - variable_type_id
+//   DWORD - rows_count
+//   DWORD - columns_count
+//   BYTES - variable data
+// Record is read only up to its size, so the stdin stays in sync with the
+// following commands even if the record is invalid.
+//
+// Usage:
+//   [var_name] = golpi_stdin_receive()
+//   [var_name] = golpi_stdin_receive(timeout)
+//
+// Parameters:
+//   timeout: Total data read timeout value [s] (optional)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include <iostream>
+#include "golpi_pipe.hpp"
+
+
+// receive variable
+DEFUN_DLD(golpi_stdin_receive, args, nargout, "Transfer variable to Octave using binary frame via stdin")
+{
+    octave_value_list res;
+
+    // outputs
+    if(nargout != 1)
+        error("GOLPI pipe interface: One output argument expected - destination variable.");
+
+    // try get timeout parameter
+    double timeout = 3.0;
+    if(args.length() >= 1 && args(0).array_value().numel() == 1)
+        timeout = args(0).array_value().elem(0);
+    else if(args.length() >= 1)
+        error("GOLPI pipe interface: First parameter must be double timeout value [s].");
+
+    HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
+    if(hStdin == INVALID_HANDLE_VALUE || !hStdin)
+        error("GOLPI pipe interface: Cannot access stdin.");
+
+    // tell caller we are waiting for frame
+    octave_stdout << FRAME_READY;
+    octave_stdout.flush();
+    std::cout.flush();
+
+    // get frame header
+    char head[FRAME_HEAD_SIZE];
+    DWORD read;
+    if(ReadPipeSyncTimeout(hStdin, (void*)head, FRAME_HEAD_SIZE, &read, timeout, false))
+        error("GOLPI pipe interface: Timeout while transfering frame header.");
+    if(memcmp((void*)head, (void*)FRAME_ID, FRAME_ID_LEN))
+        error("GOLPI pipe interface: Invalid frame header, stdin is out of sync.");
+    DWORD size;
+    memcpy((void*)&size, (void*)&head[FRAME_ID_LEN], sizeof(DWORD));
+
+    // read variable record, but not a byte past the frame
+    octave_value var;
+    std::string errstr;
+    TPipeReader rd;
+    DWORD err = reader_init(&rd, hStdin, 0, timeout);
+    if(err)
+        errstr = "GOLPI pipe interface: Cannot allocate read buffer.";
+    else
+    {
+        reader_set_limit(&rd, size, true);
+        err = var_read_record(&rd, var, errstr);
+        if(!err && (rd.remain || rd.pos != rd.used))
+        {
+            errstr = "GOLPI pipe interface: Frame size does not match variable size.";
+            err = 1;
+        }
+        if(err)
+            reader_skip(&rd);
+    }
+    reader_free(&rd);
+    if(err)
+        error("%s", errstr.c_str());
+    res(0) = var;
+
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+
+    // return stuff
+    return res;
+}
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+// Script for transfering multiple variables from Octave environment via named
+// pipe in a single exchange. Internal function, use golpi_pipe_send_many().
+//
+// Data format send to caller:
+//   DWORD - variables count
+//   for each variable:
+//     DWORD - name length
+//     BYTES - name (no '\0' at the end)
+//     DWORD - variable_type_id (VTYPE_ERROR if variable cannot be sent)
+//     DWORD - rows_count
+//     DWORD - columns_count
+//   for each variable:
+//     BYTES - variable data
+// Variables data are sent in ACK blocks as single continuous stream.
+//
+// Usage:
+//   __golpi_pipe_send_many__(pipe_name, names, values, timeout)
+//
+// Parameters:
+//   pipe_name: Windows named pipe that has to be created by caller beforehand
+//              e.g. '\\.\Pipe\GOLPI_data_pipe'
+//   names: cell array of variable names
+//   values: cell array of variable values
+//   timeout: Total data write timeout value [s]
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+
+// send variables
+DEFUN_DLD(__golpi_pipe_send_many__, args, nargout, "Transfer multiple variables from Octave using named pipe")
+{
+    octave_value_list res;
+
+    // outputs
+    if(nargout != 0)
+        error("GOLPI pipe interface: No output arguments expected.");
+
+    // try get pipe name
+    if(args.length() != 4)
+        error("GOLPI pipe interface: Pipe name, variable names, variable values and timeout expected.");
+    if(!args(0).is_string() || args(0).char_matrix_value().rows() != 1)
+        error("GOLPI pipe interface: First argument must be pipe name string.");
+    std::string pipe_name = args(0).char_matrix_value().row_as_string(0);
+
+    // get variables
+    if(args(1).class_name().compare("cell") != 0 || args(2).class_name().compare("cell") != 0)
+        error("GOLPI pipe interface: Variable names and values must be cell arrays.");
+    Cell names = args(1).cell_value();
+    Cell values = args(2).cell_value();
+    if(names.numel() != values.numel())
+        error("GOLPI pipe interface: Variable names and values count does not match.");
+    DWORD count = names.numel();
+    for(DWORD k = 0; k < count; k++)
+        if(!names(k).is_string())
+            error("GOLPI pipe interface: Variable names must be strings.");
+
+    // get timeout parameter
+    double timeout = 3.0;
+    if(args(3).array_value().numel() == 1)
+        timeout = args(3).array_value().elem(0);
+    else
+        error("GOLPI pipe interface: Fourth parameter must be double timeout value [s].");
+
+    // build variables table
+    std::string table;
+    std::string errstr;
+    std::vector<DWORD> types(count);
+    table.append((char*)&count, sizeof(DWORD));
+    for(DWORD k = 0; k < count; k++)
+    {
+        std::string name = names(k).string_value();
+        std::string var_err;
+        DWORD var_type = var_get_type(values(k), var_err);
+        DWORD m = values(k).dims()(0);
+        DWORD n = values(k).dims()(1);
+        if(var_type == VTYPE_ERROR)
+        {
+            // this one will be sent empty
+            m = 0;
+            n = 0;
+            if(errstr.empty())
+                errstr = var_err + " (variable '" + name + "')";
+        }
+        types[k] = var_type;
+
+        DWORD name_len = name.size();
+        table.append((char*)&name_len, sizeof(DWORD));
+        table.append(name);
+        table.append((char*)&var_type, sizeof(DWORD));
+        table.append((char*)&m, sizeof(DWORD));
+        table.append((char*)&n, sizeof(DWORD));
+    }
+
+    // try open pipe
+    HANDLE hPipe = OpenDataPipe(pipe_name);
+  	if (hPipe == INVALID_HANDLE_VALUE)
+        error("GOLPI pipe interface: Cannot access data pipe.");
+
+    // get pipe buffer sizes
+    DWORD out_buf_size,in_buf_size;
+    GetNamedPipeInfo(hPipe, NULL, &out_buf_size, &in_buf_size, NULL);
+
+    // default write block size (must be smaller than buffer size!)
+    DWORD write_block = 0.9*in_buf_size;
+
+    // sync with caller
+    char sync;
+    ReadFileTimeout(hPipe, &sync, 1, NULL, 1.0);
+
+    // send variables table even when error occured
+    DWORD written;
+    if(WriteFileTimeout(hPipe, (void*)table.data(), table.size(), &written, write_block, timeout))
+    {
+        CloseHandle(hPipe);
+        error("GOLPI pipe interface: Cannot write variables table to pipe");
+    }
+
+    // send all variables data as one stream
+    TPipeWriter wr;
+    DWORD err = writer_init(&wr, hPipe, write_block, timeout);
+    for(DWORD k = 0; k < count && !err; k++)
+        if(types[k] != VTYPE_ERROR)
+            err = var_write_data(&wr, values(k), types[k]);
+    if(!err)
+        err = writer_flush(&wr);
+    writer_free(&wr);
+    if(err)
+    {
+        // timeout - error
+        CloseHandle(hPipe);
+        error("GOLPI pipe interface: Timeout while transfering variables data.");
+    }
+
+    // wait for ACK
+    WaitACK(hPipe);
+    CloseHandle(hPipe);
+
+    if(!errstr.empty())
+        error("%s", errstr.c_str());
+
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+    return res;
+}
+
@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+// Script for chunked streaming of variable to Octave environment via named
+// pipe. Destination variable is preallocated on open, data are appended as
+// they arrive, so the caller can process the record block by block while
+// the rest is still being transferred. Internal function, use golpi_stream_open(),
+// golpi_stream_read() and golpi_stream_close().
+//
+// Data format to be send by caller:
+//   BYTES - variable data (type and size is defined by golpi_stream_open())
+// Caller sends data in any chunks and waits for ACK after the last one.
+//
+// Usage:
+//   [handle] = __golpi_stream__('open', pipe_name, variable_type_id, m, n)
+//   [count, block] = __golpi_stream__('read', handle, timeout)
+//   [var] = __golpi_stream__('close', handle, timeout)
+//
+// Parameters:
+//   pipe_name: Windows named pipe that has to be created by caller beforehand
+//              e.g. '\\.\Pipe\GOLPI_data_pipe'
+//   variable_type_id: VTYPE_xxx id of the streamed variable
+//   m, n: dimensions of the streamed variable
+//   handle: stream handle returned by 'open'
+//   timeout: 'read' - max time to wait for first new data [s] (0 to poll),
+//            'close' - total timeout for the rest of data [s]
+//
+// Returns:
+//   count: total count of elements received so far
+//   block: column vector of elements received by this call
+//   var: complete variable
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include <map>
+#include <stdint.h>
+#include "golpi_pipe.hpp"
+
+// --- Stream state ---
+typedef struct{
+    HANDLE file;
+    DWORD var_type;
+    DWORD element_size;
+    octave_value var; /* destination variable (owned only by the stream until closed) */
+    char *data; /* destination variable data storage */
+    DWORD size; /* total data size in bytes */
+    DWORD filled; /* received data size in bytes */
+}TStream;
+
+// open streams
+static std::map<int, TStream*> streams;
+static int streams_last_id = 0;
+
+
+// get stream by handle argument
+static TStream *stream_get(const octave_value &arg, int &id)
+{
+    if(arg.array_value().numel() != 1)
+        error("GOLPI pipe interface: Stream handle expected.");
+    id = (int)arg.array_value().elem(0);
+    std::map<int, TStream*>::iterator it = streams.find(id);
+    if(it == streams.end())
+        error("GOLPI pipe interface: Invalid stream handle.");
+    return(it->second);
+}
+
+// close stream and free its state
+static void stream_free(int id, bool ack)
+{
+    TStream *str = streams[id];
+    SendACK(str->file, ack);
+    CloseHandle(str->file);
+    delete str;
+    streams.erase(id);
+
+    // allow unloading of oct-file when last stream is closed
+    if(streams.empty())
+        munlock();
+}
+
+// get timeout argument
+static double get_timeout(const octave_value_list &args, int index, double timeout)
+{
+    if(args.length() > index)
+    {
+        if(args(index).array_value().numel() != 1)
+            error("GOLPI pipe interface: Timeout must be double value [s].");
+        timeout = args(index).array_value().elem(0);
+    }
+    return(timeout);
+}
+
+
+// stream variable
+DEFUN_DLD(__golpi_stream__, args, nargout, "Stream variable to Octave using named pipe")
+{
+    octave_value_list res;
+
+    // get command
+    if(args.length() < 2 || !args(0).is_string())
+        error("GOLPI pipe interface: Stream command and its parameters expected.");
+    std::string cmd = args(0).string_value();
+
+    if(cmd.compare("open") == 0)
+    {
+        // --- open stream ---
+        if(args.length() != 5)
+            error("GOLPI pipe interface: Pipe name, variable type and dimensions expected.");
+        if(!args(1).is_string() || args(1).char_matrix_value().rows() != 1)
+            error("GOLPI pipe interface: Pipe name must be string.");
+        std::string pipe_name = args(1).char_matrix_value().row_as_string(0);
+        if(!args(2).is_real_scalar() || !args(3).is_real_scalar() || !args(4).is_real_scalar())
+            error("GOLPI pipe interface: Variable type and dimensions must be real scalars.");
+        DWORD var_type = (DWORD)args(2).double_value();
+        DWORD m = (DWORD)args(3).double_value();
+        DWORD n = (DWORD)args(4).double_value();
+        DWORD element_size = var_element_size(var_type);
+        if(!element_size)
+            error("GOLPI pipe interface: Unknown variable data type.");
+
+        // size of stream must fit to DWORD
+        if((uint64_t)m*n > 0xFFFFFFFFull/element_size)
+            error("GOLPI pipe interface: Stream size exceeds 4 GB.");
+        DWORD size = m*n*element_size;
+
+        // preallocate destination variable (before stream state, so nothing leaks if it fails)
+        octave_value var;
+        char *data = (char*)var_create(var_type, m, n, var);
+        TStream *str = new TStream;
+        str->var_type = var_type;
+        str->element_size = element_size;
+        str->var = var;
+        str->data = data;
+        str->size = size;
+        str->filled = 0;
+
+        // try open pipe
+        str->file = OpenDataPipe(pipe_name);
+        if(str->file == INVALID_HANDLE_VALUE)
+        {
+            delete str;
+            error("GOLPI pipe interface: Cannot access data pipe.");
+        }
+
+        // keep oct-file loaded while streams are open
+        if(streams.empty())
+            mlock();
+
+        // register stream
+        streams[++streams_last_id] = str;
+        res(0) = octave_value(streams_last_id);
+    }
+    else if(cmd.compare("read") == 0)
+    {
+        // --- read available data ---
+        int id;
+        TStream *str = stream_get(args(1), id);
+        double timeout = get_timeout(args, 2, 0.0);
+
+        DWORD count_prev = str->filled/str->element_size;
+        DWORD read = 0;
+        if(str->filled < str->size && ReadFileTimeoutSome(str->file, (void*)&str->data[str->filled], str->size - str->filled, &read, timeout))
+        {
+            stream_free(id, false);
+            error("GOLPI pipe interface: Stream pipe failed.");
+        }
+        str->filled += read;
+
+        // get new complete elements
+        DWORD count = str->filled/str->element_size;
+        res(0) = octave_value((double)count);
+        if(nargout > 1)
+        {
+            octave_value block;
+            char *data = (char*)var_create(str->var_type, count - count_prev, 1, block);
+            if(count > count_prev)
+                memcpy((void*)data, (void*)&str->data[count_prev*str->element_size], (count - count_prev)*str->element_size);
+            res(1) = block;
+        }
+    }
+    else if(cmd.compare("close") == 0)
+    {
+        // --- read rest of data and close stream ---
+        int id;
+        TStream *str = stream_get(args(1), id);
+        double timeout = get_timeout(args, 2, 3.0);
+
+        if(str->filled < str->size && ReadFileTimeout(str->file, (void*)&str->data[str->filled], str->size - str->filled, NULL, timeout))
+        {
+            stream_free(id, false);
+            error("GOLPI pipe interface: Timeout while transfering stream data.");
+        }
+        res(0) = str->var;
+        stream_free(id, true);
+
+        // console sync mark
+        octave_stdout << "GOLPImark\n";
+    }
+    else
+        error("GOLPI pipe interface: Unknown stream command '%s'.", cmd.c_str());
+
+    return res;
+}
+
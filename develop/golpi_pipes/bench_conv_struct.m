@@ -0,0 +1,52 @@
+% Benchmark of native golpi_conv_struct against reference m-file implementation.
+% Build oct-files by make.m first.
+clear all;
+close all;
+clc;
+
+% test variables
+s1 = struct('a', 5, 'b', 'test');
+s2 = struct('i', int32([1 2;3 4]), 'f', single(randn(3,2)), 'c', complex(randn(1,4),randn(1,4)), 'cs', complex(single(1),single(-2)));
+s2.sub = s1;
+s2.arr = struct('x', {1, 'two', [3 4 5]});
+s2.cell = {1, 'str', s1; [], {s1, 'x'}, int32(7)};
+s2.skip = uint8(1:3);
+s2.nd = randn(2,2,2);
+s2.mat = ['ab';'cd'];
+s2.empty = [];
+s2.estr = '';
+tests = {s1, s2, 'Hello GOLPI!', ['ab';'cd'], '', 5, {}, struct()};
+
+% compare outputs
+for k = 1:numel(tests)
+  ref = golpi_conv_struct_ref(tests{k});
+  out = golpi_conv_struct(tests{k});
+  if ~isequal(ref, out)
+    error('Output of test %d does not match reference!', k);
+  endif
+endfor
+printf('All %d outputs match reference.\n', numel(tests));
+
+% structure array at top level is sent as single unnamed array item, i.e.
+% the same as structure item holding the array, just without the name
+sa = struct('x', {1, 'two', [3 4 5]});
+sn.a = sa;
+ref = golpi_conv_struct_ref(sn);
+ref = [ref(1:4); typecast(typecast(ref(5:8),'uint32') - 1,'uint8')(:); uint8(0); ref(11:end)];
+if ~isequal(ref, golpi_conv_struct(sa))
+  error('Output of structure array does not match reference!');
+endif
+
+% speed test: nested structs with N items
+N = [1e2 1e3 1e4];
+for k = 1:numel(N)
+  items = struct('name', 'item', 'value', num2cell(randn(1, N(k))), 'data', single(1:10));
+  [items.sub] = deal(struct('id', int32(1), 'tag', 'x'));
+  s = struct('items', items, 'list', {num2cell(1:N(k))});
+  tic; ref = golpi_conv_struct_ref(s); t_ref = toc;
+  tic; out = golpi_conv_struct(s); t_nat = toc;
+  if ~isequal(ref, out)
+    error('Output for N = %d does not match reference!', N(k));
+  endif
+  printf('N = %6d: m-file %8.3f s, oct-file %8.3f s, speedup %6.1fx\n', N(k), t_ref, t_nat, t_ref/t_nat);
+endfor
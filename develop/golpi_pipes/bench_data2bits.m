@@ -0,0 +1,44 @@
+% Benchmark of native golpi_data2bits against reference m-file implementation.
+% Build oct-files by make.m first.
+clear all;
+close all;
+clc;
+
+% test variables: {data, ExpDataType, Dim}
+tests = {{[1:5], 6, 1},
+         {randn(1,1001), 3, 1},
+         {single(randn(7,13)), 3, 2},
+         {complex(randn(1,333),randn(1,333)), 4, 1},
+         {int16(randi([-1000 1000],1,77)), 1, 1},
+         {uint32(randi([0 1e6],5,5)), 6, 2},
+         {'Hello GOLPI!', 5, 1},
+         {zeros(0,1), 3, 1},
+         {randn(2,3,4), 3, 3},
+         {randn(3,3), 3, 1}};
+
+% compare outputs
+for k = 1:numel(tests)
+  t = tests{k};
+  ref = evalc('golpi_data2bits_ref(t{1}, t{2}, t{3})');
+  out = evalc('golpi_data2bits(t{1}, t{2}, t{3})');
+  if ~strcmp(ref, out)
+    error('Output of test %d does not match reference!', k);
+  endif
+endfor
+printf('All %d outputs match reference.\n', numel(tests));
+
+% speed test
+N = [1e4 1e5 1e6 1e7];
+for k = 1:numel(N)
+  x = randn(1, N(k));
+  tic; evalc('golpi_data2bits_ref(x, 3, 1)'); t_ref = toc;
+  tic; evalc('golpi_data2bits(x, 3, 1)'); t_nat = toc;
+  printf('N = %8d: m-file %8.3f s, oct-file %8.3f s, speedup %6.1fx\n', N(k), t_ref, t_nat, t_ref/t_nat);
+endfor
+
+% 7-bit vs 8-bit coding size and speed
+x = randn(1, 1e6);
+tic; s7 = evalc('golpi_data2bits(x, 3, 1, 0)'); t7 = toc;
+tic; s8 = evalc('golpi_data2bits(x, 3, 1, 1)'); t8 = toc;
+printf('7-bit coding: %8.3f s, overhead %5.1f %%\n', t7, 100*(numel(s7)/(8*numel(x)) - 1));
+printf('8-bit coding: %8.3f s, overhead %5.1f %%\n', t8, 100*(numel(s8)/(8*numel(x)) - 1));
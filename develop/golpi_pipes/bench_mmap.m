@@ -0,0 +1,48 @@
+% Benchmark of golpi_mmap_save/golpi_mmap_load against generic save -v4/load.
+% Build oct-files by make.m first.
+clear all;
+close all;
+clc;
+
+file = [tempdir() 'golpi_mmap_bench.mat'];
+
+% test variables
+s.x = randn(3,4);
+s.z = complex(randn(2,5), randn(2,5));
+s.t = ['ab';'cd'];
+s.b = logical([1 0 1]);
+s.i = int32([1 -2 3]);
+s.e = [];
+
+% compare round trip with generic save/load
+golpi_mmap_save(file, s);
+ref = load(file);
+out = golpi_mmap_load(file);
+fn = fieldnames(s);
+for k = 1:numel(fn)
+  if ~isequal(double(ref.(fn{k})), double(out.(fn{k}))) || ~isequal(ischar(ref.(fn{k})), ischar(out.(fn{k})))
+    error('Variable ''%s'' does not match generic load!', fn{k});
+  endif
+endfor
+x = s.x; z = s.z;
+save('-v4', file, 'x', 'z');
+if ~isequal(golpi_mmap_load(file, 'x'), x) || ~isequal(golpi_mmap_load(file, 'z'), z)
+  error('Loaded variables do not match generic save!');
+endif
+printf('All variables match generic save/load.\n');
+
+% speed test: N MB of real data
+N = [1 10 100];
+for k = 1:numel(N)
+  x = randn(N(k)*2^20/8, 1);
+  tic; save('-v4', file, 'x'); t_save = toc;
+  tic; ref = load(file); t_load = toc;
+  tic; golpi_mmap_save(file, 'x', x); t_msave = toc;
+  tic; out = golpi_mmap_load(file, 'x'); t_mload = toc;
+  if ~isequal(ref.x, out)
+    error('Output for N = %d MB does not match generic load!', N(k));
+  endif
+  printf('%4d MB: save %7.3f s, mmap save %7.3f s, load %7.3f s, mmap load %7.3f s\n', N(k), t_save, t_msave, t_load, t_mload);
+endfor
+
+delete(file);
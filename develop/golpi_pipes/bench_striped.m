@@ -0,0 +1,33 @@
+% Scaling benchmark of striped multi-pipe transfer for K = 1..8 pipes.
+% Build oct-files by make.m first.
+clear all;
+close all;
+clc;
+
+% transferred data size [B]
+size_bytes = 256e6;
+% stripe size [B]
+stripe_size = 1048576;
+% pipe counts to test
+K = 1:8;
+% repetitions per pipes count (best one is taken)
+R = 3;
+
+send_rate = zeros(size(K));
+receive_rate = zeros(size(K));
+for k = 1:numel(K)
+  for r = 1:R
+    [s,q] = golpi_stripe_bench(K(k), size_bytes, stripe_size);
+    send_rate(k) = max(send_rate(k), s);
+    receive_rate(k) = max(receive_rate(k), q);
+  endfor
+  printf('K = %d: send %7.1f MB/s, receive %7.1f MB/s\n', K(k), send_rate(k), receive_rate(k));
+endfor
+
+figure;
+plot(K, send_rate, 'o-', K, receive_rate, 's-');
+grid on;
+xlabel('pipes count K [-]');
+ylabel('transfer rate [MB/s]');
+legend('Octave to peer (send)', 'peer to Octave (receive)', 'location', 'northwest');
+title(sprintf('Striped transfer, %.0f MB, stripe %d kB', size_bytes/1e6, stripe_size/1024));
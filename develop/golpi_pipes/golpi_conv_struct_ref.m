@@ -13,7 +13,7 @@
 ##
 
 ## -*- texinfo -*-
-## @deftypefn {Function file} @var{BIN} = golpi_conv_struct (@var{Data} )
+## @deftypefn {Function file} @var{BIN} = golpi_conv_struct_ref (@var{Data} )
 ## Function codes structure content into binary stream @var{BIN} of 'uint8'.
 ## This is useful for simple transfer of structures to LabVIEW via GOLPI 
 ## (Gnu Octave to Labview Pipes Interface). It is recursive function
@@ -58,14 +58,16 @@
 ## Example:
 ## @example
 ## s.a=5; s.b = "test";
-## golpi_conv_struct(s)
+## golpi_conv_struct_ref(s)
 ## @end example
 ## @end deftypefn
 
 
 ## @end deftypefn
 
-function [bin] = golpi_conv_struct(data)  
+% Reference m-file implementation of golpi_conv_struct (now native oct-file),
+% kept for benchmarking and output comparison by bench_conv_struct.m.
+function [bin] = golpi_conv_struct_ref(data)  
   
   % initialize compressed data output variable
   bin = [typecast(uint32(0),'uint8')(:)];
@@ -199,7 +201,7 @@ function [bin] = golpi_conv_struct(data)
           cell_offsets(c) = numel(sub) - cell_00;          
 
           % convert item data
-          idata = golpi_conv_struct(cdata{c});
+          idata = golpi_conv_struct_ref(cdata{c});
           
           % append it to the 
           sub = [sub;idata];
@@ -0,0 +1,356 @@
+//------------------------------------------------------------------------------
+// Native encoder of variable content into series of 7 bit characters streamed
+// to stdout (GOLPI Bitstream transfer mode). Replaces golpi_data2bits.m with
+// the same header and the same wire format.
+//
+// Stream format:
+//   _GpBiT_(SS)(T)(NNNNNNNN)(SSSSSSS1)(SSSSSSS2)...
+//   data bytes: elements in big endian, coded by one of:
+//     7-bit coding (default): data padded by zeros to multiple of 7 bytes,
+//       each 7 bytes (56 bits, first byte lowest) are split to 8 chunks of 7 bits
+//       (lowest first), each chunk is sent as character chunk + '0'
+//     8-bit coding (bit 3 of type nibble (T) set): each byte is sent as
+//       character (byte + 42) mod 256, characters 0x00, 0x0A ('\n'), 0x0D ('\r'),
+//       0x1B (ESC, frame and request markers) and 0x3D ('=') are escaped as '='
+//       followed by (character + 64) mod 256
+//   '\n'
+//
+// Usage:
+//   golpi_data2bits(Data, ExpDataType, Dim)
+//   golpi_data2bits(Data, ExpDataType, Dim, Coding)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include <stdint.h>
+#if defined(__GNUC__) && defined(__x86_64__)
+  #include <immintrin.h>
+#endif
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+#include "golpi_pipe.hpp"
+
+// stage size (multiple of 7 and of all element sizes 1, 2, 4, 8, 16)
+#define STAGE_SIZE (7*16*4096)
+
+// 7-bit packing of 7 bytes (little endian 56bit word) to 8 characters with '0' offset
+static inline uint64_t pack7(uint64_t x)
+{
+    return(((x & 0x7Full) | ((x << 1) & 0x7F00ull) | ((x << 2) & 0x7F0000ull) | ((x << 3) & 0x7F000000ull) |
+           ((x << 4) & 0x7F00000000ull) | ((x << 5) & 0x7F0000000000ull) | ((x << 6) & 0x7F000000000000ull) |
+           ((x << 7) & 0x7F00000000000000ull)) + 0x3030303030303030ull);
+}
+
+// pack groups of 7 bytes to 8 characters (portable SWAR)
+// note: source must have 1 readable byte after last group
+static void pack_swar(const unsigned char *src, char *dst, size_t groups)
+{
+    for(size_t k = 0; k < groups; k++)
+    {
+        uint64_t x;
+        memcpy((void*)&x, (void*)src, 8);
+        x = pack7(x);
+        memcpy((void*)dst, (void*)&x, 8);
+        src += 7;
+        dst += 8;
+    }
+}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+// pack groups of 7 bytes to 8 characters (BMI2 parallel bit deposit)
+__attribute__((target("bmi2")))
+static void pack_bmi2(const unsigned char *src, char *dst, size_t groups)
+{
+    for(size_t k = 0; k < groups; k++)
+    {
+        uint64_t x;
+        memcpy((void*)&x, (void*)src, 8);
+        x = _pdep_u64(x, 0x7F7F7F7F7F7F7F7Full) + 0x3030303030303030ull;
+        memcpy((void*)dst, (void*)&x, 8);
+        src += 7;
+        dst += 8;
+    }
+}
+#endif
+
+// 8-bit coding parameters
+#define ESC_OFFSET 42 /* offset added to each byte */
+#define ESC_CHAR '=' /* escape character */
+#define ESC_SHIFT 64 /* offset added to escaped character */
+#define ESC_FLAG 0x100 /* escaped character flag in coding table */
+
+// 8-bit coding: fill table of coded characters for each byte, escaped ones are marked by ESC_FLAG
+static void escape_table(unsigned short *table)
+{
+    for(int k = 0; k < 256; k++)
+    {
+        unsigned char c = (unsigned char)(k + ESC_OFFSET);
+        if(c == 0x00 || c == '\n' || c == '\r' || c == 0x1B || c == ESC_CHAR)
+            table[k] = ESC_FLAG | (unsigned char)(c + ESC_SHIFT);
+        else
+            table[k] = c;
+    }
+}
+
+// 8-bit coding of bytes, returns coded size (max. 2*len)
+static size_t escape_bytes(const unsigned short *table, const unsigned char *src, char *dst, size_t len)
+{
+    char *p = dst;
+    size_t k = 0;
+#if defined(__SSE2__)
+    // blocks of 16 bytes without critical characters are coded at once
+    const __m128i offset = _mm_set1_epi8(ESC_OFFSET);
+    const __m128i c_nul = _mm_set1_epi8(0x00);
+    const __m128i c_lf = _mm_set1_epi8('\n');
+    const __m128i c_cr = _mm_set1_epi8('\r');
+    const __m128i c_mark = _mm_set1_epi8(0x1B);
+    const __m128i c_esc = _mm_set1_epi8(ESC_CHAR);
+    for(; k + 16 <= len; k += 16)
+    {
+        __m128i v = _mm_add_epi8(_mm_loadu_si128((const __m128i*)&src[k]), offset);
+        __m128i crit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, c_nul), _mm_cmpeq_epi8(v, c_lf)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(v, c_cr), _mm_cmpeq_epi8(v, c_esc)));
+        crit = _mm_or_si128(crit, _mm_cmpeq_epi8(v, c_mark));
+        if(!_mm_movemask_epi8(crit))
+        {
+            _mm_storeu_si128((__m128i*)p, v);
+            p += 16;
+            continue;
+        }
+        for(int i = 0; i < 16; i++)
+        {
+            unsigned short c = table[src[k + i]];
+            if(c & ESC_FLAG)
+                *p++ = ESC_CHAR;
+            *p++ = (char)c;
+        }
+    }
+#endif
+    for(; k < len; k++)
+    {
+        unsigned short c = table[src[k]];
+        if(c & ESC_FLAG)
+            *p++ = ESC_CHAR;
+        *p++ = (char)c;
+    }
+    return(p - dst);
+}
+
+// copy elements with reversed byte order (big endian stream)
+static void reverse_elements(const unsigned char *src, unsigned char *dst, size_t count, size_t size)
+{
+    switch(size)
+    {
+        case 1:
+            memcpy((void*)dst, (void*)src, count);
+            break;
+        case 2:
+            for(size_t k = 0; k < count; k++)
+            {
+                uint16_t x;
+                memcpy((void*)&x, (void*)&src[2*k], 2);
+                x = __builtin_bswap16(x);
+                memcpy((void*)&dst[2*k], (void*)&x, 2);
+            }
+            break;
+        case 4:
+            for(size_t k = 0; k < count; k++)
+            {
+                uint32_t x;
+                memcpy((void*)&x, (void*)&src[4*k], 4);
+                x = __builtin_bswap32(x);
+                memcpy((void*)&dst[4*k], (void*)&x, 4);
+            }
+            break;
+        case 8:
+            for(size_t k = 0; k < count; k++)
+            {
+                uint64_t x;
+                memcpy((void*)&x, (void*)&src[8*k], 8);
+                x = __builtin_bswap64(x);
+                memcpy((void*)&dst[8*k], (void*)&x, 8);
+            }
+            break;
+        default:
+            for(size_t k = 0; k < count; k++)
+                for(size_t i = 0; i < size; i++)
+                    dst[k*size + i] = src[k*size + size - 1 - i];
+    }
+}
+
+// encode data to characters and write them to stdout (stage: STAGE_SIZE + 8, out: 2*STAGE_SIZE bytes)
+static void encode_data(const unsigned char *data, size_t count, size_t size, bool coding_8bit, unsigned char *stage, char *out)
+{
+    // select packer
+    void (*pack)(const unsigned char *src, char *dst, size_t groups) = pack_swar;
+#if defined(__GNUC__) && defined(__x86_64__)
+    if(__builtin_cpu_supports("bmi2"))
+        pack = pack_bmi2;
+#endif
+    unsigned short table[256];
+    if(coding_8bit)
+        escape_table(table);
+
+    // encode in stage blocks, elements never cross the block boundary
+    size_t total = count*size;
+    for(size_t pos = 0; pos < total; pos += STAGE_SIZE)
+    {
+        size_t len = min((size_t)STAGE_SIZE, total - pos);
+        reverse_elements(&data[pos], stage, len/size, size);
+        if(coding_8bit)
+            octave_stdout.write(out, escape_bytes(table, stage, out, len));
+        else
+        {
+            size_t groups = (len + 6)/7;
+            memset((void*)&stage[len], 0, groups*7 - len + 1);
+            pack(stage, out, groups);
+            octave_stdout.write(out, groups*8);
+        }
+    }
+}
+
+
+DEFUN_DLD(golpi_data2bits, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn {Loadable Function} golpi_data2bits (@var{Data}, @var{ExpDataType}, @var{Dim} )\n\
+@deftypefnx {Loadable Function} golpi_data2bits (@var{Data}, @var{ExpDataType}, @var{Dim}, @var{Coding} )\n\
+Function codes variable content into a series of 7 bit characters and stream it to stdout.\n\
+This is usefull for very fast transfer of data through stdout and is used in project GOLPI\n\
+(Gnu Octave to Labview Pipes Interface). Stream is in big endian coding. The stream starts\n\
+with a header of following format:\n\
+@code{_GpBiT_(SS)(T)(NNNNNNNN)[(SSSSSSS1)[(SSSSSSS2)[...]]]},\n\
+where (SS) is hexadecimal size of one element of array,\n\
+(T) is determined hex. type of variable in coding of @var{ExpDataType},\n\
+(NNNNNNNN) is hex. number of maximum dimensions in coding of @var{Dim},\n\
+(SSSSSSS1) is size of first dimension,\n\
+(SSSSSSS2) is size of second dimension, etc.\n\
+\n\
+Data are coded either to 7 bit characters (default) or by denser 8-bit coding,\n\
+which is marked by bit 3 of (T). In 8-bit coding each byte is sent as character\n\
+(byte + 42) mod 256, characters NUL, LF, CR, ESC and '=' are escaped by '=' followed\n\
+by (character + 64) mod 256. Both codings are decoded by proc_bitstream_decode() of lv_proc.\n\
+\n\
+If variable cannot be converted into @var{ExpDataType}, (T) in header is set to\n\
+zero. If variable @var{Data} has more dimensions than is set in @var{Dim}, (T) in header is set\n\
+to zero to mark error.\n\
+\n\
+Inputs:\n\
+@table @samp\n\
+@item @var{Data} - Variable to encode\n\
+@item @var{ExpDataType} - What is expected data type of the variable.\n\
+     1: signed integer,\n\
+     2: unsigned integer,\n\
+     3: real float,\n\
+     4: complex float,\n\
+     5: string,\n\
+     6: real numeric (integer or float).\n\
+@item @var{Dim} - Maximum expected dimensions of @var{Data}\n\
+     0: scalar,\n\
+     1: vector,\n\
+     2: matrix,\n\
+     etc.\n\
+@item @var{Coding} - Data coding (optional)\n\
+     0: 7-bit coding (default),\n\
+     1: 8-bit coding.\n\
+@end table\n\
+\n\
+Example:\n\
+@example\n\
+@group\n\
+golpi_data2bits([1:5], 6, 1)\n\
+@result{} _GpBiT_083000000020000000100000005...\n\
+@end group\n\
+@end example\n\
+\n\
+@seealso{GOLPI}\n\
+@end deftypefn")
+{
+    octave_value_list res;
+
+    if(args.length() != 3 && args.length() != 4)
+        print_usage();
+    for(int k = 1; k < args.length(); k++)
+        if(!args(k).is_real_scalar())
+            error("golpi_data2bits: ExpDataType, Dim and Coding must be real scalars.");
+    octave_value data = args(0);
+    int exp_type = (int)args(1).double_value();
+    int max_dims = (int)args(2).double_value();
+    bool coding_8bit = args.length() >= 4 && args(3).double_value() != 0.0;
+
+    // object size
+    dim_vector sz = data.dims();
+    size_t count = data.numel();
+    int dn = 0;
+    for(int k = 0; k < sz.length(); k++)
+        dn += (sz(k) > 1);
+
+    // identify data type (flattened, so N-dim arrays share the 2D type identification)
+    octave_value flat = data.reshape(dim_vector(count, 1));
+    std::string errstr;
+    DWORD var_type = var_get_type(flat, errstr);
+    size_t size = var_element_size(var_type);
+    bool is_signed = var_type == VTYPE_INT8 || var_type == VTYPE_INT16 || var_type == VTYPE_INT32 || var_type == VTYPE_INT64;
+    bool is_unsigned = var_type == VTYPE_UINT8 || var_type == VTYPE_UINT16 || var_type == VTYPE_UINT32 || var_type == VTYPE_UINT64;
+    bool is_real = var_type == VTYPE_DBL || var_type == VTYPE_SGL;
+    bool is_complex = var_type == VTYPE_CDBL || var_type == VTYPE_CSGL;
+    int tok = 0;
+    if((is_signed && exp_type == 1) || (is_unsigned && exp_type == 2) || (is_real && exp_type == 3) || (is_complex && exp_type == 4) || (var_type == VTYPE_STRING && exp_type == 5))
+        tok = exp_type;
+    if(!tok && exp_type == 6)
+    {
+        // generic real numeric transfer - identify actual type
+        if(is_signed)
+            tok = 1;
+        else if(is_unsigned)
+            tok = 2;
+        else if(is_real)
+            tok = 3;
+    }
+
+    // check dimensions
+    if(dn > max_dims)
+        tok = 0;
+
+    // get data directly from variable storage and allocate encoder buffers before anything is sent
+    std::shared_ptr<void> hold;
+    const void *pdata = NULL;
+    unsigned char *stage = NULL;
+    char *out = NULL;
+    if(tok && count)
+    {
+        pdata = var_get_data(flat, var_type, hold);
+        stage = (unsigned char*)malloc(STAGE_SIZE + 8);
+        out = (char*)malloc(2*STAGE_SIZE);
+        if(!stage || !out)
+        {
+            free((void*)stage);
+            free((void*)out);
+            error("golpi_data2bits: Not enough memory.");
+        }
+    }
+
+    // send stream header
+    char hdr[32];
+    int tok_coded = (tok && coding_8bit)?(tok | 0x8):tok;
+    sprintf(hdr, "_GpBiT_%02X%01X%08X", (unsigned)((count)?size:0), tok_coded, (unsigned)sz.length());
+    octave_stdout << hdr;
+    for(int k = 0; k < sz.length(); k++)
+    {
+        sprintf(hdr, "%08X", (unsigned)sz(k));
+        octave_stdout << hdr;
+    }
+
+    // convert data to bitstream
+    if(tok && count)
+        encode_data((const unsigned char*)pdata, count, size, coding_8bit, stage, out);
+    free((void*)stage);
+    free((void*)out);
+
+    // mark end of stream
+    octave_stdout << "\n";
+
+    return res;
+}
+
@@ -13,7 +13,7 @@
 ##
 
 ## -*- texinfo -*-
-## @deftypefn {Function file} golpi_data2bits (@var{Data}, @var{ExpDataType}, @var{Dim} )
+## @deftypefn {Function file} golpi_data2bits_ref (@var{Data}, @var{ExpDataType}, @var{Dim} )
 ## Function codes variable content into a series of 7 bit characters and stream it to stdout.
 ## This is usefull for very fast transfer of data through stdout and is used in project GOLPI 
 ## (Gnu Octave to Labview Pipes Interface). Stream is in big endian coding. The stream starts
@@ -58,7 +58,9 @@
 ## @seealso{GOLPI}
 ## @end deftypefn
 
-function golpi_data2bits(Data,ExpDataType,Dim) 
+% Reference m-file implementation of golpi_data2bits (now native oct-file),
+% kept for benchmarking and output comparison by bench_data2bits.m.
+function golpi_data2bits_ref(Data,ExpDataType,Dim)
 
   % object size
   sz=size(Data);
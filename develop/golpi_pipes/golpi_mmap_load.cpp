@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+// Loader of MAT-4 files written by file transfer mode of GOLPI. Replaces
+// generic load() for these files: file is memory mapped, record headers are
+// parsed in place and each matrix is filled from the mapped view by single
+// bulk copy (little-endian double) or by element-wise decoding (other
+// precisions, byte-swapped files, complex planes). See golpi_mmap.hpp for
+// the record format.
+//
+// Usage:
+//   [data] = golpi_mmap_load(path)
+//   [var] = golpi_mmap_load(path, name)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+#include <windows.h>
+#include <stdint.h>
+#include <string.h>
+#include "golpi_mmap.hpp"
+
+// parsed MAT-4 record
+typedef struct{
+    std::string name;
+    int prec; /* MAT4_PREC_xxx */
+    int type; /* MAT4_TYPE_xxx */
+    bool swap; /* big-endian data */
+    bool cplx;
+    octave_idx_type rows;
+    octave_idx_type cols;
+    const char *re; /* real part in mapped view */
+    const char *im; /* imaginary part in mapped view */
+}TMat4Var;
+
+// element sizes of MAT4_PREC_xxx
+static const int mat4_prec_size[] = {8, 4, 4, 2, 2, 1};
+
+
+// swap byte order of 32bit integer
+static inline int32_t swap_int32(int32_t value)
+{
+    uint32_t v = (uint32_t)value;
+    return((int32_t)((v >> 24) | ((v >> 8) & 0xFF00u) | ((v << 8) & 0xFF0000u) | (v << 24)));
+}
+
+// parse MAT-4 record at offset, moves offset to next record, returns false if record is invalid
+static bool mat4_parse(const char *data, uint64_t size, uint64_t &offset, TMat4Var &var)
+{
+    if(size - offset < MAT4_HEAD_SIZE)
+        return(false);
+    int32_t head[5];
+    memcpy((void*)head, (void*)(data + offset), MAT4_HEAD_SIZE);
+    offset += MAT4_HEAD_SIZE;
+
+    // byte order detection: big-endian MOPT read as little-endian is out of range
+    var.swap = head[0] < 0 || head[0] > 9999;
+    if(var.swap)
+        for(int k = 0; k < 5; k++)
+            head[k] = swap_int32(head[k]);
+    int mopt = head[0];
+    if(mopt < 0 || mopt > 9999 || mopt/1000 != (var.swap ? 1 : 0) || (mopt/100)%10 != 0)
+        return(false);
+    var.prec = (mopt/10)%10;
+    var.type = mopt%10;
+    if(var.prec > MAT4_PREC_UINT8 || var.type > MAT4_TYPE_SPARSE)
+        return(false);
+    if(head[1] < 0 || head[2] < 0 || head[3] < 0 || head[3] > 1 || head[4] < 1)
+        return(false);
+    var.rows = head[1];
+    var.cols = head[2];
+    var.cplx = head[3] != 0;
+
+    // name including '\0'
+    if(size - offset < (uint64_t)head[4] || data[offset + head[4] - 1] != '\0')
+        return(false);
+    var.name = std::string(data + offset);
+    offset += head[4];
+
+    // data planes
+    uint64_t plane = (uint64_t)head[1]*head[2];
+    uint64_t elem_size = mat4_prec_size[var.prec]*(var.cplx ? 2 : 1);
+    if(plane > (size - offset)/elem_size)
+        return(false);
+    plane *= mat4_prec_size[var.prec];
+    var.re = data + offset;
+    var.im = var.cplx ? var.re + plane : NULL;
+    offset += plane*(var.cplx ? 2 : 1);
+
+    return(true);
+}
+
+// load element of data plane
+template <typename T> static inline double load_elem(const char *src, bool swap)
+{
+    T value;
+    if(swap)
+    {
+        char tmp[sizeof(T)];
+        for(size_t k = 0; k < sizeof(T); k++)
+            tmp[k] = src[sizeof(T) - 1 - k];
+        memcpy((void*)&value, (void*)tmp, sizeof(T));
+    }
+    else
+        memcpy((void*)&value, (void*)src, sizeof(T));
+    return((double)value);
+}
+
+// decode data plane to doubles with given destination stride
+template <typename T> static void decode_plane(double *dst, const char *src, octave_idx_type count, octave_idx_type stride, bool swap)
+{
+    for(octave_idx_type k = 0; k < count; k++)
+        dst[k*stride] = load_elem<T>(src + k*sizeof(T), swap);
+}
+
+// load data plane to doubles with given destination stride
+static void mat4_load_plane(double *dst, const char *src, octave_idx_type count, octave_idx_type stride, int prec, bool swap)
+{
+    // native layout: single bulk copy
+    if(prec == MAT4_PREC_DBL && !swap && stride == 1)
+    {
+        memcpy((void*)dst, (void*)src, count*sizeof(double));
+        return;
+    }
+    switch(prec)
+    {
+        case MAT4_PREC_DBL: decode_plane<double>(dst, src, count, stride, swap); break;
+        case MAT4_PREC_SGL: decode_plane<float>(dst, src, count, stride, swap); break;
+        case MAT4_PREC_INT32: decode_plane<int32_t>(dst, src, count, stride, swap); break;
+        case MAT4_PREC_INT16: decode_plane<int16_t>(dst, src, count, stride, swap); break;
+        case MAT4_PREC_UINT16: decode_plane<uint16_t>(dst, src, count, stride, swap); break;
+        case MAT4_PREC_UINT8: decode_plane<uint8_t>(dst, src, count, stride, swap); break;
+    }
+}
+
+// make Octave variable from MAT-4 record
+static octave_value mat4_value(const TMat4Var &var)
+{
+    dim_vector dims(var.rows, var.cols);
+    octave_idx_type count = var.rows*var.cols;
+    if(var.type == MAT4_TYPE_TEXT)
+    {
+        NDArray codes(dims);
+        mat4_load_plane(codes.fortran_vec(), var.re, count, 1, var.prec, var.swap);
+        charNDArray text(dims);
+        for(octave_idx_type k = 0; k < count; k++)
+            text(k) = (char)codes(k);
+        return(octave_value(text, '\''));
+    }
+    if(var.cplx)
+    {
+        // separate real and imaginary planes to interleaved complex
+        ComplexNDArray data(dims);
+        double *dst = (double*)data.fortran_vec();
+        mat4_load_plane(dst, var.re, count, 2, var.prec, var.swap);
+        mat4_load_plane(dst + 1, var.im, count, 2, var.prec, var.swap);
+        return(octave_value(data));
+    }
+    NDArray data(dims);
+    mat4_load_plane(data.fortran_vec(), var.re, count, 1, var.prec, var.swap);
+    return(octave_value(data));
+}
+
+
+// load variables from MAT-4 file
+DEFUN_DLD(golpi_mmap_load, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn {Loadable Function} @var{Data} = golpi_mmap_load (@var{Path})\n\
+@deftypefnx {Loadable Function} @var{Var} = golpi_mmap_load (@var{Path}, @var{Name})\n\
+Function loads variables from MAT-4 file @var{Path}. File is memory mapped\n\
+and the matrices are copied directly from the mapped file, so it is faster\n\
+than generic @code{load} for large files written by file transfer mode of GOLPI\n\
+(Gnu Octave to Labview Pipes Interface).\n\
+\n\
+Without @var{Name} it returns structure @var{Data} with one item per variable\n\
+of the file. With @var{Name} it returns just variable @var{Var} of this name.\n\
+\n\
+Both little-endian and big-endian files are supported with all MAT-4 precisions,\n\
+real, complex and text matrices. Integer and single precision data are converted\n\
+to double like @code{load} does. Sparse matrices are not supported.\n\
+\n\
+Example:\n\
+@example\n\
+x = golpi_mmap_load('data.mat', 'x');\n\
+@end example\n\
+\n\
+@seealso{golpi_mmap_save, GOLPI}\n\
+@end deftypefn")
+{
+    octave_value_list res;
+
+    if(args.length() < 1 || args.length() > 2)
+        print_usage();
+    if(!args(0).is_string())
+        error("golpi_mmap_load: First argument must be file path string.");
+    std::string path = args(0).string_value();
+    std::string name;
+    if(args.length() > 1)
+    {
+        if(!args(1).is_string())
+            error("golpi_mmap_load: Second argument must be variable name string.");
+        name = args(1).string_value();
+    }
+
+    TMapFile mf;
+    if(map_open(&mf, path))
+    {
+        map_close(&mf);
+        error("golpi_mmap_load: Cannot open file '%s'.", path.c_str());
+    }
+
+    // parse records and convert variables while the file is mapped
+    octave_scalar_map data;
+    octave_value var;
+    bool found = false;
+    std::string errstr;
+    uint64_t offset = 0;
+    while(offset < mf.size)
+    {
+        TMat4Var rec;
+        if(!mat4_parse(mf.data, mf.size, offset, rec) || !mat4_check_name(rec.name))
+        {
+            errstr = "golpi_mmap_load: File '" + path + "' is not valid MAT-4 file.";
+            break;
+        }
+        if(!name.empty() && rec.name != name)
+            continue;
+        if(rec.type == MAT4_TYPE_SPARSE)
+        {
+            errstr = "golpi_mmap_load: Sparse variable '" + rec.name + "' is not supported.";
+            break;
+        }
+        if(!name.empty())
+        {
+            var = mat4_value(rec);
+            found = true;
+            break;
+        }
+        data.assign(rec.name, mat4_value(rec));
+    }
+    map_close(&mf);
+
+    if(!errstr.empty())
+        error("%s", errstr.c_str());
+    if(!name.empty() && !found)
+        error("golpi_mmap_load: Variable '%s' not found in file '%s'.", name.c_str(), path.c_str());
+
+    if(name.empty())
+        res(0) = data;
+    else
+        res(0) = var;
+    return res;
+}
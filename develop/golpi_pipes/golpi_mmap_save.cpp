@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+// Writer of MAT-4 files for file transfer mode of GOLPI. Replaces generic
+// save -v4: total file size is evaluated first, then the file is created,
+// memory mapped and each matrix is stored into the mapped view by single
+// bulk copy (real) or by splitting to real and imaginary planes (complex).
+// Data are always stored as little-endian double. See golpi_mmap.hpp for
+// the record format.
+//
+// Usage:
+//   golpi_mmap_save(path, data)
+//   golpi_mmap_save(path, name, var)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <octave/ov-struct.h>
+#include <windows.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "golpi_mmap.hpp"
+
+// variable to save
+typedef struct{
+    std::string name;
+    octave_value value;
+}TMat4Item;
+
+
+// size of MAT-4 record of variable, returns 0 if variable type is not supported
+static uint64_t mat4_record_size(const TMat4Item &item)
+{
+    const octave_value &v = item.value;
+    if(v.ndims() != 2 || v.is_sparse_type() || !(v.is_numeric_type() || v.is_bool_type() || v.is_string()))
+        return(0);
+    uint64_t plane = (uint64_t)v.numel()*sizeof(double);
+    return(MAT4_HEAD_SIZE + item.name.size() + 1 + plane*(v.is_complex_type() ? 2 : 1));
+}
+
+// write MAT-4 record of variable, returns end of record
+static char *mat4_write_record(char *dst, const TMat4Item &item)
+{
+    const octave_value &v = item.value;
+    octave_idx_type count = v.numel();
+    bool cplx = v.is_complex_type();
+    int32_t head[5];
+    head[0] = MAT4_PREC_DBL*10 + (v.is_string() ? MAT4_TYPE_TEXT : MAT4_TYPE_NUMERIC);
+    head[1] = v.rows();
+    head[2] = v.columns();
+    head[3] = cplx;
+    head[4] = item.name.size() + 1;
+    memcpy((void*)dst, (void*)head, MAT4_HEAD_SIZE);
+    dst += MAT4_HEAD_SIZE;
+    memcpy((void*)dst, (void*)item.name.c_str(), item.name.size() + 1);
+    dst += item.name.size() + 1;
+
+    double *re = (double*)dst;
+    if(v.is_string())
+    {
+        // text is stored as character codes
+        charNDArray text = v.char_array_value();
+        for(octave_idx_type k = 0; k < count; k++)
+            re[k] = (unsigned char)text(k);
+    }
+    else if(cplx)
+    {
+        // interleaved complex to separate real and imaginary planes
+        ComplexNDArray data = v.complex_array_value();
+        const double *src = (const double*)data.data();
+        double *im = re + count;
+        for(octave_idx_type k = 0; k < count; k++)
+        {
+            re[k] = src[2*k];
+            im[k] = src[2*k + 1];
+        }
+    }
+    else
+    {
+        NDArray data = v.array_value();
+        memcpy((void*)re, (void*)data.data(), count*sizeof(double));
+    }
+    return(dst + count*sizeof(double)*(cplx ? 2 : 1));
+}
+
+
+// save variables to MAT-4 file
+DEFUN_DLD(golpi_mmap_save, args, nargout,
+"-*- texinfo -*-\n\
+@deftypefn {Loadable Function} golpi_mmap_save (@var{Path}, @var{Data})\n\
+@deftypefnx {Loadable Function} golpi_mmap_save (@var{Path}, @var{Name}, @var{Var})\n\
+Function saves variables to MAT-4 file @var{Path}. File is created with its\n\
+final size, memory mapped and the matrices are copied directly to the mapped\n\
+file, so it is faster than generic @code{save -v4} for large variables of\n\
+file transfer mode of GOLPI (Gnu Octave to Labview Pipes Interface).\n\
+\n\
+With structure @var{Data} it saves each item of the structure as variable\n\
+of the same name. With @var{Name} it saves single variable @var{Var}.\n\
+Existing file is overwritten.\n\
+\n\
+Real, complex, logical, integer and text matrices are supported, all are\n\
+stored as little-endian double (text as character codes). Only two\n\
+dimensional matrices can be stored. Sparse matrices are not supported.\n\
+\n\
+Example:\n\
+@example\n\
+golpi_mmap_save('data.mat', 'x', rand(1000));\n\
+@end example\n\
+\n\
+@seealso{golpi_mmap_load, GOLPI}\n\
+@end deftypefn")
+{
+    octave_value_list res;
+
+    if(nargout)
+        error("golpi_mmap_save: No output arguments expected.");
+    if(args.length() < 2 || args.length() > 3)
+        print_usage();
+    if(!args(0).is_string())
+        error("golpi_mmap_save: First argument must be file path string.");
+    std::string path = args(0).string_value();
+
+    // variables to save
+    std::vector<TMat4Item> items;
+    if(args.length() == 2)
+    {
+        if(!args(1).is_map() || args(1).numel() != 1)
+            error("golpi_mmap_save: Second argument must be scalar structure of variables.");
+        octave_scalar_map data = args(1).scalar_map_value();
+        string_vector keys = data.keys();
+        for(octave_idx_type f = 0; f < keys.numel(); f++)
+        {
+            TMat4Item item = {keys(f), data.contents(keys(f))};
+            items.push_back(item);
+        }
+    }
+    else
+    {
+        if(!args(1).is_string())
+            error("golpi_mmap_save: Second argument must be variable name string.");
+        TMat4Item item = {args(1).string_value(), args(2)};
+        items.push_back(item);
+    }
+
+    // total file size
+    uint64_t size = 0;
+    for(size_t k = 0; k < items.size(); k++)
+    {
+        if(!mat4_check_name(items[k].name))
+            error("golpi_mmap_save: Invalid variable name '%s'.", items[k].name.c_str());
+        uint64_t rec_size = mat4_record_size(items[k]);
+        if(!rec_size)
+            error("golpi_mmap_save: Variable '%s' is not two dimensional real, complex, logical or text matrix.", items[k].name.c_str());
+        if(items[k].value.rows() > INT32_MAX || items[k].value.columns() > INT32_MAX)
+            error("golpi_mmap_save: Variable '%s' is too large for MAT-4 file.", items[k].name.c_str());
+        size += rec_size;
+    }
+
+    TMapFile mf;
+    if(map_create(&mf, path, size))
+    {
+        map_close(&mf);
+        error("golpi_mmap_save: Cannot create file '%s'.", path.c_str());
+    }
+
+    // store records to mapped file
+    char *dst = mf.data;
+    for(size_t k = 0; k < items.size(); k++)
+        dst = mat4_write_record(dst, items[k]);
+    map_close(&mf);
+
+    return res;
+}
@@ -0,0 +1,230 @@
+//------------------------------------------------------------------------------
+// Loopback peer of GOLPI data pipes for round-trip tests without LabVIEW.
+// Creates two pipes inside Octave, peer thread emulates LabVIEW side: it
+// receives data sent by Octave to first pipe and sends them back to Octave
+// via second pipe, so output of golpi_pipe_send() can be received by
+// golpi_pipe_receive() and output of golpi_pipe_send_many() can be received
+// by golpi_pipe_receive_many(). In stream mode only data of the record are
+// sent back, so they can be received by golpi_stream_open() and friends.
+//
+// Usage:
+//   golpi_pipe_loop('start', tx_pipe, rx_pipe, mode)
+//   [ack] = golpi_pipe_loop('stop')
+//
+// Parameters:
+//   tx_pipe: name of pipe Octave sends to, e.g. '\\.\pipe\GOLPI_tx'
+//   rx_pipe: name of pipe Octave receives from, e.g. '\\.\pipe\GOLPI_rx'
+//   mode: 0 - single variable record, 1 - variables table and data,
+//         2 - single variable record, send back data only (stream)
+//
+// Returns:
+//   ack: true if receiving side confirmed the data by ACK
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+// pipe buffer size
+#define LOOP_PIPE_BUF 1048576
+// timeout of each transfer [s]
+#define LOOP_TIMEOUT 10.0
+// idle time after which sender waits for final ACK [s]
+#define LOOP_IDLE 0.3
+// loop modes
+#define LOOP_MODE_RECORD 0
+#define LOOP_MODE_MANY 1
+#define LOOP_MODE_STREAM 2
+
+// peer thread state
+typedef struct{
+    HANDLE tx; /* pipe Octave sends to */
+    HANDLE rx; /* pipe Octave receives from */
+    HANDLE thread;
+    int mode;
+    char *data; /* received data */
+    DWORD size; /* received data size */
+    DWORD cap; /* received data buffer size */
+    bool ack;
+}TLoop;
+
+// running loop (NULL if none)
+static TLoop *loop = NULL;
+
+
+// wait for client connection of pipe instance
+static DWORD loop_connect(HANDLE pipe, double timeout)
+{
+    OVERLAPPED overlap;
+    memset((void*)&overlap, 0, sizeof(overlap));
+    overlap.hEvent = CreateEvent(NULL, true, false, NULL);
+    if(!overlap.hEvent)
+        return(1);
+    DWORD err = 0;
+    if(!ConnectNamedPipe(pipe, &overlap))
+    {
+        DWORD code = GetLastError();
+        if(code == ERROR_IO_PENDING)
+        {
+            if(WaitForSingleObject(overlap.hEvent, (DWORD)(timeout*1000.0)) != WAIT_OBJECT_0)
+            {
+                CancelIo(pipe);
+                err = 1;
+            }
+        }
+        else if(code != ERROR_PIPE_CONNECTED)
+            err = 1;
+    }
+    CloseHandle(overlap.hEvent);
+    return(err);
+}
+
+// receive data from sender and append them to loop buffer
+static DWORD loop_read(TLoop *lp, DWORD size, bool store)
+{
+    if(lp->size + size > lp->cap)
+    {
+        DWORD cap = (2*lp->cap > lp->size + size)?(2*lp->cap):(lp->size + size);
+        char *data = (char*)realloc((void*)lp->data, cap);
+        if(!data)
+            return(1);
+        lp->data = data;
+        lp->cap = cap;
+    }
+    if(ReadFileTimeout(lp->tx, (void*)&lp->data[lp->size], size, NULL, LOOP_TIMEOUT))
+        return(1);
+    if(store)
+        lp->size += size;
+    return(0);
+}
+
+// peer thread: receive data from Octave and send them back
+static DWORD WINAPI loop_thread(LPVOID arg)
+{
+    TLoop *lp = (TLoop*)arg;
+    lp->ack = false;
+
+    // sender waits for sync byte first
+    char sync = 's';
+    if(loop_connect(lp->tx, LOOP_TIMEOUT) || WriteFileTimeout(lp->tx, (void*)&sync, 1, NULL, 0, LOOP_TIMEOUT))
+        return(0);
+
+    // raw header: record header or variables table
+    if(lp->mode == LOOP_MODE_MANY)
+    {
+        if(loop_read(lp, sizeof(DWORD), true))
+            return(0);
+        DWORD count;
+        memcpy((void*)&count, (void*)lp->data, sizeof(DWORD));
+        for(DWORD k = 0; k < count; k++)
+        {
+            DWORD name_len;
+            if(loop_read(lp, sizeof(DWORD), true))
+                return(0);
+            memcpy((void*)&name_len, (void*)&lp->data[lp->size - sizeof(DWORD)], sizeof(DWORD));
+            if(loop_read(lp, name_len + 3*sizeof(DWORD), true))
+                return(0);
+        }
+    }
+    else if(loop_read(lp, 3*sizeof(DWORD), true))
+        return(0);
+
+    // data in ACK blocks, sender waits for final ACK when all blocks are sent
+    DWORD len;
+    while(!ReadFileTimeout(lp->tx, (void*)&len, sizeof(DWORD), NULL, LOOP_IDLE))
+    {
+        char ack = 'A';
+        if(loop_read(lp, len, true) || WriteFileTimeout(lp->tx, (void*)&ack, 1, NULL, 0, LOOP_TIMEOUT))
+            return(0);
+    }
+    char res = 'a';
+    if(WriteFileTimeout(lp->tx, (void*)&res, 1, NULL, 0, LOOP_TIMEOUT) || ReadFileTimeout(lp->tx, (void*)&res, 1, NULL, LOOP_TIMEOUT))
+        return(0);
+
+    // send data back (without record header for stream), receiver confirms them by ACK
+    DWORD skip = (lp->mode == LOOP_MODE_STREAM)?(3*sizeof(DWORD)):0;
+    if(loop_connect(lp->rx, LOOP_TIMEOUT) || WriteFileTimeout(lp->rx, (void*)&lp->data[skip], lp->size - skip, NULL, 65536, LOOP_TIMEOUT))
+        return(0);
+    if(ReadFileTimeout(lp->rx, (void*)&res, 1, NULL, LOOP_TIMEOUT))
+        return(0);
+    lp->ack = (res == 'a');
+    WriteFileTimeout(lp->rx, (void*)&res, 1, NULL, 0, LOOP_TIMEOUT);
+    return(0);
+}
+
+// create pipe instance
+static HANDLE loop_pipe(const octave_value &name)
+{
+    if(!name.is_string())
+        return(INVALID_HANDLE_VALUE);
+    return(CreateNamedPipeA(name.string_value().c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, LOOP_PIPE_BUF, LOOP_PIPE_BUF, 0, NULL));
+}
+
+// stop peer thread and free loop
+static bool loop_free(TLoop *lp)
+{
+    if(lp->thread)
+    {
+        WaitForSingleObject(lp->thread, INFINITE);
+        CloseHandle(lp->thread);
+    }
+    bool ack = lp->ack;
+    if(lp->tx != INVALID_HANDLE_VALUE)
+        CloseHandle(lp->tx);
+    if(lp->rx != INVALID_HANDLE_VALUE)
+        CloseHandle(lp->rx);
+    free((void*)lp->data);
+    delete lp;
+    return(ack);
+}
+
+// loopback peer of data pipes
+DEFUN_DLD(golpi_pipe_loop, args, nargout, "Loopback peer of GOLPI data pipes for round-trip tests")
+{
+    octave_value_list res;
+
+    if(args.length() < 1 || !args(0).is_string())
+        error("Loop command expected.");
+    std::string cmd = args(0).string_value();
+
+    if(cmd.compare("start") == 0)
+    {
+        if(args.length() != 4 || !args(3).is_real_scalar())
+            error("Send pipe name, receive pipe name and mode expected.");
+        if(loop)
+            error("Loop is already running.");
+        TLoop *lp = new TLoop;
+        memset((void*)lp, 0, sizeof(TLoop));
+        lp->mode = (int)args(3).double_value();
+        lp->tx = loop_pipe(args(1));
+        lp->rx = loop_pipe(args(2));
+        if(lp->tx == INVALID_HANDLE_VALUE || lp->rx == INVALID_HANDLE_VALUE)
+        {
+            loop_free(lp);
+            error("Cannot create loop pipes.");
+        }
+        lp->thread = CreateThread(NULL, 0, loop_thread, (LPVOID)lp, 0, NULL);
+        if(!lp->thread)
+        {
+            loop_free(lp);
+            error("Cannot start loop thread.");
+        }
+
+        // keep oct-file loaded while the thread runs
+        mlock();
+        loop = lp;
+    }
+    else if(cmd.compare("stop") == 0)
+    {
+        if(!loop)
+            error("Loop is not running.");
+        res(0) = octave_value(loop_free(loop));
+        loop = NULL;
+        munlock();
+    }
+    else
+        error("Unknown loop command '%s'.", cmd.c_str());
+
+    return res;
+}
@@ -0,0 +1,579 @@
+//------------------------------------------------------------------------------
+// Variable helpers shared by GOLPI named pipe transfer functions.
+//
+// Handles identification of Octave variable type, reading of variable data
+// from pipe into new Octave variable and writing of variable data to pipe.
+// Variable data format is the same for all transfer functions:
+//   BYTES - variable data (column-major order, complex as re,im,re,im, ...,
+//           logical as one byte per element)
+// Types are described by table, so new type is just one VAR_TYPE() entry.
+//
+// Containers contain nested variable records, each record is:
+//   DWORD - variable_type_id
+//   DWORD - rows_count
+//   DWORD - columns_count
+//   BYTES - variable data
+// Data of containers:
+//   VTYPE_CELL: record of each cell (column-major order)
+//   VTYPE_CELLSTR: for each cell (column-major order):
+//     DWORD - string length
+//     BYTES - string (no '\0' at the end)
+//   VTYPE_STRUCT:
+//     DWORD - fields count
+//     for each field:
+//       DWORD - name length
+//       BYTES - name (no '\0' at the end)
+//     for each struct array element (column-major order):
+//       record of each field
+//
+// Sparse matrices (VTYPE_SPARSE, VTYPE_SPARSE_CDBL, VTYPE_SPARSE_LOGICAL) are
+// sent in compressed sparse column form:
+//   DWORD - nonzero elements count (nnz)
+//   DWORD[columns_count + 1] - column pointers (first 0, last nnz)
+//   DWORD[nnz] - row indices (zero based, ascending in each column)
+//   BYTES - nnz values
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+// max struct field name length
+#define MAX_NAME_LEN 1024
+// max struct fields count
+#define MAX_FIELDS 65536
+// elements count of produced data chunk
+#define PRODUCER_CHUNK 4096
+// max nesting level of containers
+#define MAX_NESTING 64
+
+
+// --- Variable types table ---
+typedef struct{
+    DWORD var_type; /* type id */
+    DWORD element_size; /* size of single element in bytes */
+    bool (*is)(const octave_value &var); /* variable is of this type */
+    octave_value (*create)(DWORD m, DWORD n, void **data); /* create variable, return pointer to its data storage */
+    DWORD (*write)(TPipeWriter *wr, const octave_value &var, DWORD size); /* write variable data storage to pipe */
+    const void *(*data)(const octave_value &var, std::shared_ptr<void> &hold); /* get variable data storage, kept alive by 'hold' */
+}TVarType;
+
+// table entry for variable type 'id' stored as Octave array 'A', which is obtained by octave_value method 'value',
+// 'is' is condition on 'var' identifying the type
+// note: array values share the variable storage, so only const access to the data is used on write to not trigger copy
+#define VAR_TYPE(id, A, value, is) {id, sizeof(A::element_type), \
+    [](const octave_value &var) -> bool { return(is); }, \
+    [](DWORD m, DWORD n, void **data) -> octave_value { A array(dim_vector(m, n)); *data = (void*)array.fortran_vec(); return octave_value(array); }, \
+    [](TPipeWriter *wr, const octave_value &var, DWORD size) -> DWORD { const A array = var.value(); return writer_write(wr, (void*)array.data(), size); }, \
+    [](const octave_value &var, std::shared_ptr<void> &hold) -> const void* { const A *array = new A(var.value()); hold.reset((A*)array); return array->data(); }}
+
+// supported variable types
+static const TVarType var_types[] = {
+    VAR_TYPE(VTYPE_STRING, charNDArray, char_array_value, var.is_string()),
+    VAR_TYPE(VTYPE_INT8, int8NDArray, int8_array_value, var.is_int8_type()),
+    VAR_TYPE(VTYPE_UINT8, uint8NDArray, uint8_array_value, var.is_uint8_type()),
+    VAR_TYPE(VTYPE_INT16, int16NDArray, int16_array_value, var.is_int16_type()),
+    VAR_TYPE(VTYPE_UINT16, uint16NDArray, uint16_array_value, var.is_uint16_type()),
+    VAR_TYPE(VTYPE_INT32, int32NDArray, int32_array_value, var.is_int32_type()),
+    VAR_TYPE(VTYPE_UINT32, uint32NDArray, uint32_array_value, var.is_uint32_type()),
+    VAR_TYPE(VTYPE_INT64, int64NDArray, int64_array_value, var.is_int64_type()),
+    VAR_TYPE(VTYPE_UINT64, uint64NDArray, uint64_array_value, var.is_uint64_type()),
+    VAR_TYPE(VTYPE_DBL, NDArray, array_value, var.is_double_type() && !var.is_complex_type()),
+    VAR_TYPE(VTYPE_CDBL, ComplexNDArray, complex_array_value, var.is_double_type() && var.is_complex_type()),
+    VAR_TYPE(VTYPE_SGL, FloatNDArray, float_array_value, var.is_single_type() && !var.is_complex_type()),
+    VAR_TYPE(VTYPE_CSGL, FloatComplexNDArray, float_complex_array_value, var.is_single_type() && var.is_complex_type()),
+    VAR_TYPE(VTYPE_LOGICAL, boolNDArray, bool_array_value, var.is_bool_type())
+};
+
+// find variable type in table (NULL if not found)
+static const TVarType *var_type_find(DWORD var_type)
+{
+    for(unsigned k = 0; k < sizeof(var_types)/sizeof(TVarType); k++)
+        if(var_types[k].var_type == var_type)
+            return(&var_types[k]);
+    return(NULL);
+}
+
+// find variable type in table matching the variable (NULL if not found)
+static const TVarType *var_type_match(const octave_value &var)
+{
+    for(unsigned k = 0; k < sizeof(var_types)/sizeof(TVarType); k++)
+        if(var_types[k].is(var))
+            return(&var_types[k]);
+    return(NULL);
+}
+
+
+// identify variable type, returns VTYPE_ERROR if not supported and sets error message
+// 'deep' checks also all items of cells and structs, else only the variable itself is identified
+static DWORD var_get_type_nested(const octave_value &var, std::string &errstr, int level, bool deep)
+{
+    DWORD var_type = VTYPE_ERROR;
+    if(level > MAX_NESTING)
+        errstr = "GOLPI pipe interface: Too deep nesting of cells or structs.";
+    else if(var.ndims() > 2)
+        errstr = "GOLPI pipe interface: Variable must have max 2 dims.";
+    else if(var.class_name().compare("cell") == 0) /* note: workaround for old Octave 4.xx which has no iscell() method wtf??? */
+    {
+        // cell: check all items, cell of row strings is sent as cellstr
+        const Cell cell = var.cell_value();
+        bool cellstr = cell.numel() > 0;
+        for(octave_idx_type k = 0; k < cell.numel() && (deep || cellstr); k++)
+        {
+            const octave_value &item = cell(k);
+            if(deep && var_get_type_nested(item, errstr, level + 1, deep) == VTYPE_ERROR)
+                return(VTYPE_ERROR);
+            if(!item.is_string() || item.ndims() > 2 || item.rows() > 1)
+                cellstr = false;
+        }
+        var_type = (cellstr)?VTYPE_CELLSTR:VTYPE_CELL;
+    }
+    else if(var.is_map())
+    {
+        // struct: check all fields of all elements
+        const octave_map map = var.map_value();
+        const string_vector keys = map.keys();
+        for(octave_idx_type f = 0; f < keys.numel() && deep; f++)
+        {
+            const Cell field = map.contents(keys(f));
+            for(octave_idx_type k = 0; k < field.numel(); k++)
+                if(var_get_type_nested(field(k), errstr, level + 1, deep) == VTYPE_ERROR)
+                    return(VTYPE_ERROR);
+        }
+        var_type = VTYPE_STRUCT;
+    }
+    else if(var.is_sparse_type())
+    {
+        // sparse: note must be checked before dense types, as sparse matrices also report as those
+        if(var.is_bool_type())
+            var_type = VTYPE_SPARSE_LOGICAL;
+        else if(var.is_complex_type())
+            var_type = VTYPE_SPARSE_CDBL;
+        else
+            var_type = VTYPE_SPARSE;
+    }
+    else if(!var.is_matrix_type() && !var.is_scalar_type() && !var.is_range() && !var.is_string())
+        errstr = "GOLPI pipe interface: Variable must be numeric type, string, cell or struct.";
+    else
+    {
+        // numeric, logical or string: type of table
+        const TVarType *type = var_type_match(var);
+        if(type)
+            var_type = type->var_type;
+        else
+            errstr = "GOLPI pipe interface: unsupported variable type.";
+    }
+    return(var_type);
+}
+
+// identify variable type, returns VTYPE_ERROR if not supported and sets error message
+DWORD var_get_type(const octave_value &var, std::string &errstr)
+{
+    return(var_get_type_nested(var, errstr, 0, true));
+}
+
+// get size of single element of variable type in bytes (0 for unknown type)
+DWORD var_element_size(DWORD var_type)
+{
+    const TVarType *type = var_type_find(var_type);
+    return((type)?type->element_size:0);
+}
+
+// create new Octave variable of given type and size, returns pointer to its data storage (NULL for unknown type)
+void *var_create(DWORD var_type, DWORD m, DWORD n, octave_value &var)
+{
+    const TVarType *type = var_type_find(var_type);
+    if(!type)
+        return(NULL);
+    void *data;
+    var = type->create(m, n, &data);
+    return(data);
+}
+
+// get contiguous data storage of numeric or string variable (NULL for other types)
+// note: storage is shared with variable when possible, lazily stored values are expanded, 'hold' keeps the storage alive
+const void *var_get_data(const octave_value &var, DWORD var_type, std::shared_ptr<void> &hold)
+{
+    const TVarType *type = var_type_find(var_type);
+    if(!type)
+        return(NULL);
+    return(type->data(var, hold));
+}
+
+static DWORD var_read_data_nested(TPipeReader *rd, DWORD var_type, DWORD m, DWORD n, octave_value &var, std::string &errstr, int level);
+
+// read data from pipe reader, set error message on timeout
+static DWORD var_read(TPipeReader *rd, void *data, DWORD size, std::string &errstr)
+{
+    if(reader_read(rd, data, size))
+    {
+        errstr = "GOLPI pipe interface: Timeout while transfering data.";
+        return(1);
+    }
+    return(0);
+}
+
+// read sparse matrix indices, converts from DWORD if Octave index type differs
+static DWORD var_read_index(TPipeReader *rd, octave_idx_type *idx, DWORD count, std::string &errstr)
+{
+    if(sizeof(octave_idx_type) == sizeof(DWORD))
+        return(var_read(rd, (void*)idx, count*sizeof(DWORD), errstr));
+    DWORD buf[PRODUCER_CHUNK];
+    while(count)
+    {
+        DWORD chunk = min(count, PRODUCER_CHUNK);
+        if(var_read(rd, (void*)buf, chunk*sizeof(DWORD), errstr))
+            return(1);
+        for(DWORD k = 0; k < chunk; k++)
+            *idx++ = buf[k];
+        count -= chunk;
+    }
+    return(0);
+}
+
+// read sparse matrix directly to its compressed storage
+template <typename S>
+static DWORD var_read_sparse(TPipeReader *rd, DWORD m, DWORD n, octave_value &var, std::string &errstr)
+{
+    DWORD nnz;
+    if(var_read(rd, (void*)&nnz, sizeof(DWORD), errstr))
+        return(1);
+
+    // sizes must fit to Octave index type (it may be 32bit signed)
+    if((octave_idx_type)m < 0 || (octave_idx_type)n < 0 || (octave_idx_type)(n + 1) <= 0 || (octave_idx_type)nnz < 0 ||
+       (unsigned long long)nnz > (unsigned long long)m*n)
+    {
+        errstr = "GOLPI pipe interface: Invalid sparse matrix size.";
+        return(1);
+    }
+    S sparse(m, n, nnz);
+    octave_idx_type *cidx = sparse.xcidx();
+    octave_idx_type *ridx = sparse.xridx();
+    if(var_read_index(rd, cidx, n + 1, errstr) || var_read_index(rd, ridx, nnz, errstr) ||
+       var_read(rd, (void*)sparse.xdata(), nnz*sizeof(sparse.xdata()[0]), errstr))
+        return(1);
+
+    // check structure, Octave relies on it
+    bool valid = (cidx[0] == 0 && cidx[n] == (octave_idx_type)nnz);
+    for(DWORD j = 0; j < n && valid; j++)
+    {
+        if(cidx[j + 1] < cidx[j] || cidx[j + 1] > (octave_idx_type)nnz)
+            valid = false;
+        for(octave_idx_type k = cidx[j]; k < cidx[j + 1] && valid; k++)
+            if(ridx[k] < 0 || ridx[k] >= (octave_idx_type)m || (k > cidx[j] && ridx[k] <= ridx[k - 1]))
+                valid = false;
+    }
+    if(!valid)
+    {
+        errstr = "GOLPI pipe interface: Invalid sparse matrix structure.";
+        return(1);
+    }
+
+    var = sparse;
+    return(0);
+}
+
+// read nested variable record (type, size and data)
+static DWORD var_read_record_nested(TPipeReader *rd, octave_value &var, std::string &errstr, int level)
+{
+    DWORD info[3];
+    if(var_read(rd, (void*)info, sizeof(info), errstr))
+        return(1);
+    return(var_read_data_nested(rd, info[0], info[1], info[2], var, errstr, level));
+}
+
+// read variable data of given type and size from pipe reader to new Octave variable
+static DWORD var_read_data_nested(TPipeReader *rd, DWORD var_type, DWORD m, DWORD n, octave_value &var, std::string &errstr, int level)
+{
+    if(level > MAX_NESTING)
+    {
+        errstr = "GOLPI pipe interface: Too deep nesting of cells or structs.";
+        return(1);
+    }
+    
+    if(var_type == VTYPE_CELL)
+    {
+        // cell: nested records
+        Cell cell(dim_vector(m, n));
+        for(octave_idx_type k = 0; k < cell.numel(); k++)
+            if(var_read_record_nested(rd, cell(k), errstr, level + 1))
+                return(1);
+        var = cell;
+    }
+    else if(var_type == VTYPE_CELLSTR)
+    {
+        // cellstr: length prefixed strings
+        Cell cell(dim_vector(m, n));
+        for(octave_idx_type k = 0; k < cell.numel(); k++)
+        {
+            DWORD len;
+            if(var_read(rd, (void*)&len, sizeof(DWORD), errstr))
+                return(1);
+            std::string str(len, '\0');
+            if(len && var_read(rd, (void*)&str[0], len, errstr))
+                return(1);
+            cell(k) = octave_value(str);
+        }
+        var = cell;
+    }
+    else if(var_type == VTYPE_STRUCT)
+    {
+        // struct: field names
+        DWORD count;
+        if(var_read(rd, (void*)&count, sizeof(DWORD), errstr))
+            return(1);
+        if(count > MAX_FIELDS)
+        {
+            errstr = "GOLPI pipe interface: Invalid struct fields count.";
+            return(1);
+        }
+        std::vector<std::string> names(count);
+        for(DWORD f = 0; f < count; f++)
+        {
+            DWORD name_len;
+            if(var_read(rd, (void*)&name_len, sizeof(DWORD), errstr))
+                return(1);
+            if(!name_len || name_len > MAX_NAME_LEN)
+            {
+                errstr = "GOLPI pipe interface: Invalid struct field name length.";
+                return(1);
+            }
+            names[f].resize(name_len);
+            if(var_read(rd, (void*)&names[f][0], name_len, errstr))
+                return(1);
+        }
+        
+        // nested records of fields of each element
+        std::vector<Cell> fields(count, Cell(dim_vector(m, n)));
+        for(octave_idx_type k = 0; k < (octave_idx_type)m*n; k++)
+            for(DWORD f = 0; f < count; f++)
+                if(var_read_record_nested(rd, fields[f](k), errstr, level + 1))
+                    return(1);
+        octave_map map(dim_vector(m, n));
+        for(DWORD f = 0; f < count; f++)
+            map.assign(names[f], fields[f]);
+        if(m == 1 && n == 1)
+            var = map.checkelem(0);
+        else
+            var = map;
+    }
+    else if(var_type == VTYPE_SPARSE)
+        return(var_read_sparse<SparseMatrix>(rd, m, n, var, errstr));
+    else if(var_type == VTYPE_SPARSE_CDBL)
+        return(var_read_sparse<SparseComplexMatrix>(rd, m, n, var, errstr));
+    else if(var_type == VTYPE_SPARSE_LOGICAL)
+        return(var_read_sparse<SparseBoolMatrix>(rd, m, n, var, errstr));
+    else
+    {
+        // numeric or string: allocate variable
+        DWORD element_size = var_element_size(var_type);
+        if(!element_size)
+        {
+            errstr = "GOLPI pipe interface: Unknown variable data type.";
+            return(1);
+        }
+        void *data = var_create(var_type, m, n, var);
+        
+        // try read data (directly to the variable storage)
+        if(var_read(rd, data, m*n*element_size, errstr))
+            return(1);
+    }
+
+    return(0);
+}
+
+// read variable data of given type and size from pipe reader to new Octave variable
+DWORD var_read_data(TPipeReader *rd, DWORD var_type, DWORD m, DWORD n, octave_value &var, std::string &errstr)
+{
+    return(var_read_data_nested(rd, var_type, m, n, var, errstr, 0));
+}
+
+// read complete variable record (type, size and data)
+DWORD var_read_record(TPipeReader *rd, octave_value &var, std::string &errstr)
+{
+    return(var_read_record_nested(rd, var, errstr, 0));
+}
+
+// range adaptor for element producer (range is row vector)
+template <typename R>
+struct TRangeElems{
+    const R &range;
+    TRangeElems(const R &r) : range(r) {}
+    double elem(octave_idx_type i, octave_idx_type j) const { return range.elem(i + j); }
+};
+
+// write elements generated on the fly in column-major order
+// used for lazily stored values which have no data buffer (ranges, diagonal and permutation matrices)
+template <typename T, typename V>
+DWORD write_produced(TPipeWriter *wr, const V &val, octave_idx_type m, octave_idx_type n)
+{
+    T buf[PRODUCER_CHUNK];
+    int used = 0;
+    for(octave_idx_type j = 0; j < n; j++)
+    {
+        for(octave_idx_type i = 0; i < m; i++)
+        {
+            buf[used++] = val.elem(i, j);
+            if(used == PRODUCER_CHUNK)
+            {
+                if(writer_write(wr, (void*)buf, used*sizeof(T)))
+                    return(1);
+                used = 0;
+            }
+        }
+    }
+    if(used)
+        return(writer_write(wr, (void*)buf, used*sizeof(T)));
+    return(0);
+}
+
+// write sparse matrix indices, converts to DWORD if Octave index type differs
+static DWORD write_index(TPipeWriter *wr, const octave_idx_type *idx, octave_idx_type count)
+{
+    if(sizeof(octave_idx_type) == sizeof(DWORD))
+        return(writer_write(wr, (void*)idx, count*sizeof(DWORD)));
+    DWORD buf[PRODUCER_CHUNK];
+    while(count)
+    {
+        octave_idx_type chunk = min(count, PRODUCER_CHUNK);
+        for(octave_idx_type k = 0; k < chunk; k++)
+            buf[k] = (DWORD)*idx++;
+        if(writer_write(wr, (void*)buf, chunk*sizeof(DWORD)))
+            return(1);
+        count -= chunk;
+    }
+    return(0);
+}
+
+// write sparse matrix from its compressed storage
+template <typename S>
+static DWORD write_sparse(TPipeWriter *wr, const S &sparse)
+{
+    DWORD nnz = sparse.nnz();
+    if(writer_write(wr, (void*)&nnz, sizeof(DWORD)) ||
+       write_index(wr, sparse.cidx(), sparse.cols() + 1) ||
+       write_index(wr, sparse.ridx(), nnz))
+        return(1);
+    return(writer_write(wr, (void*)sparse.data(), nnz*sizeof(sparse.data()[0])));
+}
+
+// write variable data to pipe writer
+DWORD var_write_data(TPipeWriter *wr, const octave_value &var, DWORD var_type)
+{
+    DWORD m = var.dims()(0);
+    DWORD n = var.dims()(1);
+    
+    if(var_type == VTYPE_CELL)
+    {
+        // cell: nested records
+        const Cell cell = var.cell_value();
+        for(octave_idx_type k = 0; k < cell.numel(); k++)
+            if(var_write_record(wr, cell(k)))
+                return(1);
+        return(0);
+    }
+    else if(var_type == VTYPE_CELLSTR)
+    {
+        // cellstr: length prefixed strings
+        const Cell cell = var.cell_value();
+        for(octave_idx_type k = 0; k < cell.numel(); k++)
+        {
+            const charNDArray str = cell(k).char_array_value();
+            DWORD len = str.numel();
+            if(writer_write(wr, (void*)&len, sizeof(DWORD)) || writer_write(wr, (void*)str.data(), len))
+                return(1);
+        }
+        return(0);
+    }
+    else if(var_type == VTYPE_STRUCT)
+    {
+        // struct: field names
+        const octave_map map = var.map_value();
+        const string_vector keys = map.keys();
+        DWORD count = keys.numel();
+        if(writer_write(wr, (void*)&count, sizeof(DWORD)))
+            return(1);
+        std::vector<Cell> fields;
+        for(DWORD f = 0; f < count; f++)
+        {
+            const std::string name = keys(f);
+            DWORD name_len = name.size();
+            if(writer_write(wr, (void*)&name_len, sizeof(DWORD)) || writer_write(wr, (void*)name.data(), name_len))
+                return(1);
+            fields.push_back(map.contents(name));
+        }
+        
+        // nested records of fields of each element
+        for(octave_idx_type k = 0; k < (octave_idx_type)m*n; k++)
+            for(DWORD f = 0; f < count; f++)
+                if(var_write_record(wr, fields[f](k)))
+                    return(1);
+        return(0);
+    }
+    
+    else if(var_type == VTYPE_SPARSE)
+        return(write_sparse(wr, var.sparse_matrix_value()));
+    else if(var_type == VTYPE_SPARSE_CDBL)
+        return(write_sparse(wr, var.sparse_complex_matrix_value()));
+    else if(var_type == VTYPE_SPARSE_LOGICAL)
+        return(write_sparse(wr, var.sparse_bool_matrix_value()));
+    
+    DWORD data_size_bytes = m*n*var_element_size(var_type);
+    if(!data_size_bytes)
+        return(0);
+
+    if(var.is_range())
+    {
+        // range: generate elements
+        auto range = var.range_value();
+        return(write_produced<double>(wr, TRangeElems<decltype(range)>(range), m, n));
+    }
+    else if(var.is_perm_matrix())
+    {
+        // permutation matrix: generate elements
+        const PermMatrix perm = var.perm_matrix_value();
+        return(write_produced<double>(wr, perm, m, n));
+    }
+    else if(var.is_diag_matrix())
+    {
+        // diagonal matrix: generate elements
+        if(var_type == VTYPE_CDBL)
+            return(write_produced<Complex>(wr, var.complex_diag_matrix_value(), m, n));
+        else if(var_type == VTYPE_CSGL)
+            return(write_produced<FloatComplex>(wr, var.float_complex_diag_matrix_value(), m, n));
+        else if(var_type == VTYPE_SGL)
+            return(write_produced<float>(wr, var.float_diag_matrix_value(), m, n));
+        else
+            return(write_produced<double>(wr, var.diag_matrix_value(), m, n));
+    }
+
+    // contiguous data: write directly from variable storage
+    const TVarType *type = var_type_find(var_type);
+    if(!type)
+        return(1);
+    return(type->write(wr, var, data_size_bytes));
+}
+
+// write complete variable record (type, size and data)
+// note: variable type must be already checked by var_get_type() of the top level variable,
+//       so nested records only identify their own type
+DWORD var_write_record(TPipeWriter *wr, const octave_value &var)
+{
+    std::string errstr;
+    DWORD info[3];
+    info[0] = var_get_type_nested(var, errstr, 0, false);
+    info[1] = var.dims()(0);
+    info[2] = var.dims()(1);
+    if(info[0] == VTYPE_ERROR)
+    {
+        // this one will be sent empty
+        info[1] = 0;
+        info[2] = 0;
+    }
+    if(writer_write(wr, (void*)info, sizeof(info)))
+        return(1);
+    if(info[0] == VTYPE_ERROR)
+        return(0);
+    return(var_write_data(wr, var, info[0]));
+}
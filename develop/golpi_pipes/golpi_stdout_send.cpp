@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+// Script for transfering variables from Octave environment via its own stdout
+// pipe as binary frames, for callers that cannot create named pipes. Frames
+// are demultiplexed from the stdout text by the readout thread of LV Process
+// to separate queue, so the data are sent at 8 bits per byte with no coding.
+//
+// Data format of frames (see golpi_pipe.hpp):
+//   BYTES - FRAME_OUT_ID ("\x1b" "GpFr")
+//   BYTE  - channel
+//   BYTE  - flags (1 - last frame of message, 2 - discard message)
+//   DWORD - data size
+//   BYTES - data
+// Message is variable record split to frames:
+//   DWORD - variable_type_id
+//   DWORD - rows_count
+//   DWORD - columns_count
+//   BYTES - variable data
+// Message ends by empty frame with the last flag, failed message is
+// terminated with the discard flag.
+//
+// Usage:
+//   golpi_stdout_send(var)
+//   golpi_stdout_send(var, channel)
+//
+// Parameters:
+//   var: variable to send
+//   channel: message channel 0 to 255 (optional, default 0)
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include <iostream>
+#include "golpi_pipe.hpp"
+
+// frame data size
+#define FRAME_BLOCK_SIZE 65536
+
+
+// send variable
+DEFUN_DLD(golpi_stdout_send, args, nargout, "Transfer variable from Octave using binary frames via stdout")
+{
+    octave_value_list res;
+
+    // outputs
+    if(nargout != 0)
+        error("GOLPI pipe interface: No output arguments expected.");
+
+    // inputs
+    if(args.length() < 1 || args.length() > 2)
+        error("GOLPI pipe interface: Variable to send and optional channel expected.");
+    int channel = 0;
+    if(args.length() >= 2)
+    {
+        if(args(1).array_value().numel() != 1)
+            error("GOLPI pipe interface: Second parameter must be channel number.");
+        channel = (int)args(1).array_value().elem(0);
+        if(channel < 0 || channel > 255)
+            error("GOLPI pipe interface: Channel must be 0 to 255.");
+    }
+
+    // identify data type
+    octave_value var = args(0);
+    std::string errstr;
+    if(var_get_type(var, errstr) == VTYPE_ERROR)
+        error("%s", errstr.c_str());
+
+    HANDLE hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+    if(hStdout == INVALID_HANDLE_VALUE || !hStdout)
+        error("GOLPI pipe interface: Cannot access stdout.");
+
+    // frames must not get into the middle of buffered text
+    octave_stdout.flush();
+    std::cout.flush();
+    fflush(stdout);
+
+    // variable record split to frames
+    TPipeWriter wr;
+    DWORD err = writer_init(&wr, hStdout, FRAME_BLOCK_SIZE, 0.0);
+    if(!err)
+    {
+        writer_set_frames(&wr, channel);
+        err = var_write_record(&wr, var);
+    }
+    if(!err)
+        err = writer_flush(&wr);
+    writer_free(&wr);
+
+    // terminate message even if failed, so the receiver does not wait for the rest
+    if(WriteFrame(hStdout, channel, FRAME_FLAG_LAST|(err ? FRAME_FLAG_ERROR : 0), NULL, 0) || err)
+        error("GOLPI pipe interface: Cannot write frame to stdout.");
+
+    // console sync mark
+    octave_stdout << "GOLPImark\n";
+    return res;
+}
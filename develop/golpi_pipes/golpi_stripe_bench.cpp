@@ -0,0 +1,187 @@
+//------------------------------------------------------------------------------
+// Benchmark of striped multi-pipe transfer. Creates K pipe instances inside
+// Octave, peer threads emulate LabVIEW side, so transfer rate of both
+// directions can be measured without LabVIEW.
+//
+// Usage:
+//   [send_rate, receive_rate] = golpi_stripe_bench(pipes_count, size, stripe_size)
+//
+// Parameters:
+//   pipes_count: count of pipe instances (1 to STRIPE_MAX_PIPES)
+//   size: transferred data size in bytes
+//   stripe_size: stripe size in bytes
+//
+// Returns:
+//   send_rate: Octave to peer transfer rate [MB/s]
+//   receive_rate: peer to Octave transfer rate [MB/s]
+//
+// (c) 2025, Stanislav Maslan, smaslan@cmi.cz
+//------------------------------------------------------------------------------
+#include <octave/oct.h>
+#include <windows.h>
+#include "golpi_pipe.hpp"
+
+// pipe buffer size
+#define BENCH_PIPE_BUF 1048576
+
+// peer thread state
+typedef struct{
+    HANDLE file;
+    char *data; /* whole data buffer */
+    DWORD size; /* whole data buffer size */
+    DWORD stripe_size;
+    DWORD index; /* pipe index */
+    DWORD count; /* pipes count */
+    bool read_acks; /* receive ACK blocks or send raw stripes */
+    DWORD err;
+}TBenchPeer;
+
+// peer thread: emulates LabVIEW side of one pipe
+static DWORD WINAPI peer_thread(LPVOID arg)
+{
+    TBenchPeer *peer = (TBenchPeer*)arg;
+    peer->err = 0;
+    if(peer->read_acks)
+    {
+        // receive ACK blocks of this pipe
+        DWORD remain = stripe_pipe_size(peer->index, peer->count, peer->size, peer->stripe_size);
+        char *buf = (char*)malloc(BENCH_PIPE_BUF);
+        if(!buf)
+            peer->err = 1;
+        while(remain && !peer->err)
+        {
+            DWORD len;
+            char ack = 'A';
+            if(ReadFileTimeout(peer->file, (void*)&len, sizeof(DWORD), NULL, 10.0) || len > BENCH_PIPE_BUF || len > remain ||
+               ReadFileTimeout(peer->file, (void*)buf, len, NULL, 10.0) ||
+               WriteFileTimeout(peer->file, (void*)&ack, 1, NULL, 0, 10.0))
+                peer->err = 1;
+            remain -= len;
+        }
+        free((void*)buf);
+    }
+    else
+    {
+        // send raw stripes of this pipe
+        for(unsigned long long offset = (unsigned long long)peer->index*peer->stripe_size; offset < peer->size && !peer->err; offset += (unsigned long long)peer->count*peer->stripe_size)
+            peer->err = WriteFileTimeout(peer->file, (void*)&peer->data[offset], min(peer->stripe_size, peer->size - (DWORD)offset), NULL, 0, 10.0);
+    }
+    return(0);
+}
+
+// run peers, transfer data and return rate [MB/s]
+static double bench_run(HANDLE *servers, HANDLE *clients, DWORD count, char *src, char *dst, DWORD size, DWORD stripe_size, bool send)
+{
+    TBenchPeer peers[STRIPE_MAX_PIPES];
+    HANDLE threads[STRIPE_MAX_PIPES];
+    TTimer timer;
+    timer_init(&timer);
+    DWORD started = 0;
+    for(DWORD k = 0; k < count; k++)
+    {
+        peers[k].file = servers[k];
+        peers[k].data = src;
+        peers[k].size = size;
+        peers[k].stripe_size = stripe_size;
+        peers[k].index = k;
+        peers[k].count = count;
+        peers[k].read_acks = send;
+        peers[k].err = 1;
+        threads[k] = CreateThread(NULL, 0, peer_thread, (LPVOID)&peers[k], 0, NULL);
+        if(!threads[k])
+            break;
+        started++;
+    }
+    DWORD err = 1;
+    if(started == count && send)
+        err = stripe_write(clients, count, src, size, stripe_size, 10.0);
+    else if(started == count)
+        err = stripe_read(clients, count, dst, size, stripe_size, 10.0);
+    if(started)
+        WaitForMultipleObjects(started, threads, true, INFINITE);
+    double dt = timer_get(&timer);
+    for(DWORD k = 0; k < started; k++)
+    {
+        err |= peers[k].err;
+        CloseHandle(threads[k]);
+    }
+    if(err)
+        return(-1.0);
+    return(size/dt/1.0e6);
+}
+
+// close pipe instances and their client handles
+static void bench_close_pipes(HANDLE *servers, HANDLE *clients, DWORD count)
+{
+    for(DWORD k = 0; k < count; k++)
+    {
+        if(clients[k] != INVALID_HANDLE_VALUE)
+            CloseHandle(clients[k]);
+        if(servers[k] != INVALID_HANDLE_VALUE)
+            CloseHandle(servers[k]);
+    }
+}
+
+// benchmark striped transfer
+DEFUN_DLD(golpi_stripe_bench, args, nargout, "Benchmark of striped multi-pipe transfer")
+{
+    octave_value_list res;
+    
+    if(args.length() != 3)
+        error("Pipes count, data size and stripe size expected.");
+    DWORD count = (DWORD)args(0).array_value().elem(0);
+    DWORD size = (DWORD)args(1).array_value().elem(0);
+    DWORD stripe_size = (DWORD)args(2).array_value().elem(0);
+    if(!count || count > STRIPE_MAX_PIPES || !stripe_size)
+        error("Invalid pipes count or stripe size.");
+    
+    // test data
+    char *src = (char*)malloc(size);
+    char *dst = (char*)malloc(size);
+    if(!src || !dst)
+    {
+        free((void*)src);
+        free((void*)dst);
+        error("Not enough memory.");
+    }
+    for(DWORD k = 0; k < size; k++)
+        src[k] = (char)(k*2654435761u >> 24);
+    memset((void*)dst, 0, size);
+    
+    // create pipe instances and connect to them
+    HANDLE servers[STRIPE_MAX_PIPES];
+    HANDLE clients[STRIPE_MAX_PIPES];
+    for(DWORD k = 0; k < count; k++)
+    {
+        char name[64];
+        sprintf(name, "\\\\.\\pipe\\GOLPI_stripe_bench_%u_%u", (unsigned)GetCurrentProcessId(), (unsigned)k);
+        servers[k] = CreateNamedPipeA(name, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, BENCH_PIPE_BUF, BENCH_PIPE_BUF, 0, NULL);
+        clients[k] = OpenDataPipe(name);
+        if(servers[k] == INVALID_HANDLE_VALUE || clients[k] == INVALID_HANDLE_VALUE)
+        {
+            bench_close_pipes(servers, clients, k + 1);
+            free((void*)src);
+            free((void*)dst);
+            error("Cannot create benchmark pipes.");
+        }
+    }
+    
+    // measure both directions
+    double send_rate = bench_run(servers, clients, count, src, dst, size, stripe_size, true);
+    double receive_rate = bench_run(servers, clients, count, src, dst, size, stripe_size, false);
+    bool match = memcmp((void*)src, (void*)dst, size) == 0;
+    
+    bench_close_pipes(servers, clients, count);
+    free((void*)src);
+    free((void*)dst);
+    
+    if(send_rate < 0.0 || receive_rate < 0.0)
+        error("Benchmark transfer failed.");
+    if(!match)
+        error("Received data do not match.");
+    
+    res(0) = octave_value(send_rate);
+    res(1) = octave_value(receive_rate);
+    return res;
+}
+
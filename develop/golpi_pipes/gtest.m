@@ -1,5 +1,238 @@
+% Round-trip tests of GOLPI pipe interface and helpers without LabVIEW.
+% Build oct-files by make.m and install package by inst.m first.
+% Pipe tests use golpi_pipe_loop() peer that sends received data back.
 clear all;
 close all;
 clc;
 
-y = golpi_receive(3,5)
\ No newline at end of file
+tx_pipe = '\\.\pipe\GOLPI_test_tx';
+rx_pipe = '\\.\pipe\GOLPI_test_rx';
+
+% stop loop peer and check its ACK
+function loop_check(name)
+  if ~golpi_pipe_loop('stop')
+    error('Test ''%s'': loop peer did not get ACK!', name);
+  endif
+endfunction
+
+% compare variables including class and complexity
+function check(name, ref, out)
+  if ~isequal(ref, out) || ~strcmp(class(ref), class(out)) || iscomplex(ref) ~= iscomplex(out) || issparse(ref) ~= issparse(out)
+    error('Test ''%s'' failed!', name);
+  endif
+  printf('%-40s ok\n', name);
+endfunction
+
+% send variable to loop peer and receive it back
+function y = pipe_loop(tx_pipe, rx_pipe, x)
+  golpi_pipe_loop('start', tx_pipe, rx_pipe, 0);
+  golpi_pipe_send(tx_pipe, x);
+  y = golpi_pipe_receive(rx_pipe);
+  loop_check('pipe_loop');
+endfunction
+
+% decode bitstream printed by golpi_data2bits() to variable of class cls
+function [y, tok] = bits_decode(s, cls)
+  if ~strncmp(s, '_GpBiT_', 7) || s(end) ~= char(10)
+    error('Invalid bitstream!');
+  endif
+  bsz = hex2dec(s(8:9));
+  tok = hex2dec(s(10));
+  nd = hex2dec(s(11:18));
+  dims = hex2dec(reshape(s(19:18 + 8*nd), 8, nd)')';
+  s = double(s(19 + 8*nd:end-1));
+  if bitand(tok, 8)
+    % 8-bit coding: '=' prefixes escaped character
+    esc = find(s == '=');
+    s(esc + 1) = mod(s(esc + 1) - 64, 256);
+    s(esc) = [];
+    b = mod(s - 42, 256);
+  else
+    % 7-bit coding: 8 characters of 7 bits (lowest first) per 7 bytes
+    c = reshape(s - '0', 8, []);
+    bits = zeros(56, columns(c));
+    for k = 1:7
+      bits(k:7:end, :) = bitget(c, k);
+    endfor
+    b = (2.^(0:7))*reshape(bits, 8, []);
+  endif
+  if ~prod(dims)
+    y = reshape(feval(cls, []), dims);
+    return;
+  endif
+  % big endian elements
+  b = b(1:bsz*prod(dims));
+  b = uint8(reshape(flipud(reshape(b, bsz, [])), 1, []));
+  if strcmp(cls, 'char')
+    y = char(b);
+  else
+    y = typecast(b, cls);
+  endif
+  y = reshape(y, dims);
+endfunction
+
+
+% --- multiple variables in single exchange ---
+a = 5;
+b = [1 2 3; 4 5 6];
+c = 'test string';
+d = [];
+golpi_pipe_loop('start', tx_pipe, rx_pipe, 1);
+golpi_pipe_send_many(tx_pipe, 'a', 'b', 'c', 'd');
+vars = golpi_pipe_receive_many(rx_pipe);
+loop_check('send_many/receive_many');
+check('send_many/receive_many', struct('a', a, 'b', b, 'c', c, 'd', d), vars);
+clear a b c d vars;
+
+% --- lazy storage types are sent as full matrices ---
+x = 1:0.5:10;
+check('range', full(x), pipe_loop(tx_pipe, rx_pipe, x));
+x = diag([1 2 3]);
+check('diagonal matrix', full(x), pipe_loop(tx_pipe, rx_pipe, x));
+x = eye(4)(:,[2 4 1 3]);
+check('permutation matrix', full(x), pipe_loop(tx_pipe, rx_pipe, x));
+x = randn(300, 200);
+check('large matrix', x, pipe_loop(tx_pipe, rx_pipe, x));
+clear x;
+
+% --- all numeric types ---
+x = {int8([-128 0 127]), uint8([0 1 255]), int16([-32768; 32767]), uint16(65535), ...
+     int32([-5 6; 7 -8]), uint32(4e9), int64([-9223372036854775807 42]), uint64([18446744073709551615 1]), ...
+     single([1.5 -2.25]), complex(single(1), single(-2)), complex([1 2], [3 -4]), pi, ...
+     [true false; false true], 'text', ['ab'; 'cd'], zeros(0, 3), int32([])};
+for k = 1:numel(x)
+  check(sprintf('type %s %dx%d', class(x{k}), rows(x{k}), columns(x{k})), x{k}, pipe_loop(tx_pipe, rx_pipe, x{k}));
+endfor
+clear x;
+
+% --- chunked stream into preallocated variable ---
+x = randn(1000, 50);
+golpi_pipe_loop('start', tx_pipe, rx_pipe, 2);
+golpi_pipe_send(tx_pipe, x);
+h = golpi_stream_open(rx_pipe, 'double', size(x));
+[count, block] = golpi_stream_read(h, 1.0);
+if count < 1 || count > numel(x) || ~isequal(block, x(1:count)(:))
+  error('Test ''stream read'' failed!');
+endif
+y = golpi_stream_close(h, 10.0);
+loop_check('stream');
+check('stream', x, y);
+x = int16(reshape(1:600, 20, 30));
+golpi_pipe_loop('start', tx_pipe, rx_pipe, 2);
+golpi_pipe_send(tx_pipe, x);
+h = golpi_stream_open(rx_pipe, 'int16', size(x));
+y = golpi_stream_close(h, 10.0);
+loop_check('stream int16');
+check('stream int16', x, y);
+clear x y h count block;
+
+% --- cells and structs ---
+s = struct('a', 5, 'b', 'test', 'c', int32([1 2; 3 4]));
+x = {{1, 'str'; [], int8(-3)}, ...
+     {'one', 'two', 'three'}, ...
+     {'a'; ''; 'ccc'}, ...
+     s, ...
+     struct('x', {1, 'two', [3 4 5]}), ...
+     struct('sub', s, 'list', {{s, {1, {2, 'deep'}}}}), ...
+     {}, cell(2, 0), struct(), struct('a', {})};
+for k = 1:numel(x)
+  check(sprintf('%s %dx%d (%d)', class(x{k}), rows(x{k}), columns(x{k}), k), x{k}, pipe_loop(tx_pipe, rx_pipe, x{k}));
+endfor
+clear s x;
+
+% --- sparse matrices ---
+x = {sprandn(50, 40, 0.1), sparse([1 0; 0 2]) + 1i*sparse([0 3; 0 0]), sparse(logical([1 0 0; 0 0 1])), ...
+     sparse(10, 20), sparse([]), {sparse(eye(3)), 'with cell'}};
+for k = 1:numel(x)
+  check(sprintf('sparse %s %dx%d (%d)', class(x{k}), rows(x{k}), columns(x{k}), k), x{k}, pipe_loop(tx_pipe, rx_pipe, x{k}));
+endfor
+clear x;
+
+% --- striped transfer (peer checks data match), incl. partial last stripe ---
+for K = [1 2 3 8]
+  for size_bytes = [1 1000 65536*K + 123]
+    golpi_stripe_bench(K, size_bytes, 4096);
+  endfor
+  printf('%-40s ok\n', sprintf('striped transfer K = %d', K));
+endfor
+clear K size_bytes;
+
+% --- 7-bit bitstream: match reference and decode back ---
+x = {{[1:5], 6, 1}, {randn(1, 1001), 3, 1}, {single(randn(7, 13)), 3, 2}, {int16(randi([-1000 1000], 1, 77)), 1, 1}, ...
+     {uint32(randi([0 1e6], 5, 5)), 6, 2}, {'Hello GOLPI!', 5, 1}, {int64([-1 2^40]), 1, 1}, {zeros(0, 1), 3, 1}};
+for k = 1:numel(x)
+  t = x{k};
+  s = evalc('golpi_data2bits(t{1}, t{2}, t{3})');
+  if ~strcmp(s, evalc('golpi_data2bits_ref(t{1}, t{2}, t{3})'))
+    error('Test ''7-bit bitstream (%d)'': output does not match reference!', k);
+  endif
+  [y, tok] = bits_decode(s, class(t{1}));
+  if ~tok
+    error('Test ''7-bit bitstream (%d)'': type not accepted!', k);
+  endif
+  check(sprintf('7-bit bitstream %s %dx%d', class(t{1}), rows(t{1}), columns(t{1})), t{1}, y);
+endfor
+% wrong type and too many dimensions are marked by zero type
+s1 = evalc('golpi_data2bits(int8(1), 2, 1)');
+s2 = evalc('golpi_data2bits(ones(2), 3, 1)');
+if s1(10) ~= '0' || s2(10) ~= '0'
+  error('Test ''7-bit bitstream errors'' failed!');
+endif
+clear x t s s1 s2 y tok;
+
+% --- 8-bit bitstream: decode back, no NUL, LF, CR and ESC in data ---
+x = {uint8(0:255), randn(1, 1001), int32([-1 0 1 10 13 27]), single(randn(7, 13)), 'Hello GOLPI!', zeros(0, 1)};
+for k = 1:numel(x)
+  s = evalc('golpi_data2bits(x{k}, 6 - 1*ischar(x{k}), 2, 1)');
+  [y, tok] = bits_decode(s, class(x{k}));
+  if ~bitand(tok, 8) || any(ismember(s(1:end-1), char([0 10 13 27])))
+    error('Test ''8-bit bitstream (%d)'' failed!', k);
+  endif
+  check(sprintf('8-bit bitstream %s %dx%d', class(x{k}), rows(x{k}), columns(x{k})), x{k}, y);
+endfor
+clear x s y tok;
+
+% --- structure serializer matches reference ---
+s = struct('a', 5, 'b', 'test');
+x = {s, struct('i', int32([1 2; 3 4]), 'c', complex(randn(1, 4), randn(1, 4)), 'sub', s, 'cell', {{1, 'str', s}}), ...
+     'Hello GOLPI!', ['ab'; 'cd'], '', 5, {}, struct(), struct('nd', randn(2, 2, 2), 'empty', [])};
+for k = 1:numel(x)
+  check(sprintf('conv_struct (%d)', k), golpi_conv_struct_ref(x{k}), golpi_conv_struct(x{k}));
+endfor
+% structure array at top level is single unnamed array item, i.e. the same
+% as structure item holding the array, just without the name
+sa = struct('x', {1, 'two', [3 4 5]});
+sn.a = sa;
+y = golpi_conv_struct_ref(sn);
+y = [y(1:4); typecast(typecast(y(5:8), 'uint32') - 1, 'uint8')(:); uint8(0); y(11:end)];
+check('conv_struct array', y, golpi_conv_struct(sa));
+clear s x sa sn y;
+
+% --- memory mapped MAT-4 save/load ---
+file = [tempdir() 'golpi_gtest.mat'];
+s = struct('x', randn(3, 4), 'z', complex(randn(2, 5), randn(2, 5)), 't', ['ab'; 'cd'], 'e', [], 'v', (1:10)');
+golpi_mmap_save(file, s);
+check('mmap save/load', s, golpi_mmap_load(file));
+check('mmap load by name', s.z, golpi_mmap_load(file, 'z'));
+check('mmap save/generic load', s, load(file));
+golpi_mmap_save(file, 'y', s.x);
+check('mmap save by name', struct('y', s.x), golpi_mmap_load(file));
+% file of generic writer
+x = randn(5, 6);
+c = complex(1:3, -(1:3));
+save('-v4', file, 'x', 'c');
+check('mmap load generic file', struct('x', x, 'c', c), golpi_mmap_load(file));
+delete(file);
+clear file s x c;
+
+% --- tagged request markers ---
+s = evalc('golpi_dispatch(7, ''gtest_x = 5; disp(gtest_x + 1)'')');
+check('request markers', [char(27) 'GpRqB7' char(10) '6' char(10) char(27) 'GpRqE7 0' char(10)], s);
+s = evalc('golpi_dispatch(8, [''error(''''boom'''')'' char(10) ''disp(1)''])');
+if ~strncmp(s, [char(27) 'GpRqB8' char(10)], 7) || isempty(strfind(s, 'boom')) || ~strcmp(s(end-9:end), [char(27) 'GpRqE8 1' char(10)])
+  error('Test ''request failed command'' failed!');
+endif
+printf('%-40s ok\n', 'request failed command');
+clear s gtest_x;
+
+printf('All tests passed.\n');
@@ -4,5 +4,18 @@ clc;
 
 
 mkoctfile golpi_test.cpp
-mkoctfile golpi_pipe_receive.cpp golpi_pipe.cpp
-mkoctfile golpi_pipe_send.cpp golpi_pipe.cpp
\ No newline at end of file
+mkoctfile golpi_pipe_receive.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_pipe_send.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_pipe_receive_many.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile __golpi_pipe_send_many__.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile __golpi_stream__.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_pipe_send_striped.cpp golpi_pipe.cpp golpi_pipe_var.cpp golpi_pipe_stripe.cpp
+mkoctfile golpi_pipe_receive_striped.cpp golpi_pipe.cpp golpi_pipe_var.cpp golpi_pipe_stripe.cpp
+mkoctfile golpi_stripe_bench.cpp golpi_pipe.cpp golpi_pipe_var.cpp golpi_pipe_stripe.cpp
+mkoctfile golpi_pipe_loop.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_data2bits.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_conv_struct.cpp
+mkoctfile golpi_mmap_load.cpp golpi_mmap.cpp
+mkoctfile golpi_mmap_save.cpp golpi_mmap.cpp
+mkoctfile golpi_stdin_receive.cpp golpi_pipe.cpp golpi_pipe_var.cpp
+mkoctfile golpi_stdout_send.cpp golpi_pipe.cpp golpi_pipe_var.cpp
\ No newline at end of file
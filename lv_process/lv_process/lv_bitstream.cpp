@@ -0,0 +1,821 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - GOLPI Bitstream decoders
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Decoders of data streamed by GOLPI Octave package via process stdout (see golpi_data2bits()).
+// Decoding in the DLL is much faster than in LabVIEW G code.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <intrin.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// minimum decoded data size to split the decoding to threads [B]
+#define BS_MT_MIN_SIZE (50*1048576)
+// maximum decoder threads count
+#define BS_MT_MAX_THREADS 16
+
+// decoder thread job
+typedef struct{
+	const char *src; /*coded data of the job*/
+	char *dst; /*decoded data of the job*/
+	int groups; /*count of 8 character groups to unpack*/
+	int size; /*decoded bytes count to reverse (element aligned)*/
+	int elsize; /*element size*/
+	int ssse3; /*SSSE3 is available*/
+}TBSJob;
+
+
+//---------------------------------------------------------------------------
+// Parse hexadecimal number of 'len' digits, returns non-zero if invalid.
+//---------------------------------------------------------------------------
+static int bs_parse_hex(const char *str,int len,unsigned *value)
+{
+	unsigned v = 0;
+	for(int k = 0;k < len;k++)
+	{
+		char c = str[k];
+		if(c >= '0' && c <= '9')
+			v = (v << 4) | (c - '0');
+		else if(c >= 'A' && c <= 'F')
+			v = (v << 4) | (c - 'A' + 10);
+		else if(c >= 'a' && c <= 'f')
+			v = (v << 4) | (c - 'a' + 10);
+		else
+			return(1);
+	}
+	*value = v;
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Parse Bitstream header _GpBiT_(SS)(T)(NNNNNNNN)(SSSSSSS1)(SSSSSSS2)...
+//  *hdrlen: returns header size, or minimum size needed if header is incomplete
+//  *type: returns data type with coding flag cleared
+//  *elsize: returns element size [B]
+//  *coding_8bit: returns non-zero for 8-bit coding
+//  *dims: returns dimensions, up to 'maxdims' items (optional)
+//  *ndims: returns count of dimensions
+//  *len: returns decoded data size [B]
+// Returns LVP_EC_BS_INCOMPLETE if 'src' does not contain whole header yet.
+//---------------------------------------------------------------------------
+static int bs_parse_header(const char *src,int srclen,int *hdrlen,int *type,int *elsize,int *coding_8bit,int *dims,int maxdims,int *ndims,int *len)
+{
+	unsigned size,tok,dimn;
+	int pos = BS_HDR_ID_LEN + 2 + 1 + 8;
+	*hdrlen = pos;
+	if(srclen < pos)
+		return(LVP_EC_BS_INCOMPLETE);
+	if(memcmp(src,BS_HDR_ID,BS_HDR_ID_LEN) ||
+	   bs_parse_hex(&src[BS_HDR_ID_LEN],2,&size) || bs_parse_hex(&src[BS_HDR_ID_LEN + 2],1,&tok) ||
+	   bs_parse_hex(&src[BS_HDR_ID_LEN + 3],8,&dimn) || dimn > BS_MAX_DIMS)
+		return(LVP_EC_BS_HEADER);
+	*hdrlen = pos + 8*dimn;
+	if(srclen < *hdrlen)
+		return(LVP_EC_BS_INCOMPLETE);
+
+	unsigned __int64 count = 1;
+	for(unsigned k = 0;k < dimn;k++)
+	{
+		unsigned dim;
+		if(bs_parse_hex(&src[pos],8,&dim))
+			return(LVP_EC_BS_HEADER);
+		if(dims && (int)k < maxdims)
+			dims[k] = dim;
+		count *= dim;
+		if(count > 0x7FFFFFFFull)
+			return(LVP_EC_BS_HEADER);
+		pos += 8;
+	}
+	*coding_8bit = tok & 0x8;
+	tok &= 0x7;
+	if(!tok)
+		count = 0;
+	unsigned __int64 total = count*size;
+	if(total > 0x7FFFFFFFull)
+		return(LVP_EC_BS_HEADER);
+
+	*type = tok;
+	*elsize = size;
+	*ndims = dimn;
+	*len = (int)total;
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Check SSSE3 support of the CPU.
+//---------------------------------------------------------------------------
+static int bs_has_ssse3(void)
+{
+	int info[4];
+	__cpuid(info,1);
+	return((info[2] >> 9) & 1);
+}
+
+//---------------------------------------------------------------------------
+// Unpack one group of 8 characters to 7 bytes (56bit little endian word).
+//---------------------------------------------------------------------------
+static inline void bs_unpack7(const char *src,char *dst)
+{
+	unsigned __int64 x;
+	memcpy((void*)&x,(void*)src,8);
+	x -= 0x3030303030303030ull;
+	x = (x & 0x7Full) | ((x >> 1) & 0x3F80ull) | ((x >> 2) & 0x1FC000ull) | ((x >> 3) & 0xFE00000ull) |
+	    ((x >> 4) & 0x7F0000000ull) | ((x >> 5) & 0x3F800000000ull) | ((x >> 6) & 0x1FC0000000000ull) |
+	    ((x >> 7) & 0xFE000000000000ull);
+	memcpy((void*)dst,(void*)&x,7);
+}
+
+//---------------------------------------------------------------------------
+// Unpack groups of 8 characters to 7 bytes each.
+// SSSE3 path unpacks 2 groups at once, it stores 16 bytes per 14 decoded,
+// so it stops 3 groups before end to never write past the output.
+//---------------------------------------------------------------------------
+static void bs_unpack(const char *src,char *dst,int groups,int ssse3)
+{
+	int g = 0;
+	if(ssse3)
+	{
+		const __m128i offset = _mm_set1_epi8('0');
+		const __m128i m16 = _mm_set1_epi16(0x007F);
+		const __m128i m16h = _mm_set1_epi16(0x3F80);
+		const __m128i mul32 = _mm_set1_epi32(0x40000001);
+		const __m128i m64 = _mm_set_epi32(0,-1,0,-1);
+		const __m128i pack = _mm_setr_epi8(0,1,2,3,4,5,6,8,9,10,11,12,13,14,-1,-1);
+		for(;g + 3 <= groups;g += 2)
+		{
+			__m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)src),offset);
+			// 2x7 bits to 14 bits in 16bit words
+			v = _mm_or_si128(_mm_and_si128(v,m16),_mm_and_si128(_mm_srli_epi16(v,1),m16h));
+			// 2x14 bits to 28 bits in 32bit words
+			v = _mm_madd_epi16(v,mul32);
+			// 2x28 bits to 56 bits in 64bit words
+			v = _mm_or_si128(_mm_and_si128(v,m64),_mm_slli_epi64(_mm_srli_epi64(v,32),28));
+			// 2x7 bytes to 14 continuous bytes
+			_mm_storeu_si128((__m128i*)dst,_mm_shuffle_epi8(v,pack));
+			src += 16;
+			dst += 14;
+		}
+	}
+	for(;g < groups;g++)
+	{
+		bs_unpack7(src,dst);
+		src += 8;
+		dst += 7;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Reverse byte order of elements in place (big endian stream to native).
+//---------------------------------------------------------------------------
+static void bs_reverse(char *data,int size,int elsize,int ssse3)
+{
+	int k = 0;
+	if(ssse3 && (elsize == 2 || elsize == 4 || elsize == 8 || elsize == 16))
+	{
+		__m128i mask;
+		if(elsize == 2)
+			mask = _mm_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+		else if(elsize == 4)
+			mask = _mm_setr_epi8(3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12);
+		else if(elsize == 8)
+			mask = _mm_setr_epi8(7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8);
+		else
+			mask = _mm_setr_epi8(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0);
+		for(;k + 16 <= size;k += 16)
+			_mm_storeu_si128((__m128i*)&data[k],_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[k]),mask));
+	}
+	if(elsize < 2)
+		return;
+	for(;k + elsize <= size;k += elsize)
+		for(int i = 0;i < elsize/2;i++)
+		{
+			char c = data[k + i];
+			data[k + i] = data[k + elsize - 1 - i];
+			data[k + elsize - 1 - i] = c;
+		}
+}
+
+//---------------------------------------------------------------------------
+// Decoder thread: unpack and reverse one job.
+//---------------------------------------------------------------------------
+static DWORD WINAPI bs_decode_thread(LPVOID lpParam)
+{
+	TBSJob *job = (TBSJob*)lpParam;
+	bs_unpack(job->src,job->dst,job->groups,job->ssse3);
+	bs_reverse(job->dst,job->size,job->elsize,job->ssse3);
+	return(0);
+}
+
+
+//---------------------------------------------------------------------------
+// Decode complete Bitstream (see golpi_data2bits()) to typed data buffer.
+//  *src: stream data starting with '_GpBiT_' header (terminating '\n' optional)
+//  srclen: stream size [B]
+//  *dst: decoded data buffer (NULL to parse header only)
+//  dstlen: decoded data buffer size [B]
+//  *type: returns data type (T) of header with coding flag cleared (optional):
+//         0: error (variable not sent), 1: signed integer, 2: unsigned integer,
+//         3: real float, 4: complex float, 5: string
+//  *elsize: returns element size [B] (optional)
+//  *dims: returns dimensions, up to 'maxdims' items (optional)
+//  maxdims: size of 'dims' buffer
+//  *ndims: returns count of dimensions (optional)
+//  *dstret: returns decoded data size [B] (optional)
+//
+// Elements are returned in native (little endian) byte order. Complex elements
+// are returned as real and imaginary part pairs. Large data are decoded by
+// multiple threads.
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_decode(char *src,__int32 srclen,char *dst,__int32 dstlen,__int32 *type,__int32 *elsize,__int32 *dims,__int32 maxdims,__int32 *ndims,__int32 *dstret)
+{
+	// no buffers?
+	if(!src)
+		return(LVP_EC_NO_BUF);
+
+	// parse header
+	int pos,tok,size,dimn,len,coding_8bit;
+	if(bs_parse_header(src,srclen,&pos,&tok,&size,&coding_8bit,dims,maxdims,&dimn,&len))
+		return(LVP_EC_BS_HEADER);
+
+	if(type)
+		*type = tok;
+	if(elsize)
+		*elsize = size;
+	if(ndims)
+		*ndims = dimn;
+	if(dstret)
+		*dstret = len;
+
+	// header only?
+	if(!dst || !len)
+		return(0);
+	if(dstlen < len)
+		return(LVP_EC_BS_SMALL_BUF);
+
+	src += pos;
+	srclen -= pos;
+	int ssse3 = bs_has_ssse3();
+
+	if(coding_8bit)
+	{
+		// --- 8-bit coding ---
+		__int32 decoded;
+		proc_bitstream_decode_8bit(src,srclen,dst,len,&decoded,NULL);
+		if(decoded < len)
+			return(LVP_EC_BS_INCOMPLETE);
+		bs_reverse(dst,len,size,ssse3);
+		return(0);
+	}
+
+	// --- 7-bit coding ---
+	int groups = len/7;
+	int tail = len%7;
+	if(srclen/8 < groups + (tail > 0))
+		return(LVP_EC_BS_INCOMPLETE);
+
+	// incomplete last group
+	if(tail)
+	{
+		char last[8];
+		bs_unpack7(&src[8*groups],last);
+		memcpy((void*)&dst[7*groups],(void*)last,tail);
+	}
+
+	// split to jobs (multiples of 16 groups are aligned to element sizes 1, 2, 4, 8 and 16)
+	int threads = 1;
+	if(len >= BS_MT_MIN_SIZE && (7*16)%size == 0)
+	{
+		SYSTEM_INFO si;
+		GetSystemInfo(&si);
+		threads = min((int)si.dwNumberOfProcessors,BS_MT_MAX_THREADS);
+	}
+	TBSJob job[BS_MT_MAX_THREADS];
+	HANDLE th[BS_MT_MAX_THREADS];
+	int chunk = (groups/threads + 15) & ~15;
+	int g = 0;
+	for(int k = 0;k < threads;k++)
+	{
+		job[k].src = &src[8*g];
+		job[k].dst = &dst[7*g];
+		job[k].groups = (k == threads - 1)?(groups - g):min(chunk,groups - g);
+		job[k].size = (k == threads - 1)?(len - 7*g):(7*job[k].groups);
+		job[k].elsize = size;
+		job[k].ssse3 = ssse3;
+		g += job[k].groups;
+	}
+
+	// run jobs (first one in this thread, the rest in own threads if possible)
+	for(int k = 1;k < threads;k++)
+	{
+		th[k] = CreateThread(NULL,0,bs_decode_thread,(PVOID)&job[k],0,NULL);
+		if(!th[k])
+			bs_decode_thread((PVOID)&job[k]);
+	}
+	bs_decode_thread((PVOID)&job[0]);
+	for(int k = 1;k < threads;k++)
+		if(th[k])
+		{
+			WaitForSingleObject(th[k],INFINITE);
+			CloseHandle(th[k]);
+		}
+
+	return(0);
+}
+
+
+//---------------------------------------------------------------------------
+// Decode 8-bit coded Bitstream data (see golpi_data2bits()).
+//  *src: coded data (without '_GpBiT_' header and terminating '\n')
+//  srclen: coded data size [B]
+//  *dst: decoded data buffer
+//  dstlen: decoded data buffer size [B]
+//  *dstret: returns decoded bytes count (optional)
+//  *used: returns processed coded bytes count (optional)
+//
+// Coded characters NUL, LF, CR, ESC and '=' are always escaped, so the coded
+// data never contain line ends nor ESC frame/request markers.
+// Decoding stops when 'dst' is full or before incomplete escape sequence at the
+// end of 'src', so the rest can be decoded by next call.
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_decode_8bit(char *src,__int32 srclen,char *dst,__int32 dstlen,__int32 *dstret,__int32 *used)
+{
+	// no buffers?
+	if(!src || !dst)
+		return(LVP_EC_NO_BUF);
+
+	int s = 0;
+	int d = 0;
+
+	// blocks of 16 bytes are decoded at once up to first escape character
+	const __m128i offset = _mm_set1_epi8(BS_ESC_OFFSET);
+	const __m128i esc = _mm_set1_epi8(BS_ESC_CHAR);
+	while(s + 16 <= srclen && d + 16 <= dstlen)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)&src[s]);
+		_mm_storeu_si128((__m128i*)&dst[d],_mm_sub_epi8(v,offset));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v,esc));
+		if(!mask)
+		{
+			s += 16;
+			d += 16;
+			continue;
+		}
+
+		// escape found: keep decoded bytes before it
+		unsigned long pos;
+		_BitScanForward(&pos,mask);
+		s += pos;
+		d += pos;
+
+		// decode escape sequence
+		if(s + 1 >= srclen)
+			break;
+		dst[d++] = (char)(src[s + 1] - BS_ESC_SHIFT - BS_ESC_OFFSET);
+		s += 2;
+	}
+
+	// rest
+	while(s < srclen && d < dstlen)
+	{
+		if(src[s] == BS_ESC_CHAR)
+		{
+			// escape sequence (wait for next call if incomplete)
+			if(s + 1 >= srclen)
+				break;
+			dst[d++] = (char)(src[s + 1] - BS_ESC_SHIFT - BS_ESC_OFFSET);
+			s += 2;
+		}
+		else
+			dst[d++] = (char)(src[s++] - BS_ESC_OFFSET);
+	}
+
+	if(dstret)
+		*dstret = d;
+	if(used)
+		*used = s;
+
+	return(0);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: allocate/initialize
+//---------------------------------------------------------------------------
+TLVPBitstream *bs_alloc(void)
+{
+	TLVPBitstream *bs = (TLVPBitstream*)malloc(sizeof(TLVPBitstream));
+	if(!bs)
+		return(NULL);
+	memset((void*)bs,0,sizeof(TLVPBitstream));
+
+	// completion event (manual reset, cleared by arming)
+	bs->done = CreateEvent(NULL,true,false,NULL);
+	if(!bs->done)
+	{
+		free((void*)bs);
+		return(NULL);
+	}
+	bs->state = BS_STATE_IDLE;
+	bs->ssse3 = bs_has_ssse3();
+	InitializeCriticalSection(&bs->cs);
+
+	return(bs);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: loose receiver and its data
+//---------------------------------------------------------------------------
+void bs_free(TLVPBitstream *bs)
+{
+	if(!bs)
+		return;
+	if(bs->data)
+		free((void*)bs->data);
+	CloseHandle(bs->done);
+	DeleteCriticalSection(&bs->cs);
+	free((void*)bs);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: discard data and set new state (call inside critical section)
+//---------------------------------------------------------------------------
+static void bs_reset(TLVPBitstream *bs,int state)
+{
+	if(bs->data)
+		free((void*)bs->data);
+	bs->data = NULL;
+	bs->state = state;
+	bs->error = 0;
+	bs->hdr_len = 0;
+	bs->hdr_size = BS_HDR_ID_LEN;
+	bs->len = 0;
+	bs->filled = 0;
+	bs->part_len = 0;
+	ResetEvent(bs->done);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: finish receive (call inside critical section)
+//---------------------------------------------------------------------------
+static void bs_finish(TLVPBitstream *bs,int error)
+{
+	if(error)
+	{
+		if(bs->data)
+			free((void*)bs->data);
+		bs->data = NULL;
+		bs->state = BS_STATE_ERROR;
+		bs->error = error;
+	}
+	else
+	{
+		bs_reverse(bs->data,bs->len,bs->elsize,bs->ssse3);
+		bs->state = BS_STATE_READY;
+		bs->skip_lf = 1;
+	}
+	SetEvent(bs->done);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: decode data part of stream, returns processed bytes count
+// (call inside critical section)
+//---------------------------------------------------------------------------
+static int bs_stream_data(TLVPBitstream *bs,const char *src,int len)
+{
+	int pos = 0;
+	if(bs->coding_8bit)
+	{
+		// --- 8-bit coding ---
+		if(bs->part_len && len)
+		{
+			// finish escape sequence split between reads
+			bs->data[bs->filled++] = (char)(src[pos++] - BS_ESC_SHIFT - BS_ESC_OFFSET);
+			bs->part_len = 0;
+		}
+		__int32 decoded = 0;
+		__int32 used = 0;
+		if(bs->filled < bs->len && pos < len)
+			proc_bitstream_decode_8bit((char*)&src[pos],len - pos,&bs->data[bs->filled],bs->len - bs->filled,&decoded,&used);
+		bs->filled += decoded;
+		pos += used;
+		if(bs->filled < bs->len && pos < len)
+		{
+			// incomplete escape sequence at the end
+			bs->part_len = 1;
+			pos++;
+		}
+	}
+	else
+	{
+		// --- 7-bit coding ---
+		while(pos < len && bs->filled < bs->len)
+		{
+			int rest = bs->len - bs->filled;
+			if(bs->part_len || len - pos < 8 || rest < 7)
+			{
+				// collect incomplete group
+				int n = min(8 - bs->part_len,len - pos);
+				memcpy((void*)&bs->part[bs->part_len],(void*)&src[pos],n);
+				bs->part_len += n;
+				pos += n;
+				if(bs->part_len < 8)
+					break;
+				char grp[8];
+				bs_unpack7(bs->part,grp);
+				memcpy((void*)&bs->data[bs->filled],(void*)grp,min(7,rest));
+				bs->filled += min(7,rest);
+				bs->part_len = 0;
+			}
+			else
+			{
+				// complete groups directly to data buffer
+				int groups = min((len - pos)/8,rest/7);
+				bs_unpack(&src[pos],&bs->data[bs->filled],groups,bs->ssse3);
+				pos += 8*groups;
+				bs->filled += 7*groups;
+			}
+		}
+	}
+
+	if(bs->filled >= bs->len)
+		bs_finish(bs,0);
+
+	return(pos);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: process data read from stdout by readout thread.
+// Armed bitstream is decoded, the rest of data is copied to 'text' buffer
+// (size 'len' + BS_HDR_ID_LEN), returns size of 'text' data or -1 if nothing
+// was decoded and whole 'buf' is text.
+//---------------------------------------------------------------------------
+int bs_stream_process(TLVPBitstream *bs,char *buf,int len,char *text)
+{
+	if(!bs)
+		return(-1);
+
+	EnterCriticalSection(&bs->cs);
+
+	if(bs->state != BS_STATE_ARMED && bs->state != BS_STATE_HEADER && bs->state != BS_STATE_DATA && !bs->skip_lf)
+	{
+		LeaveCriticalSection(&bs->cs);
+		return(-1);
+	}
+
+	int pos = 0;
+	int tlen = 0;
+	while(pos < len)
+	{
+		if(bs->skip_lf)
+		{
+			// skip stream terminator
+			bs->skip_lf = 0;
+			if(buf[pos] == '\n')
+				pos++;
+		}
+		else if(bs->state == BS_STATE_ARMED)
+		{
+			// --- search for header ID ---
+			if(!bs->hdr_len)
+			{
+				// pass text up to first ID character at once
+				char *id = (char*)memchr((void*)&buf[pos],BS_HDR_ID[0],len - pos);
+				int n = id?(int)(id - &buf[pos]):(len - pos);
+				memcpy((void*)&text[tlen],(void*)&buf[pos],n);
+				tlen += n;
+				pos += n;
+				if(pos >= len)
+					break;
+			}
+			char c = buf[pos++];
+			if(c == BS_HDR_ID[bs->hdr_len])
+			{
+				bs->hdr[bs->hdr_len++] = c;
+				if(bs->hdr_len == BS_HDR_ID_LEN)
+					bs->state = BS_STATE_HEADER;
+				continue;
+			}
+			// not a header: return partially matched ID to text
+			memcpy((void*)&text[tlen],(void*)bs->hdr,bs->hdr_len);
+			tlen += bs->hdr_len;
+			bs->hdr_len = 0;
+			if(c == BS_HDR_ID[0])
+				bs->hdr[bs->hdr_len++] = c;
+			else
+				text[tlen++] = c;
+		}
+		else if(bs->state == BS_STATE_HEADER)
+		{
+			// --- receive header ---
+			int n = min(bs->hdr_size - bs->hdr_len,len - pos);
+			memcpy((void*)&bs->hdr[bs->hdr_len],(void*)&buf[pos],n);
+			bs->hdr_len += n;
+			pos += n;
+			if(bs->hdr_len < bs->hdr_size)
+				continue;
+			int ret = bs_parse_header(bs->hdr,bs->hdr_len,&bs->hdr_size,&bs->type,&bs->elsize,&bs->coding_8bit,bs->dims,BS_MAX_DIMS,&bs->ndims,&bs->len);
+			if(ret == LVP_EC_BS_INCOMPLETE)
+				continue;
+			if(ret)
+				bs_finish(bs,ret);
+			else if(!bs->len)
+				bs_finish(bs,0);
+			else
+			{
+				// allocate data buffer
+				bs->data = (char*)malloc(bs->len);
+				if(bs->data)
+					bs->state = BS_STATE_DATA;
+				else
+					bs_finish(bs,LVP_EC_BS_ALLOC);
+			}
+		}
+		else if(bs->state == BS_STATE_DATA)
+		{
+			// --- receive data ---
+			pos += bs_stream_data(bs,&buf[pos],len - pos);
+		}
+		else
+		{
+			// --- other text ---
+			memcpy((void*)&text[tlen],(void*)&buf[pos],len - pos);
+			tlen += len - pos;
+			pos = len;
+		}
+	}
+
+	LeaveCriticalSection(&bs->cs);
+
+	return(tlen);
+}
+
+//---------------------------------------------------------------------------
+// Bitstream receiver: minimum count of stream bytes still expected on stdout
+// (these are not passed to stdout fifo, so they can be read even if it is full)
+//---------------------------------------------------------------------------
+int bs_read_limit(TLVPBitstream *bs)
+{
+	if(!bs)
+		return(0);
+
+	EnterCriticalSection(&bs->cs);
+	int len = 0;
+	if(bs->state == BS_STATE_HEADER)
+		len = bs->hdr_size - bs->hdr_len;
+	else if(bs->state == BS_STATE_DATA && bs->coding_8bit)
+		len = bs->len - bs->filled - bs->part_len;
+	else if(bs->state == BS_STATE_DATA)
+		len = (bs->len - bs->filled + 6)/7*8 - bs->part_len;
+	LeaveCriticalSection(&bs->cs);
+
+	return(len);
+}
+
+
+//---------------------------------------------------------------------------
+// Arm receiving of Bitstream by stdout readout thread. Next '_GpBiT_' stream
+// appearing on stdout is decoded on the fly to separate data buffer instead
+// of passing it to stdout fifo. Other stdout data are passed as usual.
+// Previously received and not fetched data are discarded.
+//  *proc: lv process instance handle
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_arm(TLVPHndl *proc)
+{
+	if(!proc || !proc->fifo || !proc->fifo->bs)
+		return(LVP_EC_NO_PROC);
+
+	TLVPBitstream *bs = proc->fifo->bs;
+	EnterCriticalSection(&bs->cs);
+	bs_reset(bs,BS_STATE_ARMED);
+	bs->skip_lf = 0;
+	LeaveCriticalSection(&bs->cs);
+
+	debug_printf(proc,"bitstream receive armed\n");
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Cancel armed Bitstream receive and discard its data.
+//  *proc: lv process instance handle
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_disarm(TLVPHndl *proc)
+{
+	if(!proc || !proc->fifo || !proc->fifo->bs)
+		return(LVP_EC_NO_PROC);
+
+	TLVPBitstream *bs = proc->fifo->bs;
+	EnterCriticalSection(&bs->cs);
+	bs_reset(bs,BS_STATE_IDLE);
+	LeaveCriticalSection(&bs->cs);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Wait for armed Bitstream receive.
+//  *proc: lv process instance handle
+//  timeout: timeout in ms (0 to poll)
+//  *type: returns data type (T) of header with coding flag cleared (optional)
+//  *elsize: returns element size [B] (optional)
+//  *dims: returns dimensions, up to 'maxdims' items (optional)
+//  maxdims: size of 'dims' buffer
+//  *ndims: returns count of dimensions (optional)
+//  *size: returns decoded data size [B] (optional)
+//
+// Returns LVP_EC_TIMEOUT if stream was not received yet.
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_wait(TLVPHndl *proc,__int32 timeout,__int32 *type,__int32 *elsize,__int32 *dims,__int32 maxdims,__int32 *ndims,__int32 *size)
+{
+	if(!proc || !proc->fifo || !proc->fifo->bs)
+		return(LVP_EC_NO_PROC);
+
+	TLVPBitstream *bs = proc->fifo->bs;
+	if(bs->state == BS_STATE_IDLE)
+		return(LVP_EC_BS_NOT_ARMED);
+
+	// wait for decoder
+	if(WaitForSingleObject(bs->done,timeout) != WAIT_OBJECT_0)
+		return(LVP_EC_TIMEOUT);
+
+	EnterCriticalSection(&bs->cs);
+	int ret = 0;
+	if(bs->state == BS_STATE_READY)
+	{
+		if(type)
+			*type = bs->type;
+		if(elsize)
+			*elsize = bs->elsize;
+		for(int k = 0;dims && k < bs->ndims && k < maxdims;k++)
+			dims[k] = bs->dims[k];
+		if(ndims)
+			*ndims = bs->ndims;
+		if(size)
+			*size = bs->len;
+	}
+	else if(bs->state == BS_STATE_ERROR)
+		ret = bs->error;
+	else
+		ret = LVP_EC_BS_NOT_ARMED;
+	LeaveCriticalSection(&bs->cs);
+
+	return(ret);
+}
+
+//---------------------------------------------------------------------------
+// Fetch decoded data of received Bitstream (see proc_bitstream_wait()) and
+// disarm the receive. Elements are in native (little endian) byte order.
+//  *proc: lv process instance handle
+//  *dst: decoded data buffer
+//  dstlen: decoded data buffer size [B]
+//  *dstret: returns decoded data size [B] (optional)
+//---------------------------------------------------------------------------
+__int32 proc_bitstream_fetch(TLVPHndl *proc,char *dst,__int32 dstlen,__int32 *dstret)
+{
+	if(dstret)
+		*dstret = 0;
+
+	if(!proc || !proc->fifo || !proc->fifo->bs)
+		return(LVP_EC_NO_PROC);
+
+	TLVPBitstream *bs = proc->fifo->bs;
+	EnterCriticalSection(&bs->cs);
+
+	int ret = 0;
+	if(bs->state == BS_STATE_ERROR)
+		ret = bs->error;
+	else if(bs->state != BS_STATE_READY)
+		ret = (bs->state == BS_STATE_IDLE)?LVP_EC_BS_NOT_ARMED:LVP_EC_BS_INCOMPLETE;
+	else if(bs->len && !dst)
+		ret = LVP_EC_NO_BUF;
+	else if(dstlen < bs->len)
+		ret = LVP_EC_BS_SMALL_BUF;
+	if(ret)
+	{
+		LeaveCriticalSection(&bs->cs);
+		return(ret);
+	}
+
+	// return data and disarm
+	if(bs->len)
+		memcpy((void*)dst,(void*)bs->data,bs->len);
+	if(dstret)
+		*dstret = bs->len;
+	bs_reset(bs,BS_STATE_IDLE);
+
+	LeaveCriticalSection(&bs->cs);
+
+	debug_printf(proc,"bitstream fetched\n");
+
+	return(0);
+}
@@ -0,0 +1,570 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - GOLPI binary frames
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Binary transfer of variables via the stdin/stdout pipes of the process, for installations where the named
+// pipes of GOLPI cannot be used. Variable is sent as single length prefixed frame to golpi_stdin_receive(), which
+// reads it from its stdin directly into the destination variable, so no ASCII formatting is involved.
+// Opposite direction uses frames written to stdout by golpi_stdout_send(). The stdout readout thread splits
+// the frames from the text to separate message queue, so the text still goes to the stdout fifo.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <stdio.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// size of command for golpi_stdin_receive()
+#define FRAME_CMD_LEN 128
+// initial allocation of received message [B]
+#define FRAME_MSG_MIN_SIZE 65536
+// maximum wait interval of proc_frame_wait(), so the readout thread is woken periodically
+#define FRAME_WAIT_SLICE 50
+
+
+//---------------------------------------------------------------------------
+// Write whole buffer to stdin pipe (no copy to console).
+//---------------------------------------------------------------------------
+static int frame_write(TLVPHndl *proc,const char *data,DWORD size)
+{
+	while(size)
+	{
+		DWORD wrt;
+		if(!WriteFile(proc->pinp[0],(void*)data,size,&wrt,NULL))
+			return(LVP_EC_WRITE_FAIL);
+		if(proc->fifo)
+			proc->fifo->c_stdin_bytes += wrt;
+		data += wrt;
+		size -= wrt;
+	}
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Wait for FRAME_READY mark in stdout. Text up to the mark is dropped.
+//---------------------------------------------------------------------------
+static int frame_wait_ready(TLVPHndl *proc,int timeout)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER t_start;
+	QueryPerformanceCounter(&t_start);
+
+	// keeps end of previous read, so the mark split between reads is found
+	char buf[FRAME_READY_LEN - 1 + 1024];
+	int used = 0;
+	do{
+		SetEvent(proc->rd_event);
+		int read = 0;
+		fifo_read(proc,&buf[used],sizeof(buf) - used,&read);
+		used += read;
+		for(int k = 0;k + FRAME_READY_LEN <= used;k++)
+			if(!memcmp((void*)&buf[k],(void*)FRAME_READY,FRAME_READY_LEN))
+				return(0);
+		if(used >= FRAME_READY_LEN)
+		{
+			memmove((void*)buf,(void*)&buf[used - FRAME_READY_LEN + 1],FRAME_READY_LEN - 1);
+			used = FRAME_READY_LEN - 1;
+		}
+
+		if(!read)
+		{
+			// process returned?
+			DWORD ec;
+			if(GetExitCodeProcess(proc->hproc,&ec) && ec != STILL_ACTIVE)
+				return(LVP_EC_EXITED);
+
+			LARGE_INTEGER t_new;
+			QueryPerformanceCounter(&t_new);
+			if(time_get_ms(&t_start,&t_new,&freq) >= timeout)
+				return(LVP_EC_FRAME_NOT_READY);
+			Sleep(1);
+		}
+	}while(1);
+}
+
+
+//---------------------------------------------------------------------------
+// Send variable to GOLPI via stdin pipe as binary frame. Function writes
+// command "name=golpi_stdin_receive(timeout);\n", waits till Octave is ready
+// and writes the frame. Stdout FIFO is cleared. Caller then reads stdout
+// for "GOLPImark" as usual.
+//  *proc: lv process instance handle
+//  *name: variable name (null terminated string)
+//  type: variable type id of GOLPI (VTYPE_xxx, see golpi_pipe.hpp)
+//  rows: rows count
+//  cols: columns count
+//  *data: variable data in GOLPI variable record format (column-major)
+//  size: data size [B]
+//  timeout: timeout of Octave response and of the transfer [ms]
+//  *written: returns total bytes written to stdin (optional)
+//---------------------------------------------------------------------------
+__int32 proc_write_binary_frame(TLVPHndl *proc,char *name,__int32 type,__int32 rows,__int32 cols,char *data,__int32 size,__int32 timeout,__int32 *written)
+{
+	if(written)
+		*written = 0;
+	if(!proc || !proc->hproc || !proc->pinp[0] || !proc->rd_event)
+		return(LVP_EC_NO_PROC);
+	if(num_check_name(name) || rows < 0 || cols < 0)
+		return(LVP_EC_NUM_NAME);
+	if(size < 0 || size > 0x7FFFFFFF - FRAME_REC_HEAD_SIZE)
+		return(LVP_EC_FRAME_SIZE);
+	if(!data && size)
+		return(LVP_EC_NO_BUF);
+
+	debug_printf(proc,"sending binary frame '%s' (%dB)\n",name,size);
+
+	// start receiver
+	fifo_clear(proc);
+	char cmd[FRAME_CMD_LEN];
+	int len = sprintf_s(cmd,FRAME_CMD_LEN,"%s=golpi_stdin_receive(%.3f);\n",name,0.001*timeout);
+	int wrt = 0;
+	int ret = proc_write_stdin(proc,cmd,len,&wrt);
+	if(ret)
+		return(ret);
+	if(wrt != len)
+		return(LVP_EC_WRITE_INCOMPLETE);
+
+	// frame can be sent only when Octave reads it, else its command reader could take part of it
+	ret = frame_wait_ready(proc,timeout);
+	if(ret)
+		return(ret);
+
+	// frame header and variable record header
+	char head[FRAME_HEAD_SIZE + FRAME_REC_HEAD_SIZE];
+	DWORD rec[4] = {(DWORD)(FRAME_REC_HEAD_SIZE + size),(DWORD)type,(DWORD)rows,(DWORD)cols};
+	memcpy((void*)head,(void*)FRAME_ID,FRAME_ID_LEN);
+	memcpy((void*)&head[FRAME_ID_LEN],(void*)rec,sizeof(rec));
+	ret = frame_write(proc,head,sizeof(head));
+	if(!ret)
+		ret = frame_write(proc,data,size);
+	if(ret)
+		return(ret);
+	if(written)
+		*written = len + sizeof(head) + size;
+
+	// just a note to the console, data are binary
+	if(proc->cout && proc->fifo)
+	{
+		char note[64];
+		int nlen = sprintf_s(note,sizeof(note),"[binary frame %dB]\n",size);
+		EnterCriticalSection(&proc->fifo->cs);
+		SetConsoleTextAttribute(proc->cout,proc->clr_in);
+		WriteConsoleA(proc->cout,(void*)note,nlen,NULL,NULL);
+		LeaveCriticalSection(&proc->fifo->cs);
+	}
+
+	return(0);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: allocate and init receiver
+//---------------------------------------------------------------------------
+TLVPFrameRx *frame_rx_alloc(void)
+{
+	TLVPFrameRx *fr = (TLVPFrameRx*)malloc(sizeof(TLVPFrameRx));
+	if(!fr)
+		return(NULL);
+	memset((void*)fr,0,sizeof(TLVPFrameRx));
+
+	// arrival condition (each waiter checks the queue for its channel)
+	InitializeConditionVariable(&fr->arrived);
+	fr->state = FRAME_STATE_IDLE;
+	InitializeCriticalSection(&fr->cs);
+
+	return(fr);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: loose message
+//---------------------------------------------------------------------------
+static void frame_msg_free(TLVPFrameMsg *msg)
+{
+	if(!msg)
+		return;
+	if(msg->data)
+		free((void*)msg->data);
+	free((void*)msg);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: loose receiver and all its messages
+//---------------------------------------------------------------------------
+void frame_rx_free(TLVPFrameRx *fr)
+{
+	if(!fr)
+		return;
+	frame_msg_free(fr->msg);
+	while(fr->first)
+	{
+		TLVPFrameMsg *next = fr->first->next;
+		frame_msg_free(fr->first);
+		fr->first = next;
+	}
+	DeleteCriticalSection(&fr->cs);
+	free((void*)fr);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: discard message being received (call inside critical section)
+//---------------------------------------------------------------------------
+static void frame_drop(TLVPFrameRx *fr,int error)
+{
+	frame_msg_free(fr->msg);
+	fr->msg = NULL;
+	fr->drop = 1;
+	fr->error = error;
+	WakeAllConditionVariable(&fr->arrived);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: start frame data after received header (call inside critical section)
+//---------------------------------------------------------------------------
+static void frame_start(TLVPFrameRx *fr)
+{
+	int channel = (unsigned char)fr->hdr[FRAME_OUT_ID_LEN];
+	fr->flags = (unsigned char)fr->hdr[FRAME_OUT_ID_LEN + 1];
+	DWORD size;
+	memcpy((void*)&size,(void*)&fr->hdr[FRAME_OUT_ID_LEN + 2],sizeof(DWORD));
+	fr->hdr_len = 0;
+	fr->remain = (int)min(size,0x7FFFFFFF);
+	fr->state = FRAME_STATE_DATA;
+
+	// frame of other channel in the middle of message: previous one is incomplete
+	if(fr->msg && fr->msg->channel != channel)
+		frame_drop(fr,LVP_EC_FRAME_DISCARDED);
+	if(!fr->msg && !fr->drop)
+	{
+		fr->msg = (TLVPFrameMsg*)malloc(sizeof(TLVPFrameMsg));
+		if(fr->msg)
+		{
+			memset((void*)fr->msg,0,sizeof(TLVPFrameMsg));
+			fr->msg->channel = channel;
+		}
+		else
+			frame_drop(fr,LVP_EC_FRAME_ALLOC);
+	}
+
+	// make space for frame data
+	TLVPFrameMsg *msg = fr->msg;
+	if(msg && size > (DWORD)(0x7FFFFFFF - msg->size))
+		frame_drop(fr,LVP_EC_FRAME_ALLOC);
+	else if(msg && msg->size + (int)size > msg->cap)
+	{
+		__int64 cap = max(msg->cap,FRAME_MSG_MIN_SIZE);
+		while(cap < msg->size + (__int64)size)
+			cap *= 2;
+		cap = min(cap,0x7FFFFFFF);
+		char *data = (char*)realloc((void*)msg->data,(size_t)cap);
+		if(data)
+		{
+			msg->data = data;
+			msg->cap = (int)cap;
+		}
+		else
+			frame_drop(fr,LVP_EC_FRAME_ALLOC);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: finish frame, queue complete message (call inside critical section)
+//---------------------------------------------------------------------------
+static void frame_end(TLVPFrameRx *fr)
+{
+	fr->state = FRAME_STATE_IDLE;
+	if(!(fr->flags & FRAME_FLAG_LAST))
+		return;
+
+	if(fr->flags & FRAME_FLAG_ERROR)
+		frame_drop(fr,LVP_EC_FRAME_DISCARDED);
+	if(fr->msg)
+	{
+		fr->msg->next = NULL;
+		if(fr->last)
+			fr->last->next = fr->msg;
+		else
+			fr->first = fr->msg;
+		fr->last = fr->msg;
+		fr->msg = NULL;
+		WakeAllConditionVariable(&fr->arrived);
+	}
+	fr->drop = 0;
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: split frames from stdout data. Text without frames
+// is stored to 'text' buffer, which must be FRAME_OUT_ID_LEN bytes larger than
+// 'len'. Returns text length or -1 if the data contain no frame, so they can
+// be passed as they are.
+//---------------------------------------------------------------------------
+int frame_stream_process(TLVPFrameRx *fr,char *buf,int len,char *text)
+{
+	if(!fr)
+		return(-1);
+
+	EnterCriticalSection(&fr->cs);
+
+	// fast path: plain text
+	if(fr->state == FRAME_STATE_IDLE && !fr->hdr_len && !memchr((void*)buf,FRAME_OUT_ID[0],len))
+	{
+		LeaveCriticalSection(&fr->cs);
+		return(-1);
+	}
+
+	int pos = 0;
+	int tlen = 0;
+	while(pos < len)
+	{
+		if(fr->state == FRAME_STATE_IDLE)
+		{
+			// --- search for start mark ---
+			if(!fr->hdr_len)
+			{
+				// pass text up to first mark character at once
+				char *id = (char*)memchr((void*)&buf[pos],FRAME_OUT_ID[0],len - pos);
+				int n = id?(int)(id - &buf[pos]):(len - pos);
+				memcpy((void*)&text[tlen],(void*)&buf[pos],n);
+				tlen += n;
+				pos += n;
+				if(pos >= len)
+					break;
+			}
+			char c = buf[pos++];
+			if(c == FRAME_OUT_ID[fr->hdr_len])
+			{
+				fr->hdr[fr->hdr_len++] = c;
+				if(fr->hdr_len == FRAME_OUT_ID_LEN)
+					fr->state = FRAME_STATE_HEADER;
+				continue;
+			}
+			// not a frame: return partially matched mark to text
+			memcpy((void*)&text[tlen],(void*)fr->hdr,fr->hdr_len);
+			tlen += fr->hdr_len;
+			fr->hdr_len = 0;
+			if(c == FRAME_OUT_ID[0])
+				fr->hdr[fr->hdr_len++] = c;
+			else
+				text[tlen++] = c;
+		}
+		else if(fr->state == FRAME_STATE_HEADER)
+		{
+			// --- receive header ---
+			int n = min(FRAME_OUT_HEAD_SIZE - fr->hdr_len,len - pos);
+			memcpy((void*)&fr->hdr[fr->hdr_len],(void*)&buf[pos],n);
+			fr->hdr_len += n;
+			pos += n;
+			if(fr->hdr_len < FRAME_OUT_HEAD_SIZE)
+				break;
+			frame_start(fr);
+			if(!fr->remain)
+				frame_end(fr);
+		}
+		else
+		{
+			// --- receive data directly to message ---
+			int n = min(fr->remain,len - pos);
+			if(fr->msg)
+			{
+				memcpy((void*)&fr->msg->data[fr->msg->size],(void*)&buf[pos],n);
+				fr->msg->size += n;
+			}
+			fr->remain -= n;
+			pos += n;
+			if(!fr->remain)
+				frame_end(fr);
+		}
+	}
+
+	LeaveCriticalSection(&fr->cs);
+
+	return(tlen);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: bytes count of frame being received, which may be
+// read from stdout even if stdout fifo is full
+//---------------------------------------------------------------------------
+int frame_read_limit(TLVPFrameRx *fr)
+{
+	if(!fr)
+		return(0);
+
+	EnterCriticalSection(&fr->cs);
+	int len = 0;
+	if(fr->state == FRAME_STATE_HEADER)
+		len = FRAME_OUT_HEAD_SIZE - fr->hdr_len;
+	else if(fr->state == FRAME_STATE_DATA)
+		len = fr->remain;
+	LeaveCriticalSection(&fr->cs);
+
+	return(len);
+}
+
+//---------------------------------------------------------------------------
+// Binary frames receiver: find first queued message of channel (call inside critical section)
+//---------------------------------------------------------------------------
+static TLVPFrameMsg **frame_find(TLVPFrameRx *fr,int channel)
+{
+	TLVPFrameMsg **msg = &fr->first;
+	while(*msg && channel >= 0 && (*msg)->channel != channel)
+		msg = &(*msg)->next;
+	return(*msg?msg:NULL);
+}
+
+
+//---------------------------------------------------------------------------
+// Wait for binary frame message sent by golpi_stdout_send(). Messages are
+// split from stdout by readout thread to separate queue, text goes to stdout
+// fifo as usual.
+//  *proc: lv process instance handle
+//  channel: message channel (0 to 255), -1 for any
+//  timeout: timeout [ms], 0 to just check the queue
+//  *chret: returns message channel (optional)
+//  *size: returns message size [B] (optional)
+//---------------------------------------------------------------------------
+__int32 proc_frame_wait(TLVPHndl *proc,__int32 channel,__int32 timeout,__int32 *chret,__int32 *size)
+{
+	if(chret)
+		*chret = -1;
+	if(size)
+		*size = 0;
+	if(!proc || !proc->fifo || !proc->fifo->fr)
+		return(LVP_EC_NO_PROC);
+	TLVPFrameRx *fr = proc->fifo->fr;
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER t_start;
+	QueryPerformanceCounter(&t_start);
+	int ret;
+	EnterCriticalSection(&fr->cs);
+	do{
+		// wakeup read thread
+		SetEvent(proc->rd_event);
+
+		TLVPFrameMsg **msg = frame_find(fr,channel);
+		if(msg)
+		{
+			if(chret)
+				*chret = (*msg)->channel;
+			if(size)
+				*size = (*msg)->size;
+			ret = 0;
+			break;
+		}
+		if(fr->error)
+		{
+			ret = fr->error;
+			fr->error = 0;
+			break;
+		}
+
+		LARGE_INTEGER t_new;
+		QueryPerformanceCounter(&t_new);
+		int left = timeout - time_get_ms(&t_start,&t_new,&freq);
+		if(left <= 0)
+		{
+			ret = timeout?LVP_EC_TIMEOUT:LVP_EC_FRAME_EMPTY;
+			break;
+		}
+		SleepConditionVariableCS(&fr->arrived,&fr->cs,min(left,FRAME_WAIT_SLICE));
+	}while(1);
+	LeaveCriticalSection(&fr->cs);
+
+	return(ret);
+}
+
+//---------------------------------------------------------------------------
+// Fetch first queued binary frame message and remove it from the queue.
+// Message of golpi_stdout_send() is variable record: DWORD type (VTYPE_xxx),
+// DWORD rows, DWORD columns, data.
+//  *proc: lv process instance handle
+//  channel: message channel (0 to 255), -1 for any
+//  *dst: destination buffer
+//  dstlen: size of destination buffer, message stays queued if too small
+//  *chret: returns message channel (optional)
+//  *dstret: returns message size [B] (optional)
+//---------------------------------------------------------------------------
+__int32 proc_frame_fetch(TLVPHndl *proc,__int32 channel,char *dst,__int32 dstlen,__int32 *chret,__int32 *dstret)
+{
+	if(chret)
+		*chret = -1;
+	if(dstret)
+		*dstret = 0;
+	if(!proc || !proc->fifo || !proc->fifo->fr)
+		return(LVP_EC_NO_PROC);
+	TLVPFrameRx *fr = proc->fifo->fr;
+
+	EnterCriticalSection(&fr->cs);
+	TLVPFrameMsg **pmsg = frame_find(fr,channel);
+	if(!pmsg)
+	{
+		LeaveCriticalSection(&fr->cs);
+		return(LVP_EC_FRAME_EMPTY);
+	}
+	TLVPFrameMsg *msg = *pmsg;
+	if(chret)
+		*chret = msg->channel;
+	if(dstret)
+		*dstret = msg->size;
+	if(!dst && msg->size)
+	{
+		LeaveCriticalSection(&fr->cs);
+		return(LVP_EC_NO_BUF);
+	}
+	if(dstlen < msg->size)
+	{
+		LeaveCriticalSection(&fr->cs);
+		return(LVP_EC_FRAME_SMALL_BUF);
+	}
+
+	// unlink message
+	*pmsg = msg->next;
+	if(fr->last == msg)
+	{
+		fr->last = fr->first;
+		while(fr->last && fr->last->next)
+			fr->last = fr->last->next;
+	}
+	LeaveCriticalSection(&fr->cs);
+
+	int msg_channel = msg->channel;
+	int msg_size = msg->size;
+	memcpy((void*)dst,(void*)msg->data,msg->size);
+	frame_msg_free(msg);
+
+	debug_printf(proc,"binary frame message fetched: channel %d, %dB\n",msg_channel,msg_size);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Discard all queued binary frame messages.
+//  *proc: lv process instance handle
+//---------------------------------------------------------------------------
+__int32 proc_frame_clear(TLVPHndl *proc)
+{
+	if(!proc || !proc->fifo || !proc->fifo->fr)
+		return(LVP_EC_NO_PROC);
+	TLVPFrameRx *fr = proc->fifo->fr;
+
+	EnterCriticalSection(&fr->cs);
+	while(fr->first)
+	{
+		TLVPFrameMsg *next = fr->first->next;
+		frame_msg_free(fr->first);
+		fr->first = next;
+	}
+	fr->last = NULL;
+	fr->error = 0;
+	LeaveCriticalSection(&fr->cs);
+
+	return(0);
+}
@@ -0,0 +1,579 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - MAT files
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Reader and writer of MAT-4 files (and writer of Octave binary files) used by file transfer mode of GOLPI.
+// Files are accessed via file mappings, so the data are converted directly between the file and caller's
+// arrays. LabVIEW 2D arrays are row-major, MAT files are column-major, so optional transposition is done
+// in cache friendly tiles.
+//
+// MAT-4 variable record:
+//   int32 - type MOPT (M - 0 little-endian, O - 0, P - precision, T - 0 numeric, 1 text)
+//   int32 - rows count
+//   int32 - columns count
+//   int32 - imaginary flag
+//   int32 - name length including '\0'
+//   BYTES - name
+//   BYTES - real part data (column-major)
+//   BYTES - imaginary part data (column-major, only if imaginary flag is set)
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// MAT-4 precision digits
+#define MAT_P_DOUBLE 0
+#define MAT_P_SINGLE 1
+#define MAT_P_INT32 2
+#define MAT_P_INT16 3
+#define MAT_P_UINT16 4
+#define MAT_P_UINT8 5
+// MAT-4 header size [B]
+#define MAT_HDR_SIZE 20
+// tile size of transposition [elements]
+#define MAT_TILE 32
+// initial variables capacity of file index
+#define MAT_INIT_VARS 16
+// Octave binary file header and type codes
+#define MAT_OCT_MAGIC "Octave-1-L"
+#define MAT_OCT_MAGIC_LEN 10
+#define MAT_OCT_LS_DOUBLE 7
+
+// element sizes of MAT-4 precisions
+static const int mat_elsize[6] = {8,4,4,2,2,1};
+
+
+//---------------------------------------------------------------------------
+// Read int32 from unaligned position.
+//---------------------------------------------------------------------------
+static inline int mat_read_int(const char *src)
+{
+	__int32 value;
+	memcpy((void*)&value,(void*)src,4);
+	return(value);
+}
+
+//---------------------------------------------------------------------------
+// Write int32 to unaligned position, returns next position.
+//---------------------------------------------------------------------------
+static inline char *mat_write_int(char *dst,int value)
+{
+	__int32 v = value;
+	memcpy((void*)dst,(void*)&v,4);
+	return(dst + 4);
+}
+
+//---------------------------------------------------------------------------
+// Get element of MAT data plane converted to double.
+//---------------------------------------------------------------------------
+static inline double mat_elem(const char *src,int type,size_t k)
+{
+	switch(type)
+	{
+		case MAT_P_DOUBLE: {double v; memcpy((void*)&v,(void*)&src[8*k],8); return(v);}
+		case MAT_P_SINGLE: {float v; memcpy((void*)&v,(void*)&src[4*k],4); return((double)v);}
+		case MAT_P_INT32: {__int32 v; memcpy((void*)&v,(void*)&src[4*k],4); return((double)v);}
+		case MAT_P_INT16: {__int16 v; memcpy((void*)&v,(void*)&src[2*k],2); return((double)v);}
+		case MAT_P_UINT16: {unsigned __int16 v; memcpy((void*)&v,(void*)&src[2*k],2); return((double)v);}
+		default: return((double)(unsigned char)src[k]);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Copy MAT data plane (column-major) to doubles array with element step 'step'.
+//---------------------------------------------------------------------------
+static void mat_load_plane(double *dst,int step,const char *src,int type,int rows,int cols,int rowmajor)
+{
+	size_t count = (size_t)rows*cols;
+	if(type == MAT_P_DOUBLE && step == 1 && (!rowmajor || rows == 1 || cols == 1))
+	{
+		// same layout: bulk copy
+		memcpy((void*)dst,(void*)src,count*sizeof(double));
+	}
+	else if(!rowmajor || rows == 1 || cols == 1)
+	{
+		for(size_t k = 0;k < count;k++)
+			dst[k*step] = mat_elem(src,type,k);
+	}
+	else
+	{
+		// transposition in tiles
+		for(int c0 = 0;c0 < cols;c0 += MAT_TILE)
+		{
+			int c1 = min(c0 + MAT_TILE,cols);
+			for(int r0 = 0;r0 < rows;r0 += MAT_TILE)
+			{
+				int r1 = min(r0 + MAT_TILE,rows);
+				for(int c = c0;c < c1;c++)
+					for(int r = r0;r < r1;r++)
+						dst[((size_t)r*cols + c)*step] = mat_elem(src,type,(size_t)c*rows + r);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Copy doubles array with element step 'step' to column-major data plane.
+//---------------------------------------------------------------------------
+static void mat_store_plane(char *dst,int dstep,const double *src,int step,int rows,int cols,int rowmajor)
+{
+	size_t count = (size_t)rows*cols;
+	if(step == 1 && dstep == 1 && (!rowmajor || rows == 1 || cols == 1))
+	{
+		// same layout: bulk copy
+		memcpy((void*)dst,(void*)src,count*sizeof(double));
+	}
+	else if(!rowmajor || rows == 1 || cols == 1)
+	{
+		for(size_t k = 0;k < count;k++)
+			memcpy((void*)&dst[8*k*dstep],(void*)&src[k*step],8);
+	}
+	else
+	{
+		// transposition in tiles
+		for(int c0 = 0;c0 < cols;c0 += MAT_TILE)
+		{
+			int c1 = min(c0 + MAT_TILE,cols);
+			for(int r0 = 0;r0 < rows;r0 += MAT_TILE)
+			{
+				int r1 = min(r0 + MAT_TILE,rows);
+				for(int c = c0;c < c1;c++)
+					for(int r = r0;r < r1;r++)
+						memcpy((void*)&dst[8*((size_t)c*rows + r)*dstep],(void*)&src[((size_t)r*cols + c)*step],8);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Parse mapped MAT-4 file to variables index.
+//---------------------------------------------------------------------------
+static int mat_parse(TLVPMatFile *mat)
+{
+	const char *data = mat->data;
+	__int64 pos = 0;
+	while(pos < mat->size)
+	{
+		if(mat->size - pos < MAT_HDR_SIZE)
+			return(LVP_EC_MAT_FORMAT);
+		const char *hdr = &data[pos];
+		int mopt = mat_read_int(&hdr[0]);
+		int rows = mat_read_int(&hdr[4]);
+		int cols = mat_read_int(&hdr[8]);
+		int imagf = mat_read_int(&hdr[12]);
+		int namelen = mat_read_int(&hdr[16]);
+
+		// only little-endian numeric and text full matrices are supported
+		int type = (mopt/10) % 10;
+		int text = mopt % 10;
+		if(mopt < 0 || mopt >= 100 || type > MAT_P_UINT8 || text > 1)
+			return(LVP_EC_MAT_FORMAT);
+		if(rows < 0 || cols < 0 || (imagf != 0 && imagf != 1) || namelen < 2 || namelen > LVP_MAT_MAX_NAME)
+			return(LVP_EC_MAT_FORMAT);
+		pos += MAT_HDR_SIZE;
+		if(mat->size - pos < namelen || hdr[MAT_HDR_SIZE + namelen - 1] != '\0')
+			return(LVP_EC_MAT_FORMAT);
+		// data size check without overflow of elements count
+		if((unsigned __int64)rows*cols > (unsigned __int64)(mat->size - pos - namelen)/(mat_elsize[type]*(1 + imagf)))
+			return(LVP_EC_MAT_FORMAT);
+		__int64 plane = (__int64)rows*cols*mat_elsize[type];
+
+		// grow index
+		if(mat->count >= mat->cap)
+		{
+			int cap = mat->cap?(2*mat->cap):MAT_INIT_VARS;
+			TLVPMatVar *vars = (TLVPMatVar*)realloc((void*)mat->vars,cap*sizeof(TLVPMatVar));
+			if(!vars)
+				return(LVP_EC_MAT_ALLOC);
+			mat->vars = vars;
+			mat->cap = cap;
+		}
+
+		TLVPMatVar *var = &mat->vars[mat->count++];
+		memcpy((void*)var->name,(void*)&data[pos],namelen);
+		pos += namelen;
+		var->type = type;
+		var->text = text;
+		var->rows = rows;
+		var->cols = cols;
+		var->cplx = imagf;
+		var->re = &data[pos];
+		var->im = imagf?&data[pos + plane]:NULL;
+		pos += plane*(1 + imagf);
+	}
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Size of variable record [B].
+//---------------------------------------------------------------------------
+static __int64 mat_record_size(const char *name,int rows,int cols,int cplx,int format)
+{
+	__int64 data = (__int64)rows*cols*sizeof(double)*(cplx?2:1);
+	int namelen = (int)strlen(name);
+	if(format == LVP_MAT_FORMAT_OCTAVE)
+	{
+		// name, doc string, global flag, new format flag, type name, dims, data type
+		int typelen = cplx?14:6;
+		return(4 + namelen + 4 + 1 + 1 + 4 + typelen + 4 + 2*4 + 1 + data);
+	}
+	return(MAT_HDR_SIZE + namelen + 1 + data);
+}
+
+//---------------------------------------------------------------------------
+// Write variable record to buffer.
+//---------------------------------------------------------------------------
+static void mat_write_record(char *dst,const char *name,const double *data,int rows,int cols,int cplx,int rowmajor,int format)
+{
+	int namelen = (int)strlen(name);
+	size_t plane = (size_t)rows*cols*sizeof(double);
+	if(format == LVP_MAT_FORMAT_OCTAVE)
+	{
+		const char *typ = cplx?"complex matrix":"matrix";
+		int typelen = (int)strlen(typ);
+		dst = mat_write_int(dst,namelen);
+		memcpy((void*)dst,(void*)name,namelen);
+		dst += namelen;
+		dst = mat_write_int(dst,0);
+		*dst++ = 0;
+		*dst++ = (char)255;
+		dst = mat_write_int(dst,typelen);
+		memcpy((void*)dst,(void*)typ,typelen);
+		dst += typelen;
+		dst = mat_write_int(dst,-2);
+		dst = mat_write_int(dst,rows);
+		dst = mat_write_int(dst,cols);
+		*dst++ = MAT_OCT_LS_DOUBLE;
+		// complex data are (re,im) pairs
+		if(cplx && (!rowmajor || rows == 1 || cols == 1))
+			memcpy((void*)dst,(void*)data,2*plane);
+		else if(cplx)
+		{
+			mat_store_plane(dst,2,data,2,rows,cols,rowmajor);
+			mat_store_plane(dst + 8,2,data + 1,2,rows,cols,rowmajor);
+		}
+		else
+			mat_store_plane(dst,1,data,1,rows,cols,rowmajor);
+	}
+	else
+	{
+		dst = mat_write_int(dst,MAT_P_DOUBLE*10);
+		dst = mat_write_int(dst,rows);
+		dst = mat_write_int(dst,cols);
+		dst = mat_write_int(dst,cplx?1:0);
+		dst = mat_write_int(dst,namelen + 1);
+		memcpy((void*)dst,(void*)name,namelen + 1);
+		dst += namelen + 1;
+		// separate real and imaginary planes
+		mat_store_plane(dst,1,data,cplx?2:1,rows,cols,rowmajor);
+		if(cplx)
+			mat_store_plane(dst + plane,1,data + 1,2,rows,cols,rowmajor);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Append variable record to open file via its mapping.
+//---------------------------------------------------------------------------
+int mat_write_file(HANDLE hfile,char *name,double *data,int rows,int cols,int cplx,int rowmajor,int format)
+{
+	LARGE_INTEGER fsize;
+	if(!GetFileSizeEx(hfile,&fsize))
+		return(LVP_EC_MAT_WRITE);
+
+	// Octave binary file starts with header
+	int hdrlen = (format == LVP_MAT_FORMAT_OCTAVE && !fsize.QuadPart)?(MAT_OCT_MAGIC_LEN + 1):0;
+	if(format == LVP_MAT_FORMAT_OCTAVE && fsize.QuadPart)
+	{
+		char magic[MAT_OCT_MAGIC_LEN + 1];
+		DWORD read;
+		LARGE_INTEGER zero;
+		zero.QuadPart = 0;
+		if(!SetFilePointerEx(hfile,zero,NULL,FILE_BEGIN) || !ReadFile(hfile,(void*)magic,sizeof(magic),&read,NULL))
+			return(LVP_EC_MAT_WRITE);
+		if(read != sizeof(magic) || memcmp((void*)magic,(void*)MAT_OCT_MAGIC,MAT_OCT_MAGIC_LEN) || magic[MAT_OCT_MAGIC_LEN] != 0)
+			return(LVP_EC_MAT_FORMAT);
+	}
+
+	// extend file by mapping and map only the appended part (aligned to allocation granularity)
+	__int64 size = hdrlen + mat_record_size(name,rows,cols,cplx,format);
+	__int64 total = fsize.QuadPart + size;
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	__int64 base = fsize.QuadPart - fsize.QuadPart % si.dwAllocationGranularity;
+	if((unsigned __int64)(total - base) > (SIZE_T)-1)
+		return(LVP_EC_MAT_ALLOC);
+	HANDLE hmap = CreateFileMapping(hfile,NULL,PAGE_READWRITE,(DWORD)(total >> 32),(DWORD)total,NULL);
+	if(!hmap)
+		return(LVP_EC_MAT_WRITE);
+	char *view = (char*)MapViewOfFile(hmap,FILE_MAP_WRITE,(DWORD)(base >> 32),(DWORD)base,(SIZE_T)(total - base));
+	if(!view)
+	{
+		CloseHandle(hmap);
+		return(LVP_EC_MAT_ALLOC);
+	}
+
+	char *dst = &view[fsize.QuadPart - base];
+	if(hdrlen)
+	{
+		memcpy((void*)dst,(void*)MAT_OCT_MAGIC,MAT_OCT_MAGIC_LEN);
+		dst[MAT_OCT_MAGIC_LEN] = 0; /*IEEE little-endian*/
+		dst += hdrlen;
+	}
+	mat_write_record(dst,name,data,rows,cols,cplx,rowmajor,format);
+
+	UnmapViewOfFile(view);
+	CloseHandle(hmap);
+
+	return(0);
+}
+
+
+//---------------------------------------------------------------------------
+// Write real or complex matrix to MAT-4 or Octave binary file.
+//  *path: file path
+//  *name: variable name (null terminated string)
+//  *data: matrix data (complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  rowmajor: non-zero if data are row-major (LabVIEW 2D array), else column-major
+//  format: file format LVP_MAT_FORMAT_xxx
+//  append: non-zero to append variable to existing file
+//
+// Data are always stored as double. Octave loads both formats by 'load(path)'.
+//---------------------------------------------------------------------------
+__int32 proc_mat_write(char *path,char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,__int32 rowmajor,__int32 format,__int32 append)
+{
+	if(num_check_name(name) || rows < 0 || cols < 0)
+		return(LVP_EC_NUM_NAME);
+	if(!path || (!data && rows*cols))
+		return(LVP_EC_NO_BUF);
+	if(format != LVP_MAT_FORMAT_MAT4 && format != LVP_MAT_FORMAT_OCTAVE)
+		return(LVP_EC_MAT_FORMAT);
+
+	HANDLE hfile = CreateFileA(path,GENERIC_READ|GENERIC_WRITE,0,NULL,append?OPEN_ALWAYS:CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+	if(hfile == INVALID_HANDLE_VALUE)
+		return(LVP_EC_MAT_OPEN);
+
+	int ret = mat_write_file(hfile,name,data,rows,cols,cplx,rowmajor,format);
+
+	CloseHandle(hfile);
+
+	return(ret);
+}
+
+//---------------------------------------------------------------------------
+// Open MAT-4 file and build index of its variables.
+//  *path: file path
+//  **mat: returns MAT file handle, close it by proc_mat_close()
+//  *count: returns variables count (optional)
+//
+// File is mapped to memory till it is closed.
+//---------------------------------------------------------------------------
+__int32 proc_mat_open(char *path,TLVPMatFile **mat,__int32 *count)
+{
+	if(count)
+		*count = 0;
+	if(!path || !mat)
+		return(LVP_EC_NO_BUF);
+	*mat = NULL;
+
+	TLVPMatFile *mf = (TLVPMatFile*)malloc(sizeof(TLVPMatFile));
+	if(!mf)
+		return(LVP_EC_MAT_ALLOC);
+	memset((void*)mf,0,sizeof(TLVPMatFile));
+
+	mf->hfile = CreateFileA(path,GENERIC_READ,FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+	if(mf->hfile == INVALID_HANDLE_VALUE)
+	{
+		free((void*)mf);
+		return(LVP_EC_MAT_OPEN);
+	}
+
+	// map whole file (empty file has no variables and cannot be mapped)
+	LARGE_INTEGER fsize;
+	int ret = 0;
+	if(!GetFileSizeEx(mf->hfile,&fsize))
+		ret = LVP_EC_MAT_OPEN;
+	else if((unsigned __int64)fsize.QuadPart > (SIZE_T)-1)
+		ret = LVP_EC_MAT_ALLOC;
+	else if(fsize.QuadPart)
+	{
+		mf->size = fsize.QuadPart;
+		mf->hmap = CreateFileMapping(mf->hfile,NULL,PAGE_READONLY,0,0,NULL);
+		if(mf->hmap)
+			mf->data = (const char*)MapViewOfFile(mf->hmap,FILE_MAP_READ,0,0,0);
+		if(!mf->data)
+			ret = LVP_EC_MAT_ALLOC;
+		else
+			ret = mat_parse(mf);
+	}
+	if(ret)
+	{
+		proc_mat_close(mf);
+		return(ret);
+	}
+
+	*mat = mf;
+	if(count)
+		*count = mf->count;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Close MAT file.
+//  *mat: MAT file handle
+//---------------------------------------------------------------------------
+__int32 proc_mat_close(TLVPMatFile *mat)
+{
+	if(!mat)
+		return(LVP_EC_NO_BUF);
+
+	if(mat->data)
+		UnmapViewOfFile((LPCVOID)mat->data);
+	if(mat->hmap)
+		CloseHandle(mat->hmap);
+	if(mat->hfile && mat->hfile != INVALID_HANDLE_VALUE)
+		CloseHandle(mat->hfile);
+	free((void*)mat->vars);
+	free((void*)mat);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Find variable of MAT file by name.
+//  *mat: MAT file handle
+//  *name: variable name (null terminated string)
+//  *var: returns variable index
+//---------------------------------------------------------------------------
+__int32 proc_mat_find(TLVPMatFile *mat,char *name,__int32 *var)
+{
+	if(!mat || !name || !var)
+		return(LVP_EC_NO_BUF);
+	*var = -1;
+
+	for(int k = 0;k < mat->count;k++)
+	{
+		if(!strcmp(mat->vars[k].name,name))
+		{
+			*var = k;
+			return(0);
+		}
+	}
+
+	return(LVP_EC_MAT_NOT_FOUND);
+}
+
+//---------------------------------------------------------------------------
+// Get variable info of MAT file.
+//  *mat: MAT file handle
+//  var: variable index
+//  *name: variable name buffer (optional)
+//  maxlen: size of variable name buffer
+//  *type: returns data precision (0 double, 1 single, 2 int32, 3 int16, 4 uint16, 5 uint8) (optional)
+//  *text: returns non-zero for text matrix (optional)
+//  *rows: returns rows count (optional)
+//  *cols: returns columns count (optional)
+//  *cplx: returns non-zero for complex data (optional)
+//---------------------------------------------------------------------------
+__int32 proc_mat_info(TLVPMatFile *mat,__int32 var,char *name,__int32 maxlen,__int32 *type,__int32 *text,__int32 *rows,__int32 *cols,__int32 *cplx)
+{
+	if(!mat)
+		return(LVP_EC_NO_BUF);
+	if(var < 0 || var >= mat->count)
+		return(LVP_EC_MAT_NOT_FOUND);
+
+	TLVPMatVar *v = &mat->vars[var];
+	if(name)
+	{
+		if(maxlen < (int)strlen(v->name) + 1)
+			return(LVP_EC_MAT_SMALL_BUF);
+		strcpy_s(name,maxlen,v->name);
+	}
+	if(type)
+		*type = v->type;
+	if(text)
+		*text = v->text;
+	if(rows)
+		*rows = v->rows;
+	if(cols)
+		*cols = v->cols;
+	if(cplx)
+		*cplx = v->cplx;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Get pointers to data of variable of MAT file (mapped file content).
+//  *mat: MAT file handle
+//  var: variable index
+//  **re: returns pointer to real part data (column-major, see proc_mat_info() for type)
+//  **im: returns pointer to imaginary part data, NULL for real data (optional)
+//  *size: returns size of each part [B] (optional)
+//
+// Pointers are valid till the file is closed. Returns LVP_EC_MAT_SMALL_BUF
+// if size is requested, but it does not fit to 32bit integer.
+//---------------------------------------------------------------------------
+__int32 proc_mat_data(TLVPMatFile *mat,__int32 var,char **re,char **im,__int32 *size)
+{
+	if(!mat || !re)
+		return(LVP_EC_NO_BUF);
+	if(var < 0 || var >= mat->count)
+		return(LVP_EC_MAT_NOT_FOUND);
+
+	TLVPMatVar *v = &mat->vars[var];
+	if(size && (unsigned __int64)v->rows*v->cols > 0x7FFFFFFFull/mat_elsize[v->type])
+		return(LVP_EC_MAT_SMALL_BUF);
+	*re = (char*)v->re;
+	if(im)
+		*im = (char*)v->im;
+	if(size)
+		*size = v->rows*v->cols*mat_elsize[v->type];
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Read variable of MAT file to array of doubles.
+//  *mat: MAT file handle
+//  var: variable index
+//  *dst: destination array
+//  dstlen: destination array size (count of doubles)
+//  rowmajor: non-zero to store data row-major (LabVIEW 2D array), else column-major
+//  *dstret: returns count of doubles stored (optional)
+//
+// Complex data are stored as (re,im) pairs. Column-major double data are
+// copied by single bulk copy.
+//---------------------------------------------------------------------------
+__int32 proc_mat_read(TLVPMatFile *mat,__int32 var,double *dst,__int32 dstlen,__int32 rowmajor,__int32 *dstret)
+{
+	if(dstret)
+		*dstret = 0;
+	if(!mat || !dst)
+		return(LVP_EC_NO_BUF);
+	if(var < 0 || var >= mat->count)
+		return(LVP_EC_MAT_NOT_FOUND);
+
+	TLVPMatVar *v = &mat->vars[var];
+	__int64 count = (__int64)v->rows*v->cols*(v->cplx?2:1);
+	if(count > dstlen)
+		return(LVP_EC_MAT_SMALL_BUF);
+
+	mat_load_plane(dst,v->cplx?2:1,v->re,v->type,v->rows,v->cols,rowmajor);
+	if(v->cplx)
+		mat_load_plane(dst + 1,2,v->im,v->type,v->rows,v->cols,rowmajor);
+
+	if(dstret)
+		*dstret = (int)count;
+
+	return(0);
+}
@@ -65,11 +65,23 @@
 //   write_pipe_buffer_size = 0
 //   read_pipe_buffer_size = 0
 //   
+//   [PROCESS]
+//   ;CPU affinity mask of the process, hexadecimal as 0x... possible (0: system decides)
+//   affinity_mask = 0
+//   ;NUMA node of the process, used when affinity_mask is 0 (-1: system decides)
+//   numa_node = -1
+//   ;process priority class IDLE, BELOW_NORMAL, NORMAL, ABOVE_NORMAL, HIGH or REALTIME (empty: system decides)
+//   priority_class =
+//   
 //   [READ]
 //   ;read thread priority (0: normal, <-15,15> range possible)
 //   thread_priority = +1
 //   ;read thread idle time if no data in read pipe (1 to 100 ms)
 //   thread_idle_time = 1
+//   ;read thread CPU affinity mask (0: same as the process)
+//   thread_affinity_mask = 0
+//   ;MMCSS task of read thread, e.g. Pro Audio (empty: not registered)
+//   thread_mmcss_task =
 //   
 //   [CONSOLE]
 //   ;always create console (1 - overides proc_create(..., hide) parameter)
@@ -275,6 +287,43 @@ WORD ini_parse_color(wchar_t *str)
 	return(ini_parse_color(str,0,NULL,0));
 }
 
+//---------------------------------------------------------------------------
+// INI: process priority classes in order of LVP_PRIO_xxx
+//---------------------------------------------------------------------------
+static const struct{
+	wchar_t *str;
+	DWORD flag;
+}ini_prio_classes[]={
+	{L"",0},
+	{L"IDLE",IDLE_PRIORITY_CLASS},
+	{L"BELOW_NORMAL",BELOW_NORMAL_PRIORITY_CLASS},
+	{L"NORMAL",NORMAL_PRIORITY_CLASS},
+	{L"ABOVE_NORMAL",ABOVE_NORMAL_PRIORITY_CLASS},
+	{L"HIGH",HIGH_PRIORITY_CLASS},
+	{L"REALTIME",REALTIME_PRIORITY_CLASS}
+};
+
+//---------------------------------------------------------------------------
+// INI: parse process priority class name, returns 0 if not recognized
+//---------------------------------------------------------------------------
+DWORD ini_parse_priority(wchar_t *str)
+{
+	for(int k = 1;k <= LVP_PRIO_REALTIME;k++)
+		if(str && !_wcsicmp(str,ini_prio_classes[k].str))
+			return(ini_prio_classes[k].flag);
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// INI: process priority class of LVP_PRIO_xxx, returns 0 for default
+//---------------------------------------------------------------------------
+DWORD ini_priority_class(int prio)
+{
+	if(prio < LVP_PRIO_DEFAULT || prio > LVP_PRIO_REALTIME)
+		return(0);
+	return(ini_prio_classes[prio].flag);
+}
+
 
 
 //---------------------------------------------------------------------------
@@ -298,6 +347,11 @@ int ini_read_ini(TCfg *cfg,int *dbg)
  	cfg->read_pipe_buf = 0;
 	cfg->console_clr_stdin = FOREGROUND_RED|FOREGROUND_INTENSITY;
 	cfg->console_clr_stdout = FOREGROUND_GREEN;
+	cfg->affinity = 0;
+	cfg->numa_node = -1;
+	cfg->priority_class = 0;
+	cfg->th_affinity = 0;
+	cfg->th_mmcss[0] = L'\0';
 	if(dbg)
 	    *dbg = 0;
   
@@ -340,6 +394,21 @@ int ini_read_ini(TCfg *cfg,int *dbg)
 	cfg->console_x = GetPrivateProfileInt(L"CONSOLE",L"buf_size_x",cfg->console_x,pini);
     cfg->console_y = GetPrivateProfileInt(L"CONSOLE",L"buf_size_y",cfg->console_y,pini);
 
+	// process CPU affinity mask (hexadecimal possible) and NUMA node
+	GetPrivateProfileStringW(L"PROCESS",L"affinity_mask",L"0",temp,1024,pini);
+	cfg->affinity = _wcstoui64(temp,NULL,0);
+	GetPrivateProfileStringW(L"PROCESS",L"numa_node",L"-1",temp,1024,pini);
+	cfg->numa_node = _wtoi(temp);
+
+	// process priority class
+	GetPrivateProfileStringW(L"PROCESS",L"priority_class",L"",temp,1024,pini);
+	cfg->priority_class = ini_parse_priority(temp);
+
+	// read thread CPU affinity mask and MMCSS task
+	GetPrivateProfileStringW(L"READ",L"thread_affinity_mask",L"0",temp,1024,pini);
+	cfg->th_affinity = _wcstoui64(temp,NULL,0);
+	GetPrivateProfileStringW(L"READ",L"thread_mmcss_task",L"",cfg->th_mmcss,LVP_MMCSS_MAX,pini);
+
 	return(0);
 }
 
@@ -364,6 +433,37 @@ int fifo_alloc(TLVPHndl *proc,int size)
 		proc->fifo = NULL;
 		return(1);
 	}
+	// allocate bitstream receiver
+	proc->fifo->bs = bs_alloc();
+	if(!proc->fifo->bs)
+	{
+		free((void*)proc->fifo->data);
+		free((void*)proc->fifo);
+		proc->fifo = NULL;
+		return(1);
+	}
+	// allocate binary frames receiver
+	proc->fifo->fr = frame_rx_alloc();
+	if(!proc->fifo->fr)
+	{
+		bs_free(proc->fifo->bs);
+		free((void*)proc->fifo->data);
+		free((void*)proc->fifo);
+		proc->fifo = NULL;
+		return(1);
+	}
+	// allocate tagged requests receiver
+	proc->fifo->rq = req_rx_alloc();
+	if(!proc->fifo->rq)
+	{
+		frame_rx_free(proc->fifo->fr);
+		bs_free(proc->fifo->bs);
+		free((void*)proc->fifo->data);
+		free((void*)proc->fifo);
+		proc->fifo = NULL;
+		return(1);
+	}
+
 	// store current length
 	proc->fifo->len = size;
 
@@ -393,6 +493,15 @@ int fifo_free(TLVPHndl *proc)
 	if(proc->fifo->data)
 		free((void*)proc->fifo->data);
 
+	// loose bitstream receiver
+	bs_free(proc->fifo->bs);
+
+	// loose binary frames receiver
+	frame_rx_free(proc->fifo->fr);
+
+	// loose tagged requests receiver
+	req_rx_free(proc->fifo->rq);
+
 	// loose critical section
 	DeleteCriticalSection(&proc->fifo->cs);
 
@@ -657,6 +766,25 @@ DWORD WINAPI fifo_read_thread(LPVOID lpParam)
 	LARGE_INTEGER t_last; QueryPerformanceCounter(&t_last);
 
 	char buf[STDOUT_TH_BUF_SIZE];
+	char ftext[STDOUT_TH_BUF_SIZE + FRAME_OUT_ID_LEN];
+	char text[STDOUT_TH_BUF_SIZE + FRAME_OUT_ID_LEN + BS_HDR_ID_LEN];
+	char rtext[STDOUT_TH_BUF_SIZE + FRAME_OUT_ID_LEN + BS_HDR_ID_LEN + REQ_MARK_MAX];
+	// text which did not fit to fifo (stdout may be read over fifo free space, see below)
+	char hold[sizeof(rtext)];
+	int hold_len = 0;
+
+	// register to MMCSS task (avrt.dll is loaded dynamically, it is not present before Vista)
+	HMODULE avrt = NULL;
+	HANDLE mmcss = NULL;
+	if(proc.read_th_mmcss[0] && (avrt = LoadLibraryW(L"avrt.dll")) != NULL)
+	{
+		typedef HANDLE (WINAPI *TAvSetMmThreadCharacteristicsW)(LPCWSTR,LPDWORD);
+		TAvSetMmThreadCharacteristicsW av_set = (TAvSetMmThreadCharacteristicsW)GetProcAddress(avrt,"AvSetMmThreadCharacteristicsW");
+		DWORD task = 0;
+		if(av_set)
+			mmcss = av_set(proc.read_th_mmcss,&task);
+	}
+
 	int exit;
 	do{
 
@@ -664,6 +792,15 @@ DWORD WINAPI fifo_read_thread(LPVOID lpParam)
 		int read = 0;
 		int tord = 0;
 
+		// store held text first
+		if(hold_len)
+		{
+			int written;
+			fifo_write(&proc,hold,hold_len,&written);
+			hold_len -= written;
+			memmove((void*)hold,(void*)&hold[written],hold_len);
+		}
+
 		// free space in the fifo?
 		int towr;
 		if(fifo_to_write(&proc,&towr))
@@ -671,9 +808,23 @@ DWORD WINAPI fifo_read_thread(LPVOID lpParam)
 			exit = 1;
 			continue;
 		}
+		// bitstream or frame being received does not go to fifo, so read it even if fifo is full
+		int bslen = bs_read_limit(proc.fifo->bs);
+		if(bslen && towr < bslen + 1)
+			towr = bslen + 1;
+		int frlen = frame_read_limit(proc.fifo->fr);
+		if(frlen && towr < frlen + 1)
+			towr = frlen + 1;
+		// output of pending requests goes to request slots, so do not stall on fifo full of untagged text
+		int rqlen = req_read_limit(proc.fifo->rq);
+		if(rqlen && towr < rqlen)
+			towr = rqlen;
 		// limit to local buffer size
 		if(towr > STDOUT_TH_BUF_SIZE)
 			towr = STDOUT_TH_BUF_SIZE;
+		// nothing new till held text is stored, so the text is not lost
+		if(hold_len)
+			towr = 0;
 
 		// try to read stdout (critical section just in case we have debug console)
 		if(proc.cout)
@@ -687,9 +838,38 @@ DWORD WINAPI fifo_read_thread(LPVOID lpParam)
 			continue;
 		}
 
-		// try to store to fifo
+		// try to store to fifo (split binary frames, decode armed bitstream, route request outputs, pass the rest)
 		if(read)
-			fifo_write(&proc,buf,read,NULL);
+		{
+			char *src = buf;
+			int flen = frame_stream_process(proc.fifo->fr,buf,read,ftext);
+			if(flen >= 0)
+			{
+				src = ftext;
+				read = flen;
+			}
+			int len = read?bs_stream_process(proc.fifo->bs,src,read,text):0;
+			if(len >= 0)
+			{
+				src = text;
+				read = len;
+			}
+			len = read?req_stream_process(proc.fifo->rq,src,read,rtext):0;
+			if(len >= 0)
+			{
+				src = rtext;
+				read = len;
+			}
+			// text over fifo free space is held for the next pass
+			int written = 0;
+			if(read)
+				fifo_write(&proc,src,read,&written);
+			if(written < read)
+			{
+				hold_len = read - written;
+				memcpy((void*)hold,(void*)&src[written],hold_len);
+			}
+		}
 
 		// sleep?
 		if(!exit && !proc.fifo->exit && !tord)
@@ -711,6 +891,17 @@ DWORD WINAPI fifo_read_thread(LPVOID lpParam)
 
 	}while(!proc.fifo->exit && !exit);
 
+	// leave MMCSS task
+	if(mmcss)
+	{
+		typedef BOOL (WINAPI *TAvRevertMmThreadCharacteristics)(HANDLE);
+		TAvRevertMmThreadCharacteristics av_revert = (TAvRevertMmThreadCharacteristics)GetProcAddress(avrt,"AvRevertMmThreadCharacteristics");
+		if(av_revert)
+			av_revert(mmcss);
+	}
+	if(avrt)
+		FreeLibrary(avrt);
+
 	return(0);
 }
 
@@ -758,6 +949,7 @@ __int32 proc_format_error(__int32 code,char *str,__int32 buflen)
 		{LVP_EC_NO_PROC,"missing instance handle!"},
 		{LVP_EC_CANT_CREATE_PIPE,"can't create pipe!"},
 		{LVP_EC_CANT_CREATE_PROC,"can't create process!"},
+		{LVP_EC_AFFINITY,"invalid CPU affinity or NUMA node!"},
 		{LVP_EC_NO_EXIT,"process is still running!"},
 		{LVP_EC_EXIT_TO,"exit code query timeout!"},
 		{LVP_EC_NO_BUF,"no data buffer assigned!"},
@@ -772,6 +964,45 @@ __int32 proc_format_error(__int32 code,char *str,__int32 buflen)
 		{LVP_EC_STDOUT_RD_TH_FAILED,"creation of stdout readout thread failed!"},
 		{LVP_EC_STDOUT_FIFO_FAILED,"allocation of the stdout fifo buffer failed!"},
 		{LVP_EC_STDOUT_EVENT_FAILED,"creating wakup event of the stdout fifo buffer failed!"},
+		{LVP_EC_BS_HEADER,"invalid bitstream header!"},
+		{LVP_EC_BS_INCOMPLETE,"incomplete bitstream data!"},
+		{LVP_EC_BS_SMALL_BUF,"buffer to small for decoded bitstream data!"},
+		{LVP_EC_BS_NOT_ARMED,"bitstream receive is not armed!"},
+		{LVP_EC_BS_ALLOC,"allocation of bitstream data buffer failed!"},
+		{LVP_EC_STRUCT_FORMAT,"invalid structure stream!"},
+		{LVP_EC_STRUCT_ALLOC,"allocation of structure index failed!"},
+		{LVP_EC_STRUCT_NOT_FOUND,"structure item not found!"},
+		{LVP_EC_STRUCT_SMALL_BUF,"buffer to small for structure item data!"},
+		{LVP_EC_NUM_FORMAT,"invalid number format!"},
+		{LVP_EC_NUM_SMALL_BUF,"buffer to small for formatted matrix!"},
+		{LVP_EC_NUM_NAME,"invalid variable name or matrix size!"},
+		{LVP_EC_NUM_ALLOC,"allocation of formatting buffer failed!"},
+		{LVP_EC_MAT_OPEN,"cannot open MAT file!"},
+		{LVP_EC_MAT_FORMAT,"invalid or unsupported MAT file!"},
+		{LVP_EC_MAT_NOT_FOUND,"MAT file variable not found!"},
+		{LVP_EC_MAT_SMALL_BUF,"buffer to small for MAT file variable!"},
+		{LVP_EC_MAT_ALLOC,"mapping of MAT file failed!"},
+		{LVP_EC_MAT_WRITE,"writing of MAT file failed!"},
+		{LVP_EC_TMP_CREATE,"cannot create temporary file!"},
+		{LVP_EC_TMP_BUSY,"all temporary files are in use!"},
+		{LVP_EC_TMP_INVALID,"invalid temporary file index or pool size!"},
+		{LVP_EC_TMP_ALLOC,"allocation of temporary files pool failed!"},
+		{LVP_EC_FRAME_NOT_READY,"binary frame receiver did not respond!"},
+		{LVP_EC_FRAME_SIZE,"invalid binary frame size!"},
+		{LVP_EC_FRAME_ALLOC,"allocation of binary frame message failed!"},
+		{LVP_EC_FRAME_EMPTY,"no binary frame message received!"},
+		{LVP_EC_FRAME_SMALL_BUF,"buffer to small for binary frame message!"},
+		{LVP_EC_FRAME_DISCARDED,"binary frame message discarded by sender!"},
+		{LVP_EC_REQ_NO_SLOT,"too many requests in flight!"},
+		{LVP_EC_REQ_UNKNOWN,"unknown request id!"},
+		{LVP_EC_REQ_SMALL_BUF,"buffer to small for request output!"},
+		{LVP_EC_REQ_LOST,"part of request output lost!"},
+		{LVP_EC_REQ_ALLOC,"allocation of request command failed!"},
+		{LVP_EC_QUEUE_INVALID,"invalid command queue lane or setup!"},
+		{LVP_EC_QUEUE_THREAD,"creation of command queue thread failed!"},
+		{LVP_EC_WARM_INVALID,"invalid instances count of pool!"},
+		{LVP_EC_WARM_ALLOC,"creation of instances pool failed!"},
+		{LVP_EC_WARM_INIT,"initialization of pool instance failed!"},
 		{0,"unknown error!"}
 	};
 
@@ -816,6 +1047,26 @@ __int32 proc_handle_size(void)
 //  hide: write 1 to hide console
 //---------------------------------------------------------------------------
 __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32 hide)
+{
+	return(proc_create_ex(proc,folder,cmd,sterr,hide,0,-1,LVP_PRIO_DEFAULT,0,NULL));
+}
+
+//---------------------------------------------------------------------------
+// Try to create process and its pipes with scheduling options. Options left
+// at default value are taken from lv_proc.ini ([PROCESS] and [READ]).
+// Readout thread runs on the CPUs of the process unless its own mask is set.
+//  *proc: lv process instance handle
+//  *folder: working directory for the process
+//  *cmd: the command to execute (see proc_create())
+//  sterr: write 1 to combine stderr to stdout
+//  hide: write 1 to hide console
+//  affinity: CPU affinity mask of the process (0: default)
+//  numa_node: NUMA node of the process, used if no affinity mask (-1: default)
+//  priority: process priority class LVP_PRIO_xxx (0: default)
+//  th_affinity: CPU affinity mask of readout thread (0: default)
+//  *mmcss: MMCSS task of readout thread, e.g. "Pro Audio" (empty or NULL: default)
+//---------------------------------------------------------------------------
+__int32 proc_create_ex(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32 hide,unsigned __int64 affinity,__int32 numa_node,__int32 priority,unsigned __int64 th_affinity,char *mmcss)
 {
 	// leave if no proc handle
 	if(!proc)
@@ -829,8 +1080,25 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 	int dbg;
 	ini_read_ini(&cfg,&dbg);
 
+	// override ini scheduling options by parameters
+	if(affinity)
+		cfg.affinity = affinity;
+	else if(numa_node >= 0)
+	{
+		cfg.affinity = 0;
+		cfg.numa_node = numa_node;
+	}
+	if(priority > LVP_PRIO_DEFAULT)
+		cfg.priority_class = ini_priority_class(priority);
+	if(th_affinity)
+		cfg.th_affinity = th_affinity;
+	if(mmcss && *mmcss)
+		MultiByteToWideChar(CP_ACP,0,mmcss,-1,cfg.th_mmcss,LVP_MMCSS_MAX);
+	cfg.th_mmcss[LVP_MMCSS_MAX - 1] = L'\0';
+
     // copy config to lv_process handle
 	proc->read_th_idle = cfg.th_idle;
+	wcscpy_s(proc->read_th_mmcss,LVP_MMCSS_MAX,cfg.th_mmcss);
 
 	// store debug file path
 	if(dbg)
@@ -936,6 +1204,27 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 
 	debug_printf(proc," - done\n");
 
+	// --- resolve CPU affinity of the process (masks are limited to CPUs available to caller) ---
+	DWORD_PTR avail_mask = 0;
+	DWORD_PTR sys_mask = 0;
+	if(!GetProcessAffinityMask(GetCurrentProcess(),&avail_mask,&sys_mask))
+		avail_mask = sys_mask = 0;
+	DWORD_PTR mask = 0;
+	if(cfg.affinity)
+		mask = (DWORD_PTR)cfg.affinity;
+	else if(cfg.numa_node >= 0)
+	{
+		ULONGLONG node_mask = 0;
+		if(!GetNumaNodeProcessorMask((UCHAR)cfg.numa_node,&node_mask))
+			node_mask = 0;
+		mask = (DWORD_PTR)node_mask;
+	}
+	if((cfg.affinity || cfg.numa_node >= 0) && !(mask &= avail_mask))
+	{
+		proc_cleanup(proc);
+		return(LVP_EC_AFFINITY);
+	}
+
     debug_printf(proc,"creating process\n");
 
 	// --- create process startup info ---
@@ -954,7 +1243,8 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 	si.hStdError=sterr?proc->pout[1]:NULL;
         
     // --- try to crate process ---
-    if(!CreateProcessA(NULL,cmd,NULL,NULL,true,0,NULL,folder,&si,&pi))
+    // process is started suspended when the affinity is to be set before it runs
+    if(!CreateProcessA(NULL,cmd,NULL,NULL,true,cfg.priority_class|(mask?CREATE_SUSPENDED:0),NULL,folder,&si,&pi))
 	{
 		// failed - close handles
 		proc_cleanup(proc);
@@ -966,6 +1256,19 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 	proc->pid = pi.dwProcessId;
 	proc->tid = pi.dwThreadId;
 
+	// set CPU affinity and let the process run
+	if(mask)
+	{
+		if(!SetProcessAffinityMask(proc->hproc,mask))
+		{
+			// failed - kill suspended process
+			TerminateProcess(proc->hproc,1);
+			proc_cleanup(proc);
+			return(LVP_EC_AFFINITY);
+		}
+		ResumeThread(proc->hth);
+	}
+
 	debug_printf(proc," - done\n");
 
 	debug_printf(proc,"allocating stdout fifo\n");
@@ -998,7 +1301,7 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 
 	// create stdout fifo read thread
 	proc->fifo->exit = -1; // initialization mode
-	proc->fifo->th = CreateThread(NULL,0,fifo_read_thread,(PVOID)proc,0,NULL);
+	proc->fifo->th = CreateThread(NULL,0,fifo_read_thread,(PVOID)proc,CREATE_SUSPENDED,NULL);
 	if(!proc->fifo->th)
 	{
 		// failed
@@ -1009,6 +1312,18 @@ __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32
 	// set thread priority
 	SetThreadPriority(proc->fifo->th,cfg.th_priority);
 
+	// set thread CPU affinity (CPUs of the process by default, so it shares caches with the process)
+	DWORD_PTR th_mask = cfg.th_affinity?((DWORD_PTR)cfg.th_affinity & avail_mask):mask;
+	if((cfg.th_affinity && !th_mask) || (th_mask && !SetThreadAffinityMask(proc->fifo->th,th_mask)))
+	{
+		// failed - no CPU left or mask refused, kill process
+		TerminateProcess(proc->hproc,1);
+		proc_cleanup(proc);
+		return(LVP_EC_AFFINITY);
+	}
+
+	ResumeThread(proc->fifo->th);
+
 	debug_printf(proc," - done\n");
 
 	debug_printf(proc,"waiting for stdout readout thread initialization\n");
@@ -1040,6 +1355,10 @@ __int32 proc_cleanup(TLVPHndl *proc)
 	if(!proc)
 		return(LVP_EC_NO_PROC);
 
+	// stop command queue thread (it writes to stdin pipe)
+	if(proc->fifo)
+		req_queue_stop(proc->fifo->rq);
+
 	debug_printf(proc,"closing handles:\n");
 
 	// close handles
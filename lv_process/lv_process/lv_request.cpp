@@ -0,0 +1,929 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - GOLPI tagged requests
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Pipelining of commands: each command gets sequence id and it is wrapped to golpi_dispatch(id,cmd), which
+// prints "\x1bGpRqB<id>\n" before and "\x1bGpRqE<id> <status>\n" after the output of command. The stdout readout
+// thread routes the output between the markers to the request slot of the id, so the caller may send more
+// commands without waiting and collect their outputs later by id. Text outside the markers goes to stdout fifo.
+// Asynchronous command API (proc_command_submit() etc.) uses the same requests as tickets. Completion of request
+// is signalled by the readout thread, so the waiting caller does not poll the stdout.
+// Command queue (proc_queue_submit() etc.) holds commands of more submitters in the request slots and its thread
+// writes them one by one by lanes, so a slow command of one thread does not delay control commands of other one.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <stdio.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// size of golpi_dispatch() call without command
+#define REQ_CMD_LEN 64
+// initial allocation of request output [B]
+#define REQ_OUT_MIN_SIZE 4096
+// maximum wait interval for request completion, so a waiter still checks the process exit
+#define REQ_WAIT_SLICE 50
+// default command queue setup (see proc_queue_config())
+#define REQ_QUEUE_INFLIGHT 1
+#define REQ_QUEUE_WEIGHT_NORMAL 4
+#define REQ_QUEUE_WEIGHT_BULK 1
+// interval of cancelling blocked stdin write of command queue thread being stopped [ms]
+#define REQ_QUEUE_STOP_SLICE 50
+
+
+//---------------------------------------------------------------------------
+// Tagged requests: allocate and init receiver
+//---------------------------------------------------------------------------
+TLVPReqRx *req_rx_alloc(void)
+{
+	TLVPReqRx *rq = (TLVPReqRx*)malloc(sizeof(TLVPReqRx));
+	if(!rq)
+		return(NULL);
+	memset((void*)rq,0,sizeof(TLVPReqRx));
+
+	// command queue wakeup event
+	rq->q_wake = CreateEvent(NULL,false,false,NULL);
+	if(!rq->q_wake)
+	{
+		free((void*)rq);
+		return(NULL);
+	}
+	// request done condition (each waiter checks its own request)
+	InitializeConditionVariable(&rq->done);
+	rq->q_inflight = REQ_QUEUE_INFLIGHT;
+	rq->q_weight[LVP_LANE_NORMAL] = REQ_QUEUE_WEIGHT_NORMAL;
+	rq->q_weight[LVP_LANE_BULK] = REQ_QUEUE_WEIGHT_BULK;
+	rq->active = -1;
+	InitializeCriticalSection(&rq->cs);
+	InitializeCriticalSection(&rq->wr_cs);
+
+	return(rq);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: release slot (call inside critical section)
+//---------------------------------------------------------------------------
+static void req_slot_free(TLVPReqRx *rq,int slot)
+{
+	TLVPReqSlot *rs = &rq->slots[slot];
+	if(rs->state == REQ_STATE_SENT || rs->state == REQ_STATE_RUNNING)
+		rq->pending--;
+	if(rq->active == slot)
+		rq->active = -1;
+	if(rs->data)
+		free((void*)rs->data);
+	if(rs->cmd)
+		free((void*)rs->cmd);
+	memset((void*)rs,0,sizeof(TLVPReqSlot));
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: loose receiver and all request outputs
+//---------------------------------------------------------------------------
+void req_rx_free(TLVPReqRx *rq)
+{
+	if(!rq)
+		return;
+	req_queue_stop(rq);
+	for(int k = 0; k < LVP_REQ_MAX_SLOTS; k++)
+		req_slot_free(rq,k);
+	CloseHandle(rq->q_wake);
+	DeleteCriticalSection(&rq->cs);
+	DeleteCriticalSection(&rq->wr_cs);
+	free((void*)rq);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: find slot of request id (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_find(TLVPReqRx *rq,int id)
+{
+	if(id <= 0)
+		return(-1);
+	for(int k = 0; k < LVP_REQ_MAX_SLOTS; k++)
+		if(rq->slots[k].state != REQ_STATE_FREE && rq->slots[k].id == id)
+			return(k);
+	return(-1);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: find slot of request id owned by caller (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_find_owned(TLVPReqRx *rq,int id)
+{
+	int slot = req_find(rq,id);
+	if(slot >= 0 && rq->slots[slot].cancel)
+		return(-1);
+	return(slot);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: store output to active slot or to text (call inside critical section)
+//---------------------------------------------------------------------------
+static void req_output(TLVPReqRx *rq,const char *data,int len,char *text,int *tlen)
+{
+	if(!len)
+		return;
+	if(rq->active < 0)
+	{
+		memcpy((void*)&text[*tlen],(void*)data,len);
+		*tlen += len;
+		return;
+	}
+
+	TLVPReqSlot *rs = &rq->slots[rq->active];
+	if(rs->cancel)
+		return;
+	if(rs->size + len > rs->cap)
+	{
+		int cap = max(rs->cap,REQ_OUT_MIN_SIZE);
+		while(cap < rs->size + len && cap <= 0x3FFFFFFF)
+			cap *= 2;
+		char *data = (cap >= rs->size + len)?(char*)realloc((void*)rs->data,cap):NULL;
+		if(!data)
+		{
+			rs->lost = 1;
+			return;
+		}
+		rs->data = data;
+		rs->cap = cap;
+	}
+	memcpy((void*)&rs->data[rs->size],(void*)data,len);
+	rs->size += len;
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: process received marker line (call inside critical section)
+//---------------------------------------------------------------------------
+static void req_marker(TLVPReqRx *rq)
+{
+	rq->mark[rq->mark_len] = '\0';
+	char type = rq->mark[REQ_MARK_ID_LEN];
+	int id;
+	int status = 0;
+	if(type == REQ_MARK_BEGIN && sscanf_s(&rq->mark[REQ_MARK_ID_LEN + 1],"%d",&id) == 1)
+	{
+		// start of request output (unknown request goes to fifo)
+		rq->active = req_find(rq,id);
+		if(rq->active >= 0)
+			rq->slots[rq->active].state = REQ_STATE_RUNNING;
+	}
+	else if(type == REQ_MARK_END && sscanf_s(&rq->mark[REQ_MARK_ID_LEN + 1],"%d %d",&id,&status) >= 1)
+	{
+		// end of request output
+		int slot = req_find(rq,id);
+		if(slot >= 0 && rq->slots[slot].cancel)
+			req_slot_free(rq,slot);
+		else if(slot >= 0 && rq->slots[slot].state == REQ_STATE_RUNNING)
+		{
+			rq->slots[slot].state = REQ_STATE_DONE;
+			rq->slots[slot].status = status;
+			rq->pending--;
+			WakeAllConditionVariable(&rq->done);
+		}
+		rq->active = -1;
+		// next queued command may be written
+		SetEvent(rq->q_wake);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: route stdout data between request markers to request
+// slots. Rest of text is stored to 'text' buffer, which must be REQ_MARK_MAX
+// bytes larger than 'len'. Returns text length or -1 if the data contain no
+// marker and no request is active, so they can be passed as they are.
+//---------------------------------------------------------------------------
+int req_stream_process(TLVPReqRx *rq,char *buf,int len,char *text)
+{
+	if(!rq)
+		return(-1);
+
+	EnterCriticalSection(&rq->cs);
+
+	// fast path: plain text
+	if(rq->active < 0 && !rq->mark_len && !memchr((void*)buf,REQ_MARK_ID[0],len))
+	{
+		LeaveCriticalSection(&rq->cs);
+		return(-1);
+	}
+
+	int pos = 0;
+	int tlen = 0;
+	while(pos < len)
+	{
+		if(!rq->mark_len)
+		{
+			// pass text up to first mark character at once
+			char *id = (char*)memchr((void*)&buf[pos],REQ_MARK_ID[0],len - pos);
+			int n = id?(int)(id - &buf[pos]):(len - pos);
+			req_output(rq,&buf[pos],n,text,&tlen);
+			pos += n;
+			if(pos >= len)
+				break;
+		}
+		char c = buf[pos++];
+		if(rq->mark_len < REQ_MARK_ID_LEN && c == REQ_MARK_ID[rq->mark_len])
+		{
+			// marker start
+			rq->mark[rq->mark_len++] = c;
+			continue;
+		}
+		if(rq->mark_len >= REQ_MARK_ID_LEN && c == '\n')
+		{
+			// complete marker line
+			req_marker(rq);
+			rq->mark_len = 0;
+			continue;
+		}
+		if(rq->mark_len >= REQ_MARK_ID_LEN && rq->mark_len < REQ_MARK_MAX - 1 && c != REQ_MARK_ID[0])
+		{
+			// marker content
+			rq->mark[rq->mark_len++] = c;
+			continue;
+		}
+		// not a marker: return partially matched marker to output
+		req_output(rq,rq->mark,rq->mark_len,text,&tlen);
+		rq->mark_len = 0;
+		if(c == REQ_MARK_ID[0])
+			rq->mark[rq->mark_len++] = c;
+		else
+			req_output(rq,&c,1,text,&tlen);
+	}
+
+	LeaveCriticalSection(&rq->cs);
+
+	return(tlen);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: bytes count which may be read from stdout even if stdout
+// fifo is full (outputs of pending requests go to request slots, untagged
+// text over fifo free space is held by the readout thread)
+//---------------------------------------------------------------------------
+int req_read_limit(TLVPReqRx *rq)
+{
+	if(!rq)
+		return(0);
+
+	EnterCriticalSection(&rq->cs);
+	int len = (rq->pending > 0)?STDOUT_TH_BUF_SIZE:0;
+	LeaveCriticalSection(&rq->cs);
+
+	return(len);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: get new request id (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_new_id(TLVPReqRx *rq)
+{
+	if(++rq->seq <= 0)
+		rq->seq = 1;
+	return(rq->seq);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: reserve slot for request id, returns slot or -1 if no
+// free slot (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_slot_alloc(TLVPReqRx *rq,int id,int state)
+{
+	int slot;
+	for(slot = 0; slot < LVP_REQ_MAX_SLOTS; slot++)
+		if(rq->slots[slot].state == REQ_STATE_FREE)
+			break;
+	if(slot >= LVP_REQ_MAX_SLOTS)
+		return(-1);
+	rq->slots[slot].id = id;
+	rq->slots[slot].state = state;
+	if(state == REQ_STATE_SENT)
+		rq->pending++;
+	return(slot);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: wrap command to golpi_dispatch(id,['...' char(10) '...']);
+// returns allocated string or NULL
+//---------------------------------------------------------------------------
+static char *req_format(int rid,char *cmd,int cmdlen,int *len)
+{
+	char *str = (char*)malloc(REQ_CMD_LEN + 12*cmdlen);
+	if(!str)
+		return(NULL);
+
+	int n = sprintf_s(str,REQ_CMD_LEN,"golpi_dispatch(%d,['",rid);
+	for(int k = 0; k < cmdlen; k++)
+	{
+		if(cmd[k] == '\'')
+		{
+			str[n++] = '\'';
+			str[n++] = '\'';
+		}
+		else if(cmd[k] == '\n' || cmd[k] == '\r')
+			n += sprintf_s(&str[n],16,"' char(%d) '",(int)cmd[k]);
+		else
+			str[n++] = cmd[k];
+	}
+	n += sprintf_s(&str[n],REQ_CMD_LEN/2,"']);\n");
+	*len = n;
+
+	return(str);
+}
+
+//---------------------------------------------------------------------------
+// Tagged requests: wait till request is done, returns 0 if done
+//---------------------------------------------------------------------------
+static int req_wait(TLVPHndl *proc,int id,int timeout)
+{
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER t_start;
+	QueryPerformanceCounter(&t_start);
+	int ret;
+	EnterCriticalSection(&rq->cs);
+	do{
+		// wakeup read thread
+		SetEvent(proc->rd_event);
+
+		int slot = req_find_owned(rq,id);
+		if(slot < 0)
+		{
+			ret = LVP_EC_REQ_UNKNOWN;
+			break;
+		}
+		if(rq->slots[slot].state == REQ_STATE_DONE)
+		{
+			ret = 0;
+			break;
+		}
+
+		// leave if process returned
+		DWORD ec;
+		if(GetExitCodeProcess(proc->hproc,&ec) && ec != STILL_ACTIVE)
+		{
+			ret = LVP_EC_EXITED;
+			break;
+		}
+
+		LARGE_INTEGER t_new;
+		QueryPerformanceCounter(&t_new);
+		int left = timeout - time_get_ms(&t_start,&t_new,&freq);
+		if(left <= 0)
+		{
+			ret = LVP_EC_TIMEOUT;
+			break;
+		}
+		SleepConditionVariableCS(&rq->done,&rq->cs,min(left,REQ_WAIT_SLICE));
+	}while(1);
+	LeaveCriticalSection(&rq->cs);
+
+	return(ret);
+}
+
+//---------------------------------------------------------------------------
+// Command queue: select next command to be written, returns slot or -1 if
+// none may be written now (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_queue_next(TLVPReqRx *rq)
+{
+	// oldest command of each lane
+	int first[LVP_QUEUE_LANES];
+	for(int lane = 0; lane < LVP_QUEUE_LANES; lane++)
+		first[lane] = -1;
+	for(int k = 0; k < LVP_REQ_MAX_SLOTS; k++)
+	{
+		TLVPReqSlot *rs = &rq->slots[k];
+		if(rs->state != REQ_STATE_QUEUED)
+			continue;
+		if(first[rs->lane] < 0 || rs->id < rq->slots[first[rs->lane]].id)
+			first[rs->lane] = k;
+	}
+
+	// control lane jumps the queue and it is not limited by commands in flight
+	if(first[LVP_LANE_CONTROL] >= 0)
+		return(first[LVP_LANE_CONTROL]);
+	if(rq->pending >= rq->q_inflight)
+		return(-1);
+
+	// other lanes take turns, lane writes up to its weight of commands in its turn
+	for(int n = 0; n < 2*LVP_QUEUE_LANES; n++)
+	{
+		int lane = rq->q_lane;
+		if(lane != LVP_LANE_CONTROL && first[lane] >= 0 && rq->q_credit[lane] > 0)
+		{
+			rq->q_credit[lane]--;
+			return(first[lane]);
+		}
+		rq->q_credit[lane] = rq->q_weight[lane];
+		rq->q_lane = (lane + 1)%LVP_QUEUE_LANES;
+	}
+
+	return(-1);
+}
+
+//---------------------------------------------------------------------------
+// Command queue: thread writing queued commands to the process
+//---------------------------------------------------------------------------
+static DWORD WINAPI req_queue_thread(LPVOID lpParam)
+{
+	// own copy of the handle (caller may move its handle)
+	TLVPHndl proc;
+	memcpy((void*)&proc,lpParam,sizeof(TLVPHndl));
+	free(lpParam);
+	TLVPReqRx *rq = proc.fifo->rq;
+
+	while(!rq->q_exit)
+	{
+		// take next command
+		EnterCriticalSection(&rq->cs);
+		int slot = req_queue_next(rq);
+		char *str = NULL;
+		int len = 0;
+		int rid = 0;
+		if(slot >= 0)
+		{
+			TLVPReqSlot *rs = &rq->slots[slot];
+			str = rs->cmd;
+			len = rs->cmd_len;
+			rid = rs->id;
+			rs->cmd = NULL;
+			rs->state = REQ_STATE_SENT;
+			rq->pending++;
+		}
+		LeaveCriticalSection(&rq->cs);
+		if(slot < 0)
+		{
+			// wait for new command or for end of command in flight
+			WaitForSingleObject(rq->q_wake,INFINITE);
+			continue;
+		}
+
+		debug_printf(&proc,"request %d: writing queued command\n",rid);
+
+		EnterCriticalSection(&rq->wr_cs);
+		int written;
+		int ret = proc_write_stdin(&proc,str,len,&written);
+		LeaveCriticalSection(&rq->wr_cs);
+		free((void*)str);
+		if(ret || written != len)
+		{
+			// write failed: finish request, so the submitter does not wait for its output
+			EnterCriticalSection(&rq->cs);
+			slot = req_find(rq,rid);
+			if(slot >= 0 && rq->slots[slot].cancel)
+				req_slot_free(rq,slot);
+			else if(slot >= 0 && rq->slots[slot].state == REQ_STATE_SENT)
+			{
+				rq->slots[slot].state = REQ_STATE_DONE;
+				rq->slots[slot].status = 1;
+				rq->slots[slot].error = ret?LVP_EC_WRITE_FAIL:LVP_EC_WRITE_INCOMPLETE;
+				rq->pending--;
+				WakeAllConditionVariable(&rq->done);
+			}
+			LeaveCriticalSection(&rq->cs);
+		}
+
+		// wakeup read thread
+		SetEvent(proc.rd_event);
+	}
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Command queue: start queue thread if not running (call inside critical section)
+//---------------------------------------------------------------------------
+static int req_queue_start(TLVPHndl *proc)
+{
+	TLVPReqRx *rq = proc->fifo->rq;
+	if(rq->q_th)
+		return(0);
+
+	TLVPHndl *copy = (TLVPHndl*)malloc(sizeof(TLVPHndl));
+	if(!copy)
+		return(LVP_EC_QUEUE_THREAD);
+	memcpy((void*)copy,(void*)proc,sizeof(TLVPHndl));
+	rq->q_exit = 0;
+	rq->q_th = CreateThread(NULL,0,req_queue_thread,(PVOID)copy,0,NULL);
+	if(!rq->q_th)
+	{
+		free((void*)copy);
+		return(LVP_EC_QUEUE_THREAD);
+	}
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Command queue: stop queue thread, queued commands stay in their slots
+//---------------------------------------------------------------------------
+void req_queue_stop(TLVPReqRx *rq)
+{
+	if(!rq || !rq->q_th)
+		return;
+
+	// thread is not terminated (it could leave receiver locked), stdin write blocked by hung process is cancelled
+	rq->q_exit = 1;
+	SetEvent(rq->q_wake);
+	while(WaitForSingleObject(rq->q_th,REQ_QUEUE_STOP_SLICE) == WAIT_TIMEOUT)
+		CancelSynchronousIo(rq->q_th);
+	CloseHandle(rq->q_th);
+	rq->q_th = NULL;
+}
+
+
+//---------------------------------------------------------------------------
+// Send command tagged with request id without waiting for its output, so
+// more commands may be in flight. Command is wrapped to golpi_dispatch(),
+// which prints begin/end markers around its output, and the readout thread
+// routes the output to the request slot.
+//  *proc: lv process instance handle
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *id: returns request id
+//---------------------------------------------------------------------------
+__int32 proc_request_send(TLVPHndl *proc,char *cmd,__int32 cmdlen,__int32 *id)
+{
+	if(id)
+		*id = 0;
+	if(!proc || !proc->hproc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	if(!cmd)
+		return(LVP_EC_NO_BUF);
+	if(cmdlen < 0)
+		cmdlen = strnlen_s(cmd,-cmdlen);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	// reserve request slot
+	EnterCriticalSection(&rq->cs);
+	int rid = req_new_id(rq);
+	int slot = req_slot_alloc(rq,rid,REQ_STATE_SENT);
+	LeaveCriticalSection(&rq->cs);
+	if(slot < 0)
+		return(LVP_EC_REQ_NO_SLOT);
+
+	// command as Octave string: golpi_dispatch(id,['...' char(10) '...']);
+	int len;
+	char *str = req_format(rid,cmd,cmdlen,&len);
+	if(!str)
+	{
+		EnterCriticalSection(&rq->cs);
+		req_slot_free(rq,slot);
+		LeaveCriticalSection(&rq->cs);
+		return(LVP_EC_REQ_ALLOC);
+	}
+
+	debug_printf(proc,"request %d: sending command\n",rid);
+
+	// commands of more threads must not interleave (not under receiver lock, write may block till stdout is read)
+	EnterCriticalSection(&rq->wr_cs);
+	int written;
+	int ret = proc_write_stdin(proc,str,len,&written);
+	LeaveCriticalSection(&rq->wr_cs);
+	free((void*)str);
+	if(ret || written != len)
+	{
+		EnterCriticalSection(&rq->cs);
+		req_slot_free(rq,slot);
+		LeaveCriticalSection(&rq->cs);
+		return(ret?LVP_EC_WRITE_FAIL:LVP_EC_WRITE_INCOMPLETE);
+	}
+
+	// wakeup read thread
+	SetEvent(proc->rd_event);
+
+	if(id)
+		*id = rid;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Wait for output of request sent by proc_request_send() and release the
+// request. Output does not contain the markers.
+//  *proc: lv process instance handle
+//  id: request id
+//  timeout: timeout [ms], request stays pending on timeout
+//  *buf: output buffer (null terminated string)
+//  buflen: output buffer size, request stays pending if too small
+//  *bufret: returns output size [B] (optional)
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+//---------------------------------------------------------------------------
+__int32 proc_request_read(TLVPHndl *proc,__int32 id,__int32 timeout,char *buf,__int32 buflen,__int32 *bufret,__int32 *status)
+{
+	if(bufret)
+		*bufret = 0;
+	if(status)
+		*status = 0;
+	if(!proc || !proc->hproc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	if(!buf)
+		return(LVP_EC_NO_BUF);
+	if(buflen < 1)
+		return(LVP_EC_NO_LEN);
+	buf[0] = '\0';
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	int ret = req_wait(proc,id,timeout);
+	if(ret)
+		return(ret);
+
+	EnterCriticalSection(&rq->cs);
+	int slot = req_find_owned(rq,id);
+	if(slot < 0)
+	{
+		LeaveCriticalSection(&rq->cs);
+		return(LVP_EC_REQ_UNKNOWN);
+	}
+	TLVPReqSlot *rs = &rq->slots[slot];
+	if(bufret)
+		*bufret = rs->size;
+	if(status)
+		*status = rs->status;
+	if(buflen < rs->size + 1)
+	{
+		LeaveCriticalSection(&rq->cs);
+		return(LVP_EC_REQ_SMALL_BUF);
+	}
+	memcpy((void*)buf,(void*)rs->data,rs->size);
+	buf[rs->size] = '\0';
+	ret = rs->error?rs->error:(rs->lost?LVP_EC_REQ_LOST:0);
+	req_slot_free(rq,slot);
+	LeaveCriticalSection(&rq->cs);
+
+	debug_printf(proc,"request %d: output read\n",id);
+
+	return(ret);
+}
+
+
+//---------------------------------------------------------------------------
+// Submit command without waiting for its output. Returns ticket for
+// proc_command_poll(), proc_command_wait() and proc_command_cancel(). Ticket
+// is request id (see proc_request_send()), so the output is read by
+// proc_request_read(). Completion is signalled by the readout thread, so
+// single caller thread may drive many process instances.
+//  *proc: lv process instance handle
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *ticket: returns command ticket
+//---------------------------------------------------------------------------
+__int32 proc_command_submit(TLVPHndl *proc,char *cmd,__int32 cmdlen,__int32 *ticket)
+{
+	return(proc_request_send(proc,cmd,cmdlen,ticket));
+}
+
+//---------------------------------------------------------------------------
+// Get state of submitted command without waiting.
+//  *proc: lv process instance handle
+//  ticket: command ticket
+//  *state: returns command state LVP_CMD_xxx (1 - queued, 2 - running, 3 - done)
+//  *size: returns size of output received so far [B] (optional)
+//---------------------------------------------------------------------------
+__int32 proc_command_poll(TLVPHndl *proc,__int32 ticket,__int32 *state,__int32 *size)
+{
+	if(state)
+		*state = REQ_STATE_FREE;
+	if(size)
+		*size = 0;
+	if(!proc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	// wakeup read thread
+	SetEvent(proc->rd_event);
+
+	EnterCriticalSection(&rq->cs);
+	int slot = req_find_owned(rq,ticket);
+	if(slot >= 0)
+	{
+		if(state)
+			*state = (rq->slots[slot].state == REQ_STATE_QUEUED)?LVP_CMD_QUEUED:rq->slots[slot].state;
+		if(size)
+			*size = rq->slots[slot].size;
+	}
+	LeaveCriticalSection(&rq->cs);
+
+	return((slot < 0)?LVP_EC_REQ_UNKNOWN:0);
+}
+
+//---------------------------------------------------------------------------
+// Wait till submitted command is done. The caller thread sleeps till the
+// readout thread receives end of the output. Output stays in the request,
+// read it by proc_request_read().
+//  *proc: lv process instance handle
+//  ticket: command ticket
+//  timeout: timeout [ms]
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+//  *size: returns output size [B] (optional)
+//---------------------------------------------------------------------------
+__int32 proc_command_wait(TLVPHndl *proc,__int32 ticket,__int32 timeout,__int32 *status,__int32 *size)
+{
+	if(status)
+		*status = 0;
+	if(size)
+		*size = 0;
+	if(!proc || !proc->hproc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	int ret = req_wait(proc,ticket,timeout);
+	if(ret)
+		return(ret);
+
+	EnterCriticalSection(&rq->cs);
+	int slot = req_find_owned(rq,ticket);
+	if(slot >= 0)
+	{
+		if(status)
+			*status = rq->slots[slot].status;
+		if(size)
+			*size = rq->slots[slot].size;
+		ret = rq->slots[slot].error;
+	}
+	LeaveCriticalSection(&rq->cs);
+
+	return((slot < 0)?LVP_EC_REQ_UNKNOWN:ret);
+}
+
+//---------------------------------------------------------------------------
+// Cancel submitted command and release its ticket. Command already written
+// to the process cannot be recalled, so it is still executed, but its output
+// is discarded by the readout thread.
+//  *proc: lv process instance handle
+//  ticket: command ticket
+//---------------------------------------------------------------------------
+__int32 proc_command_cancel(TLVPHndl *proc,__int32 ticket)
+{
+	if(!proc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	EnterCriticalSection(&rq->cs);
+	int slot = req_find_owned(rq,ticket);
+	if(slot >= 0)
+	{
+		// finished or not yet written request is released now, pending one when its end marker arrives
+		TLVPReqSlot *rs = &rq->slots[slot];
+		if(rs->state == REQ_STATE_DONE || rs->state == REQ_STATE_QUEUED)
+			req_slot_free(rq,slot);
+		else
+		{
+			rs->cancel = 1;
+			if(rs->data)
+				free((void*)rs->data);
+			rs->data = NULL;
+			rs->size = 0;
+			rs->cap = 0;
+		}
+	}
+	LeaveCriticalSection(&rq->cs);
+
+	debug_printf(proc,"request %d: cancelled\n",ticket);
+
+	return((slot < 0)?LVP_EC_REQ_UNKNOWN:0);
+}
+
+
+//---------------------------------------------------------------------------
+// Setup command queue of the process instance. Commands of LVP_LANE_NORMAL
+// and LVP_LANE_BULK lanes take turns by their weights, so no lane starves.
+// Defaults are 1 command in flight and weights 4:1.
+//  *proc: lv process instance handle
+//  inflight: maximum commands written to process (1 to LVP_REQ_MAX_SLOTS)
+//  weight_normal: commands of normal lane in its turn (1 or more)
+//  weight_bulk: commands of bulk lane in its turn (1 or more)
+//---------------------------------------------------------------------------
+__int32 proc_queue_config(TLVPHndl *proc,__int32 inflight,__int32 weight_normal,__int32 weight_bulk)
+{
+	if(!proc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	if(inflight < 1 || inflight > LVP_REQ_MAX_SLOTS || weight_normal < 1 || weight_bulk < 1)
+		return(LVP_EC_QUEUE_INVALID);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	EnterCriticalSection(&rq->cs);
+	rq->q_inflight = inflight;
+	rq->q_weight[LVP_LANE_NORMAL] = weight_normal;
+	rq->q_weight[LVP_LANE_BULK] = weight_bulk;
+	for(int lane = 0; lane < LVP_QUEUE_LANES; lane++)
+		rq->q_credit[lane] = 0;
+	LeaveCriticalSection(&rq->cs);
+
+	// more commands may be written now
+	SetEvent(rq->q_wake);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Submit command to the command queue, so more threads may share single
+// process instance. lv_proc holds the command till its turn, then writes it
+// as tagged request, so the output is routed to the ticket of submitter.
+// Command of LVP_LANE_CONTROL lane is written before all queued commands as
+// soon as possible, but it still waits till commands already written to
+// the process are done. Use ticket as in proc_command_submit().
+//  *proc: lv process instance handle
+//  lane: queue lane LVP_LANE_xxx (0 - control, 1 - normal, 2 - bulk)
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *ticket: returns command ticket
+//---------------------------------------------------------------------------
+__int32 proc_queue_submit(TLVPHndl *proc,__int32 lane,char *cmd,__int32 cmdlen,__int32 *ticket)
+{
+	if(ticket)
+		*ticket = 0;
+	if(!proc || !proc->hproc || !proc->fifo || !proc->fifo->rq)
+		return(LVP_EC_NO_PROC);
+	if(!cmd)
+		return(LVP_EC_NO_BUF);
+	if(lane < 0 || lane >= LVP_QUEUE_LANES)
+		return(LVP_EC_QUEUE_INVALID);
+	if(cmdlen < 0)
+		cmdlen = strnlen_s(cmd,-cmdlen);
+	TLVPReqRx *rq = proc->fifo->rq;
+
+	// command as Octave string: golpi_dispatch(id,['...' char(10) '...']);
+	EnterCriticalSection(&rq->cs);
+	int rid = req_new_id(rq);
+	LeaveCriticalSection(&rq->cs);
+	int len;
+	char *str = req_format(rid,cmd,cmdlen,&len);
+	if(!str)
+		return(LVP_EC_REQ_ALLOC);
+
+	// store complete command to request slot at once
+	EnterCriticalSection(&rq->cs);
+	int ret = req_queue_start(proc);
+	int slot = ret?-1:req_slot_alloc(rq,rid,REQ_STATE_QUEUED);
+	if(slot >= 0)
+	{
+		rq->slots[slot].lane = lane;
+		rq->slots[slot].cmd = str;
+		rq->slots[slot].cmd_len = len;
+	}
+	else if(!ret)
+		ret = LVP_EC_REQ_NO_SLOT;
+	LeaveCriticalSection(&rq->cs);
+	if(ret)
+	{
+		free((void*)str);
+		return(ret);
+	}
+
+	// wakeup queue thread
+	SetEvent(rq->q_wake);
+
+	debug_printf(proc,"request %d: queued to lane %d\n",rid,lane);
+
+	if(ticket)
+		*ticket = rid;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Submit command to the command queue and wait for its output. Replacement
+// of proc_command() for threads sharing single process instance. Command is
+// cancelled on failure, so its output is lost.
+//  *proc: lv process instance handle
+//  lane: queue lane LVP_LANE_xxx (0 - control, 1 - normal, 2 - bulk)
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  timeout: timeout including time in the queue [ms]
+//  *buf: output buffer (null terminated string)
+//  buflen: output buffer size
+//  *bufret: returns output size [B] (optional)
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+//---------------------------------------------------------------------------
+__int32 proc_queue_command(TLVPHndl *proc,__int32 lane,char *cmd,__int32 cmdlen,__int32 timeout,char *buf,__int32 buflen,__int32 *bufret,__int32 *status)
+{
+	if(bufret)
+		*bufret = 0;
+	if(status)
+		*status = 0;
+	if(!buf)
+		return(LVP_EC_NO_BUF);
+	if(buflen < 1)
+		return(LVP_EC_NO_LEN);
+	buf[0] = '\0';
+
+	int ticket;
+	int ret = proc_queue_submit(proc,lane,cmd,cmdlen,&ticket);
+	if(ret)
+		return(ret);
+
+	// request stays pending on timeout or small buffer, nobody would read it
+	ret = proc_request_read(proc,ticket,timeout,buf,buflen,bufret,status);
+	if(ret == LVP_EC_TIMEOUT || ret == LVP_EC_REQ_SMALL_BUF || ret == LVP_EC_EXITED)
+		proc_command_cancel(proc,ticket);
+
+	return(ret);
+}
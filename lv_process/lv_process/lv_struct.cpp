@@ -0,0 +1,426 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - GOLPI structure stream parser
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Parser of binary structure streams generated by GOLPI Octave package (see golpi_conv_struct()).
+// The stream is walked once and flat index of all items is built, so each item can be looked up
+// by its path in constant time instead of parsing the stream again for each cluster element.
+//
+// Item paths:
+//  Items of top level structure are named by their field names, items of nested streams (elements
+//  of cell arrays or structure arrays) are prefixed by path of the array item and 1-based element
+//  index in braces, e.g. "a", "s{1}.b", "c{2}{3}.x". Unnamed item of string stream has path
+//  of its parent, i.e. "c{2}" or empty path for the top level.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <stdio.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// item types of structure stream
+#define SI_TYPE_MASK 0x0F
+#define SI_TYPE_COMPLEX 0x80
+#define SI_TYPE_INT32 0
+#define SI_TYPE_SGL 2
+#define SI_TYPE_DBL 3
+#define SI_TYPE_STRING 4
+#define SI_TYPE_ARRAY 5
+
+
+//---------------------------------------------------------------------------
+// Read DWORD from stream, returns non-zero if out of stream.
+//---------------------------------------------------------------------------
+static int si_read_dword(const char *src,int end,int *pos,int *value)
+{
+	if(*pos < 0 || end - *pos < 4)
+		return(1);
+	DWORD v;
+	memcpy((void*)&v,(void*)&src[*pos],4);
+	if(v > 0x7FFFFFFF)
+		return(1);
+	*value = (int)v;
+	*pos += 4;
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// FNV-1a hash of path
+//---------------------------------------------------------------------------
+static DWORD si_hash(const char *path,int len)
+{
+	DWORD h = 2166136261u;
+	for(int k = 0;k < len;k++)
+		h = (h ^ (unsigned char)path[k])*16777619u;
+	return(h);
+}
+
+//---------------------------------------------------------------------------
+// Element size of item type (0 for arrays and unknown types)
+//---------------------------------------------------------------------------
+static int si_element_size(int type)
+{
+	int size;
+	switch(type & SI_TYPE_MASK)
+	{
+		case SI_TYPE_INT32: size = 4; break;
+		case SI_TYPE_SGL: size = 4; break;
+		case SI_TYPE_DBL: size = 8; break;
+		case SI_TYPE_STRING: size = 1; break;
+		default: return(0);
+	}
+	return((type & SI_TYPE_COMPLEX)?(2*size):size);
+}
+
+//---------------------------------------------------------------------------
+// Add item record to index, returns non-zero if allocation failed.
+//---------------------------------------------------------------------------
+static int si_add_item(TLVPStructIndex *si,const char *path,int path_len,TLVPStructItem *item)
+{
+	// grow items list
+	if(si->count >= si->items_cap)
+	{
+		int cap = si->items_cap?(2*si->items_cap):64;
+		TLVPStructItem *items = (TLVPStructItem*)realloc((void*)si->items,cap*sizeof(TLVPStructItem));
+		if(!items)
+			return(1);
+		si->items = items;
+		si->items_cap = cap;
+	}
+
+	// grow paths pool
+	if(si->paths_len + path_len + 1 > si->paths_cap)
+	{
+		int cap = si->paths_cap?(2*si->paths_cap):4096;
+		while(cap < si->paths_len + path_len + 1)
+			cap *= 2;
+		char *paths = (char*)realloc((void*)si->paths,cap);
+		if(!paths)
+			return(1);
+		si->paths = paths;
+		si->paths_cap = cap;
+	}
+
+	// store path (null terminated)
+	item->path = si->paths_len;
+	item->path_len = path_len;
+	memcpy((void*)&si->paths[si->paths_len],(void*)path,path_len);
+	si->paths[si->paths_len + path_len] = '\0';
+	si->paths_len += path_len + 1;
+
+	si->items[si->count++] = *item;
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Parse one stream (top level or element of array item) starting at 'pos'.
+//  *path: path buffer with prefix of the stream items (size LVP_STRUCT_MAX_PATH)
+//  path_len: prefix length
+//  parent: index of parent array item (-1 for top level)
+//---------------------------------------------------------------------------
+static int si_parse_stream(TLVPStructIndex *si,const char *src,int pos,int end,char *path,int path_len,int parent,int depth)
+{
+	if(depth > LVP_STRUCT_MAX_DEPTH)
+		return(LVP_EC_STRUCT_FORMAT);
+
+	// items count
+	int count;
+	if(si_read_dword(src,end,&pos,&count))
+		return(LVP_EC_STRUCT_FORMAT);
+
+	for(int k = 0;k < count;k++)
+	{
+		// item record
+		int rec_size;
+		if(si_read_dword(src,end,&pos,&rec_size) || rec_size > end - pos || rec_size < 1)
+			return(LVP_EC_STRUCT_FORMAT);
+		int rec_end = pos + rec_size;
+
+		// item name
+		int name_len = (unsigned char)src[pos++];
+		if(name_len > rec_end - pos)
+			return(LVP_EC_STRUCT_FORMAT);
+		int len = path_len;
+		if(name_len)
+		{
+			if(len + 1 + name_len >= LVP_STRUCT_MAX_PATH)
+				return(LVP_EC_STRUCT_FORMAT);
+			if(len)
+				path[len++] = '.';
+			memcpy((void*)&path[len],(void*)&src[pos],name_len);
+			len += name_len;
+			pos += name_len;
+		}
+
+		// item type and dimensions
+		TLVPStructItem item;
+		if(rec_end - pos < 1)
+			return(LVP_EC_STRUCT_FORMAT);
+		item.type = (unsigned char)src[pos++];
+		if(si_read_dword(src,rec_end,&pos,&item.rows) || si_read_dword(src,rec_end,&pos,&item.cols))
+			return(LVP_EC_STRUCT_FORMAT);
+		item.parent = parent;
+		item.offset = pos;
+		item.size = rec_end - pos;
+		unsigned __int64 elements = (unsigned __int64)item.rows*item.cols;
+
+		int elsize = si_element_size(item.type);
+		if(elsize && elements*elsize > (unsigned __int64)item.size)
+			return(LVP_EC_STRUCT_FORMAT);
+		if((item.type & SI_TYPE_MASK) == SI_TYPE_ARRAY && elements*4 > (unsigned __int64)item.size)
+			return(LVP_EC_STRUCT_FORMAT);
+		if(elsize)
+			item.size = (int)elements*elsize;
+
+		// store item
+		int id = si->count;
+		if(si_add_item(si,path,len,&item))
+			return(LVP_EC_STRUCT_ALLOC);
+
+		if((item.type & SI_TYPE_MASK) == SI_TYPE_ARRAY)
+		{
+			// parse element streams: offsets table followed by streams, offsets are relative to end of table
+			int base = pos + 4*(int)elements;
+			for(int e = 0;e < (int)elements;e++)
+			{
+				int offset;
+				int tpos = pos + 4*e;
+				if(si_read_dword(src,rec_end,&tpos,&offset) || offset > rec_end - base)
+					return(LVP_EC_STRUCT_FORMAT);
+				if(len + 16 >= LVP_STRUCT_MAX_PATH)
+					return(LVP_EC_STRUCT_FORMAT);
+				int elen = len + sprintf_s(&path[len],LVP_STRUCT_MAX_PATH - len,"{%d}",e + 1);
+				int ret = si_parse_stream(si,src,base + offset,rec_end,path,elen,id,depth + 1);
+				if(ret)
+					return(ret);
+			}
+		}
+
+		pos = rec_end;
+	}
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Build hash table of item paths, returns non-zero if allocation failed.
+//---------------------------------------------------------------------------
+static int si_build_hash(TLVPStructIndex *si)
+{
+	si->hash_size = 16;
+	while(si->hash_size < 2*si->count)
+		si->hash_size *= 2;
+	si->hash = (int*)malloc(si->hash_size*sizeof(int));
+	if(!si->hash)
+		return(1);
+	memset((void*)si->hash,0xFF,si->hash_size*sizeof(int));
+
+	// open addressing with linear probing, first item of duplicate paths wins
+	for(int k = 0;k < si->count;k++)
+	{
+		const char *path = &si->paths[si->items[k].path];
+		int len = si->items[k].path_len;
+		DWORD h = si_hash(path,len) & (si->hash_size - 1);
+		while(si->hash[h] >= 0)
+		{
+			TLVPStructItem *it = &si->items[si->hash[h]];
+			if(it->path_len == len && !memcmp((void*)&si->paths[it->path],(void*)path,len))
+				break;
+			h = (h + 1) & (si->hash_size - 1);
+		}
+		if(si->hash[h] < 0)
+			si->hash[h] = k;
+	}
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Loose structure index.
+//  *index: structure index handle
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_free(TLVPStructIndex *index)
+{
+	if(!index)
+		return(LVP_EC_NO_BUF);
+
+	if(index->items)
+		free((void*)index->items);
+	if(index->paths)
+		free((void*)index->paths);
+	if(index->hash)
+		free((void*)index->hash);
+	free((void*)index);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Parse structure stream (see golpi_conv_struct()) and build index of its items.
+//  *src: structure stream
+//  srclen: structure stream size [B]
+//  **index: returns structure index handle, loose it by proc_struct_index_free()
+//  *count: returns items count (optional)
+//
+// Items are indexed in order of the stream, i.e. each array item is followed by
+// items of its element streams.
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_create(char *src,__int32 srclen,TLVPStructIndex **index,__int32 *count)
+{
+	if(count)
+		*count = 0;
+	if(!src || !index)
+		return(LVP_EC_NO_BUF);
+	*index = NULL;
+
+	TLVPStructIndex *si = (TLVPStructIndex*)malloc(sizeof(TLVPStructIndex));
+	if(!si)
+		return(LVP_EC_STRUCT_ALLOC);
+	memset((void*)si,0,sizeof(TLVPStructIndex));
+
+	// parse stream
+	char path[LVP_STRUCT_MAX_PATH];
+	int ret = si_parse_stream(si,src,0,srclen,path,0,-1,0);
+	if(!ret && si_build_hash(si))
+		ret = LVP_EC_STRUCT_ALLOC;
+	if(ret)
+	{
+		proc_struct_index_free(si);
+		return(ret);
+	}
+
+	*index = si;
+	if(count)
+		*count = si->count;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Find item of structure index by its path.
+//  *index: structure index handle
+//  *path: item path (null terminated string)
+//  *item: returns item index
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_find(TLVPStructIndex *index,char *path,__int32 *item)
+{
+	if(item)
+		*item = -1;
+	if(!index || !path || !item)
+		return(LVP_EC_NO_BUF);
+
+	int len = (int)strnlen_s(path,LVP_STRUCT_MAX_PATH);
+	DWORD h = si_hash(path,len) & (index->hash_size - 1);
+	while(index->hash[h] >= 0)
+	{
+		TLVPStructItem *it = &index->items[index->hash[h]];
+		if(it->path_len == len && !memcmp((void*)&index->paths[it->path],(void*)path,len))
+		{
+			*item = index->hash[h];
+			return(0);
+		}
+		h = (h + 1) & (index->hash_size - 1);
+	}
+
+	return(LVP_EC_STRUCT_NOT_FOUND);
+}
+
+//---------------------------------------------------------------------------
+// Get item record of structure index.
+//  *index: structure index handle
+//  item: item index
+//  *type: returns item type (0bC000TTTT, see golpi_conv_struct()) (optional)
+//  *rows: returns rows count (optional)
+//  *cols: returns columns count (optional)
+//  *offset: returns offset of item data in the stream [B] (optional)
+//  *size: returns item data size [B] (optional)
+//  *parent: returns index of parent array item, -1 for top level items (optional)
+//
+// Data of array item are table of element offsets followed by element streams.
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_item(TLVPStructIndex *index,__int32 item,__int32 *type,__int32 *rows,__int32 *cols,__int32 *offset,__int32 *size,__int32 *parent)
+{
+	if(!index)
+		return(LVP_EC_NO_BUF);
+	if(item < 0 || item >= index->count)
+		return(LVP_EC_STRUCT_NOT_FOUND);
+
+	TLVPStructItem *it = &index->items[item];
+	if(type)
+		*type = it->type;
+	if(rows)
+		*rows = it->rows;
+	if(cols)
+		*cols = it->cols;
+	if(offset)
+		*offset = it->offset;
+	if(size)
+		*size = it->size;
+	if(parent)
+		*parent = it->parent;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Get path of item of structure index.
+//  *index: structure index handle
+//  item: item index
+//  *path: path string buffer
+//  maxlen: size of path string buffer
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_path(TLVPStructIndex *index,__int32 item,char *path,__int32 maxlen)
+{
+	if(!index || !path || maxlen < 1)
+		return(LVP_EC_NO_BUF);
+	if(item < 0 || item >= index->count)
+		return(LVP_EC_STRUCT_NOT_FOUND);
+
+	TLVPStructItem *it = &index->items[item];
+	strncpy_s(path,maxlen,&index->paths[it->path],maxlen - 1);
+	if(it->path_len >= maxlen)
+		return(LVP_EC_SMALL_BUF);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Copy data of item of structure index.
+//  *index: structure index handle
+//  *src: structure stream the index was created from
+//  srclen: structure stream size [B]
+//  item: item index
+//  *dst: destination buffer
+//  dstlen: destination buffer size [B]
+//  *dstret: returns item data size [B] (optional)
+//
+// Data are copied as they are in the stream (little endian, complex elements
+// as real and imaginary part pairs).
+//---------------------------------------------------------------------------
+__int32 proc_struct_index_copy(TLVPStructIndex *index,char *src,__int32 srclen,__int32 item,char *dst,__int32 dstlen,__int32 *dstret)
+{
+	if(dstret)
+		*dstret = 0;
+	if(!index || !src)
+		return(LVP_EC_NO_BUF);
+	if(item < 0 || item >= index->count)
+		return(LVP_EC_STRUCT_NOT_FOUND);
+
+	TLVPStructItem *it = &index->items[item];
+	if(it->offset + it->size > srclen)
+		return(LVP_EC_STRUCT_FORMAT);
+	if(it->size && (!dst || dstlen < it->size))
+		return(LVP_EC_STRUCT_SMALL_BUF);
+
+	if(it->size)
+		memcpy((void*)dst,(void*)&src[it->offset],it->size);
+	if(dstret)
+		*dstret = it->size;
+
+	return(0);
+}
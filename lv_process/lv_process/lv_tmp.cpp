@@ -0,0 +1,211 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - temporary files pool
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Pool of temporary files for file transfer mode of GOLPI. Files are created with FILE_ATTRIBUTE_TEMPORARY,
+// so the system keeps their content in the cache and does not write it to the disk unless it runs out of
+// memory. Files are created once, preallocated and reused for each transfer, then deleted when the pool is
+// freed. FILE_FLAG_DELETE_ON_CLOSE cannot be used as the files are opened by Octave, which does not share
+// the delete access.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// temporary file name prefix
+#define TMP_PREFIX "lvp"
+
+
+//---------------------------------------------------------------------------
+// Truncate file of the pool and preallocate its space.
+//---------------------------------------------------------------------------
+static int tmp_reset(TLVPTmpFile *tf,__int64 size)
+{
+	LARGE_INTEGER zero;
+	zero.QuadPart = 0;
+	if(!SetFilePointerEx(tf->hfile,zero,NULL,FILE_BEGIN) || !SetEndOfFile(tf->hfile))
+		return(LVP_EC_TMP_CREATE);
+
+	// preallocation is just a hint, file size stays zero
+	if(size > tf->size)
+		tf->size = size;
+	FILE_ALLOCATION_INFO alloc;
+	alloc.AllocationSize.QuadPart = tf->size;
+	SetFileInformationByHandle(tf->hfile,FileAllocationInfo,(LPVOID)&alloc,sizeof(alloc));
+
+	return(0);
+}
+
+
+//---------------------------------------------------------------------------
+// Create pool of temporary files.
+//  *folder: folder of the files (null terminated string), empty for system temp folder (optional)
+//  count: files count (1 to LVP_TMP_MAX_FILES)
+//  size: initially preallocated size of each file [B]
+//  **pool: returns pool handle, loose it by proc_tmp_pool_free()
+//---------------------------------------------------------------------------
+__int32 proc_tmp_pool_create(char *folder,__int32 count,__int32 size,TLVPTmpPool **pool)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+	*pool = NULL;
+	if(count < 1 || count > LVP_TMP_MAX_FILES || size < 0)
+		return(LVP_EC_TMP_INVALID);
+
+	TLVPTmpPool *tp = (TLVPTmpPool*)malloc(sizeof(TLVPTmpPool));
+	if(!tp)
+		return(LVP_EC_TMP_ALLOC);
+	memset((void*)tp,0,sizeof(TLVPTmpPool));
+	InitializeCriticalSection(&tp->cs);
+
+	// files folder
+	char dir[MAX_PATH];
+	if(folder && *folder)
+		strcpy_s(dir,MAX_PATH,folder);
+	else if(!GetTempPathA(MAX_PATH,dir))
+	{
+		proc_tmp_pool_free(tp);
+		return(LVP_EC_TMP_CREATE);
+	}
+
+	for(int k = 0;k < count;k++)
+	{
+		TLVPTmpFile *tf = &tp->files[k];
+		tf->hfile = INVALID_HANDLE_VALUE;
+		if(!GetTempFileNameA(dir,TMP_PREFIX,0,tf->path))
+		{
+			proc_tmp_pool_free(tp);
+			return(LVP_EC_TMP_CREATE);
+		}
+		tp->count++;
+		tf->hfile = CreateFileA(tf->path,GENERIC_READ|GENERIC_WRITE,FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,NULL,CREATE_ALWAYS,FILE_ATTRIBUTE_TEMPORARY|FILE_ATTRIBUTE_NOT_CONTENT_INDEXED,NULL);
+		if(tf->hfile == INVALID_HANDLE_VALUE || tmp_reset(tf,size))
+		{
+			proc_tmp_pool_free(tp);
+			return(LVP_EC_TMP_CREATE);
+		}
+	}
+
+	*pool = tp;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Loose pool of temporary files and delete the files.
+//  *pool: pool handle
+//---------------------------------------------------------------------------
+__int32 proc_tmp_pool_free(TLVPTmpPool *pool)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+
+	for(int k = 0;k < pool->count;k++)
+	{
+		TLVPTmpFile *tf = &pool->files[k];
+		if(tf->hfile != INVALID_HANDLE_VALUE)
+			CloseHandle(tf->hfile);
+		DeleteFileA(tf->path);
+	}
+	DeleteCriticalSection(&pool->cs);
+	free((void*)pool);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Get free temporary file of the pool.
+//  *pool: pool handle
+//  size: expected data size to preallocate [B]
+//  *file: returns file index
+//  *path: file path buffer (optional)
+//  maxlen: size of file path buffer
+//
+// File is empty and it is reserved till proc_tmp_release(). Its path can be
+// passed to Octave or written by proc_tmp_write_matrix().
+//---------------------------------------------------------------------------
+__int32 proc_tmp_acquire(TLVPTmpPool *pool,__int32 size,__int32 *file,char *path,__int32 maxlen)
+{
+	if(!pool || !file)
+		return(LVP_EC_NO_BUF);
+	*file = -1;
+
+	EnterCriticalSection(&pool->cs);
+	int k;
+	for(k = 0;k < pool->count && pool->files[k].busy;k++);
+	if(k < pool->count)
+		pool->files[k].busy = 1;
+	LeaveCriticalSection(&pool->cs);
+	if(k >= pool->count)
+		return(LVP_EC_TMP_BUSY);
+
+	TLVPTmpFile *tf = &pool->files[k];
+	int ret = 0;
+	if(path && maxlen < (int)strlen(tf->path) + 1)
+		ret = LVP_EC_SMALL_BUF;
+	else
+		ret = tmp_reset(tf,size);
+	if(ret)
+	{
+		tf->busy = 0;
+		return(ret);
+	}
+	if(path)
+		strcpy_s(path,maxlen,tf->path);
+	*file = k;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Return temporary file to the pool.
+//  *pool: pool handle
+//  file: file index
+//---------------------------------------------------------------------------
+__int32 proc_tmp_release(TLVPTmpPool *pool,__int32 file)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+	if(file < 0 || file >= pool->count)
+		return(LVP_EC_TMP_INVALID);
+
+	EnterCriticalSection(&pool->cs);
+	pool->files[file].busy = 0;
+	LeaveCriticalSection(&pool->cs);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Append real or complex matrix to temporary file (see proc_mat_write()).
+//  *pool: pool handle
+//  file: file index
+//  *name: variable name (null terminated string)
+//  *data: matrix data (complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  rowmajor: non-zero if data are row-major (LabVIEW 2D array), else column-major
+//  format: file format LVP_MAT_FORMAT_xxx
+//---------------------------------------------------------------------------
+__int32 proc_tmp_write_matrix(TLVPTmpPool *pool,__int32 file,char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,__int32 rowmajor,__int32 format)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+	if(file < 0 || file >= pool->count || !pool->files[file].busy)
+		return(LVP_EC_TMP_INVALID);
+	if(num_check_name(name) || rows < 0 || cols < 0)
+		return(LVP_EC_NUM_NAME);
+	if(!data && rows*cols)
+		return(LVP_EC_NO_BUF);
+	if(format != LVP_MAT_FORMAT_MAT4 && format != LVP_MAT_FORMAT_OCTAVE)
+		return(LVP_EC_MAT_FORMAT);
+
+	return(mat_write_file(pool->files[file].hfile,name,data,rows,cols,cplx,rowmajor,format));
+}
@@ -0,0 +1,329 @@
+//---------------------------------------------------------------------------------------------------------------------
+// LV Process DLL - pool of pre-initialized instances
+//---------------------------------------------------------------------------------------------------------------------
+// Author: Stanislav Maslan
+// E-mail: s.maslan@seznam.cz, smaslan@cmi.cz
+//
+// This file is part of the LV Process DLL, see lv_proc.cpp for license.
+//
+// Startup of Octave including loading of the packages takes seconds. The pool keeps several instances started
+// in advance by a refill thread, each one already done with its initialization script, so proc_warm_acquire()
+// returns running instance immediately. The taken instance is replaced by new one in background. Windows has
+// no fork(), so the instances cannot share memory of single initialized template, each one runs its own init.
+//---------------------------------------------------------------------------------------------------------------------
+
+#include <windows.h>
+#include <stdio.h>
+
+#define _LVPDLLEXPORT
+#include "lv_proc.h"
+
+// refill thread check interval of instances being initialized [ms]
+#define WARM_POLL_TIME 10
+// refill thread delay after failed instance start [ms]
+#define WARM_RETRY_TIME 1000
+// maximum wait interval of proc_warm_acquire() between checks of the pool
+#define WARM_WAIT_SLICE 50
+// initialization done command (mark is not in the command text, so echo of command is not detected as mark)
+#define WARM_MARK_CMD "printf(\"%s%s\\n\",\"GOLPI\",\"warm\");fflush(stdout);\n"
+
+
+//---------------------------------------------------------------------------
+// Pool instances: close instance
+//---------------------------------------------------------------------------
+static void warm_close(TLVPWarmProc *wp)
+{
+	if(wp->proc.hproc)
+		proc_terminate(&wp->proc,1000);
+	proc_cleanup(&wp->proc);
+	wp->state = WARM_STATE_FREE;
+}
+
+//---------------------------------------------------------------------------
+// Pool instances: start instance and its initialization, returns 0 if ok
+//---------------------------------------------------------------------------
+static int warm_start(TLVPWarmPool *pool,TLVPWarmProc *wp)
+{
+	int ret = proc_create(&wp->proc,pool->folder,pool->cmd,pool->sterr,1);
+	if(ret)
+		return(ret);
+
+	char nl[] = "\n";
+	char mark[] = WARM_MARK_CMD;
+	int written;
+	if(pool->init && *pool->init)
+	{
+		int len = strlen(pool->init);
+		ret = proc_write_stdin(&wp->proc,pool->init,len,&written);
+		if(!ret && written != len)
+			ret = LVP_EC_WRITE_INCOMPLETE;
+		if(!ret)
+			ret = proc_write_stdin(&wp->proc,nl,1,&written);
+	}
+	if(!ret)
+	{
+		int len = strlen(mark);
+		ret = proc_write_stdin(&wp->proc,mark,len,&written);
+		if(!ret && written != len)
+			ret = LVP_EC_WRITE_INCOMPLETE;
+	}
+	if(ret)
+	{
+		warm_close(wp);
+		return(ret);
+	}
+
+	wp->match = 0;
+	QueryPerformanceCounter(&wp->t_start);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Pool instances: check initialization progress, returns 1 if done, 0 if
+// not yet or error code
+//---------------------------------------------------------------------------
+static int warm_check(TLVPWarmPool *pool,TLVPWarmProc *wp,LARGE_INTEGER *freq)
+{
+	// search output for initialization done mark (rest of output is not needed)
+	char buf[256];
+	int read;
+	do{
+		fifo_read(&wp->proc,buf,sizeof(buf),&read);
+		for(int k = 0; k < read; k++)
+		{
+			if(buf[k] == WARM_MARK[wp->match])
+				wp->match++;
+			else
+				wp->match = (buf[k] == WARM_MARK[0]);
+			if(wp->match == WARM_MARK_LEN)
+			{
+				fifo_clear(&wp->proc);
+				return(1);
+			}
+		}
+	}while(read);
+
+	DWORD ec;
+	if(GetExitCodeProcess(wp->proc.hproc,&ec) && ec != STILL_ACTIVE)
+		return(LVP_EC_EXITED);
+
+	LARGE_INTEGER t_new;
+	QueryPerformanceCounter(&t_new);
+	if(time_get_ms(&wp->t_start,&t_new,freq) >= pool->timeout)
+		return(LVP_EC_TIMEOUT);
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Pool instances: refill thread
+//---------------------------------------------------------------------------
+static DWORD WINAPI warm_thread(LPVOID lpParam)
+{
+	TLVPWarmPool *pool = (TLVPWarmPool*)lpParam;
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+
+	while(!pool->exit)
+	{
+		int wait = WARM_POLL_TIME;
+		for(int k = 0; k < pool->count && !pool->exit; k++)
+		{
+			// only ready instances are taken by caller, so free and initializing ones are owned by this thread
+			TLVPWarmProc *wp = &pool->procs[k];
+			if(wp->state == WARM_STATE_FREE)
+			{
+				int ret = warm_start(pool,wp);
+				EnterCriticalSection(&pool->cs);
+				if(ret)
+					pool->error = ret;
+				else
+					wp->state = WARM_STATE_INIT;
+				LeaveCriticalSection(&pool->cs);
+				if(ret)
+					wait = WARM_RETRY_TIME;
+			}
+			else if(wp->state == WARM_STATE_INIT)
+			{
+				int ret = warm_check(pool,wp,&freq);
+				if(ret > 0)
+				{
+					EnterCriticalSection(&pool->cs);
+					wp->state = WARM_STATE_READY;
+					// pool recovered, error of older instance is not reported anymore
+					pool->error = 0;
+					WakeAllConditionVariable(&pool->ready);
+					LeaveCriticalSection(&pool->cs);
+				}
+				else if(ret)
+				{
+					warm_close(wp);
+					EnterCriticalSection(&pool->cs);
+					pool->error = LVP_EC_WARM_INIT;
+					LeaveCriticalSection(&pool->cs);
+					wait = WARM_RETRY_TIME;
+				}
+			}
+			else
+			{
+				// ready instance died in the pool
+				EnterCriticalSection(&pool->cs);
+				DWORD ec;
+				int died = wp->state == WARM_STATE_READY && GetExitCodeProcess(wp->proc.hproc,&ec) && ec != STILL_ACTIVE;
+				if(died)
+					wp->state = WARM_STATE_INIT;
+				LeaveCriticalSection(&pool->cs);
+				if(died)
+					warm_close(wp);
+			}
+		}
+		WaitForSingleObject(pool->wake,wait);
+	}
+
+	return(0);
+}
+
+
+//---------------------------------------------------------------------------
+// Create pool of pre-initialized process instances. Instances are started
+// in background by proc_create() (hidden), each runs the initialization
+// script (e.g. "pkg load golpi") and waits in the pool. proc_warm_acquire()
+// then takes ready instance immediately and the pool starts new one in its
+// place, so the startup time is hidden from the caller.
+//  *folder: working directory for the processes
+//  *cmd: the command to execute (see proc_create())
+//  sterr: write 1 to combine stderr to stdout
+//  *init: initialization script (null terminated string, optional)
+//  count: instances count to keep ready (1 to LVP_WARM_MAX_PROCS)
+//  timeout: initialization timeout of instance [ms]
+//  **pool: returns pool handle, loose it by proc_warm_pool_free()
+//---------------------------------------------------------------------------
+__int32 proc_warm_pool_create(char *folder,char *cmd,__int32 sterr,char *init,__int32 count,__int32 timeout,TLVPWarmPool **pool)
+{
+	if(!pool || !cmd)
+		return(LVP_EC_NO_BUF);
+	*pool = NULL;
+	if(count < 1 || count > LVP_WARM_MAX_PROCS)
+		return(LVP_EC_WARM_INVALID);
+
+	TLVPWarmPool *wp = (TLVPWarmPool*)malloc(sizeof(TLVPWarmPool));
+	if(!wp)
+		return(LVP_EC_WARM_ALLOC);
+	memset((void*)wp,0,sizeof(TLVPWarmPool));
+	InitializeCriticalSection(&wp->cs);
+	wp->count = count;
+	wp->sterr = sterr;
+	wp->timeout = timeout;
+
+	// local copies of strings (CreateProcessA() may modify command string)
+	wp->folder = (folder && *folder)?_strdup(folder):NULL;
+	wp->cmd = _strdup(cmd);
+	wp->init = init?_strdup(init):NULL;
+	wp->wake = CreateEvent(NULL,false,false,NULL);
+	InitializeConditionVariable(&wp->ready);
+	if(((folder && *folder) && !wp->folder) || !wp->cmd || (init && !wp->init) || !wp->wake)
+	{
+		proc_warm_pool_free(wp);
+		return(LVP_EC_WARM_ALLOC);
+	}
+
+	// start refill thread
+	wp->th = CreateThread(NULL,0,warm_thread,(PVOID)wp,0,NULL);
+	if(!wp->th)
+	{
+		proc_warm_pool_free(wp);
+		return(LVP_EC_WARM_ALLOC);
+	}
+
+	*pool = wp;
+
+	return(0);
+}
+
+//---------------------------------------------------------------------------
+// Take ready instance from the pool. Instance is moved to the process handle,
+// so it is used and closed as if it was created by proc_create().
+//  *pool: pool handle
+//  *proc: lv process instance handle to be filled
+//  timeout: timeout to wait for ready instance [ms]
+//---------------------------------------------------------------------------
+__int32 proc_warm_acquire(TLVPWarmPool *pool,TLVPHndl *proc,__int32 timeout)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+	if(!proc)
+		return(LVP_EC_NO_PROC);
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	LARGE_INTEGER t_start;
+	QueryPerformanceCounter(&t_start);
+	EnterCriticalSection(&pool->cs);
+	do{
+		int init = 0;
+		for(int k = 0; k < pool->count; k++)
+		{
+			TLVPWarmProc *wp = &pool->procs[k];
+			if(wp->state == WARM_STATE_READY)
+			{
+				// readout thread uses its own copy of handle, so the handle may be moved
+				memcpy((void*)proc,(void*)&wp->proc,sizeof(TLVPHndl));
+				memset((void*)&wp->proc,0,sizeof(TLVPHndl));
+				wp->state = WARM_STATE_FREE;
+				LeaveCriticalSection(&pool->cs);
+				SetEvent(pool->wake);
+
+				debug_printf(proc,"process instance taken from pool\n");
+
+				return(0);
+			}
+			init |= (wp->state == WARM_STATE_INIT);
+		}
+
+		LARGE_INTEGER t_new;
+		QueryPerformanceCounter(&t_new);
+		int left = timeout - time_get_ms(&t_start,&t_new,&freq);
+		if(left <= 0)
+		{
+			int error = pool->error;
+			LeaveCriticalSection(&pool->cs);
+			return((error && !init)?error:LVP_EC_TIMEOUT);
+		}
+		SleepConditionVariableCS(&pool->ready,&pool->cs,min(left,WARM_WAIT_SLICE));
+	}while(1);
+}
+
+//---------------------------------------------------------------------------
+// Loose pool and terminate instances not taken from the pool.
+//  *pool: pool handle
+//---------------------------------------------------------------------------
+__int32 proc_warm_pool_free(TLVPWarmPool *pool)
+{
+	if(!pool)
+		return(LVP_EC_NO_BUF);
+
+	// stop refill thread
+	if(pool->th)
+	{
+		pool->exit = 1;
+		SetEvent(pool->wake);
+		WaitForSingleObject(pool->th,INFINITE);
+		CloseHandle(pool->th);
+	}
+
+	for(int k = 0; k < LVP_WARM_MAX_PROCS; k++)
+		if(pool->procs[k].state != WARM_STATE_FREE)
+			warm_close(&pool->procs[k]);
+
+	if(pool->wake)
+		CloseHandle(pool->wake);
+	free((void*)pool->folder);
+	free((void*)pool->cmd);
+	free((void*)pool->init);
+	DeleteCriticalSection(&pool->cs);
+	free((void*)pool);
+
+	return(0);
+}
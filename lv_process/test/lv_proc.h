@@ -65,11 +65,23 @@
 //   write_pipe_buffer_size = 0
 //   read_pipe_buffer_size = 0
 //   
+//   [PROCESS]
+//   ;CPU affinity mask of the process, hexadecimal as 0x... possible (0: system decides)
+//   affinity_mask = 0
+//   ;NUMA node of the process, used when affinity_mask is 0 (-1: system decides)
+//   numa_node = -1
+//   ;process priority class IDLE, BELOW_NORMAL, NORMAL, ABOVE_NORMAL, HIGH or REALTIME (empty: system decides)
+//   priority_class =
+//   
 //   [READ]
 //   ;read thread priority (0: normal, <-15,15> range possible)
 //   thread_priority = +1
 //   ;read thread idle time if no data in read pipe (1 to 100 ms)
 //   thread_idle_time = 1
+//   ;read thread CPU affinity mask (0: same as the process)
+//   thread_affinity_mask = 0
+//   ;MMCSS task of read thread, e.g. Pro Audio (empty: not registered)
+//   thread_mmcss_task =
 //   
 //   [CONSOLE]
 //   ;always create console (1 - overides proc_create(..., hide) parameter)
@@ -117,6 +129,158 @@
 #define DllExport __declspec(dllimport) 
 #endif
 
+// --- GOLPI Bitstream receiver (decoded by stdout readout thread) ---
+#define BS_MAX_DIMS 64 /*maximum dimensions count of bitstream*/
+#define BS_HDR_MAX_LEN (7 + 2 + 1 + 8 + 8*BS_MAX_DIMS) /*maximum header size*/
+typedef struct{
+	CRITICAL_SECTION cs;
+	HANDLE done; /*set when armed stream was received or failed*/
+	int state; /*BS_STATE_xxx*/
+	int error; /*error code of failed receive*/
+	int skip_lf; /*skip stream terminating '\n'*/
+	char hdr[BS_HDR_MAX_LEN]; /*received header*/
+	int hdr_len; /*received header size*/
+	int hdr_size; /*expected header size*/
+	int type; /*data type with coding flag cleared*/
+	int elsize; /*element size*/
+	int coding_8bit; /*8-bit coding used*/
+	int ndims; /*dimensions count*/
+	int dims[BS_MAX_DIMS]; /*dimensions*/
+	char *data; /*decoded data buffer*/
+	int len; /*decoded data size*/
+	int filled; /*decoded bytes count*/
+	char part[8]; /*incomplete 7-bit group or escape sequence*/
+	int part_len;
+	int ssse3; /*SSSE3 is available*/
+}TLVPBitstream;
+
+// --- GOLPI structure stream index (see proc_struct_index_create()) ---
+#define LVP_STRUCT_MAX_PATH 1024 /*maximum item path length*/
+#define LVP_STRUCT_MAX_DEPTH 64 /*maximum nesting of structure streams*/
+typedef struct{
+	int path; /*offset of item path in paths pool*/
+	int path_len; /*item path length*/
+	int type; /*item type*/
+	int rows; /*rows count*/
+	int cols; /*columns count*/
+	int offset; /*offset of item data in the stream*/
+	int size; /*item data size*/
+	int parent; /*index of parent array item (-1 for top level)*/
+}TLVPStructItem;
+typedef struct{
+	TLVPStructItem *items; /*items in order of the stream*/
+	int count;
+	int items_cap;
+	char *paths; /*paths pool (null terminated strings)*/
+	int paths_len;
+	int paths_cap;
+	int *hash; /*hash table of paths (item indices, -1 for empty)*/
+	int hash_size;
+}TLVPStructIndex;
+
+// --- MAT file (see proc_mat_open()) ---
+#define LVP_MAT_MAX_NAME 64 /*maximum variable name length including '\0'*/
+#define LVP_MAT_FORMAT_MAT4 0 /*MAT-4 file*/
+#define LVP_MAT_FORMAT_OCTAVE 1 /*Octave binary file*/
+typedef struct{
+	char name[LVP_MAT_MAX_NAME]; /*variable name*/
+	int type; /*data precision*/
+	int text; /*text matrix*/
+	int rows; /*rows count*/
+	int cols; /*columns count*/
+	int cplx; /*complex data*/
+	const char *re; /*real part data in mapped file*/
+	const char *im; /*imaginary part data in mapped file (NULL for real data)*/
+}TLVPMatVar;
+typedef struct{
+	HANDLE hfile;
+	HANDLE hmap;
+	const char *data; /*mapped file content*/
+	__int64 size; /*file size*/
+	TLVPMatVar *vars; /*variables in order of the file*/
+	int count;
+	int cap;
+}TLVPMatFile;
+
+// --- temporary files pool (see proc_tmp_pool_create()) ---
+#define LVP_TMP_MAX_FILES 16 /*maximum files count of pool*/
+typedef struct{
+	HANDLE hfile;
+	char path[MAX_PATH]; /*file path*/
+	__int64 size; /*preallocated size*/
+	int busy; /*file is acquired*/
+}TLVPTmpFile;
+typedef struct{
+	CRITICAL_SECTION cs;
+	TLVPTmpFile files[LVP_TMP_MAX_FILES];
+	int count;
+}TLVPTmpPool;
+
+// --- GOLPI binary frames receiver (demultiplexed from stdout by readout thread) ---
+#define FRAME_OUT_ID "\x1b" "GpFr" /*frame start mark*/
+#define FRAME_OUT_ID_LEN 5
+#define FRAME_OUT_HEAD_SIZE (FRAME_OUT_ID_LEN + 1 + 1 + 4) /*start mark, channel, flags, data size*/
+typedef struct TLVPFrameMsg{
+	struct TLVPFrameMsg *next;
+	int channel; /*message channel*/
+	char *data; /*message data*/
+	int size; /*message size*/
+	int cap; /*allocated data size*/
+}TLVPFrameMsg;
+typedef struct{
+	CRITICAL_SECTION cs;
+	CONDITION_VARIABLE arrived; /*signalled when message is queued or dropped*/
+	int state; /*FRAME_STATE_xxx*/
+	int error; /*error code of discarded message*/
+	char hdr[FRAME_OUT_HEAD_SIZE]; /*received header*/
+	int hdr_len; /*received header size*/
+	int flags; /*flags of current frame*/
+	int remain; /*data bytes left of current frame*/
+	int drop; /*discard rest of current message*/
+	TLVPFrameMsg *msg; /*message being received*/
+	TLVPFrameMsg *first; /*queue of received messages*/
+	TLVPFrameMsg *last;
+}TLVPFrameRx;
+
+// --- GOLPI tagged requests (output of golpi_dispatch() routed by readout thread) ---
+#define REQ_MARK_ID "\x1b" "GpRq" /*request marker start*/
+#define REQ_MARK_ID_LEN 5
+#define REQ_MARK_MAX 32 /*maximum marker line length*/
+#define LVP_REQ_MAX_SLOTS 64 /*maximum requests in flight*/
+#define LVP_QUEUE_LANES 3 /*command queue lanes LVP_LANE_xxx*/
+typedef struct{
+	int id; /*request id*/
+	int state; /*REQ_STATE_xxx*/
+	int status; /*command status (0 - ok, 1 - error)*/
+	int lost; /*part of output lost*/
+	int cancel; /*cancelled by caller, discard output*/
+	int error; /*LVP_EC_xxx of queued command write*/
+	int lane; /*command queue lane*/
+	char *cmd; /*queued command (not written yet)*/
+	int cmd_len; /*queued command size*/
+	char *data; /*received output*/
+	int size; /*output size*/
+	int cap; /*allocated data size*/
+}TLVPReqSlot;
+typedef struct{
+	CRITICAL_SECTION cs;
+	CRITICAL_SECTION wr_cs; /*serializes writes of commands*/
+	CONDITION_VARIABLE done; /*signalled when request is done*/
+	TLVPReqSlot slots[LVP_REQ_MAX_SLOTS];
+	int seq; /*last request id*/
+	int pending; /*requests waiting for output*/
+	int active; /*slot receiving output (-1 for none)*/
+	char mark[REQ_MARK_MAX]; /*received marker*/
+	int mark_len; /*received marker size*/
+	HANDLE q_th; /*command queue thread (started by first queued command)*/
+	HANDLE q_wake; /*wakes command queue thread*/
+	int q_exit; /*command queue thread exit request*/
+	int q_inflight; /*maximum commands written to process*/
+	int q_weight[LVP_QUEUE_LANES]; /*commands of lane in turn*/
+	int q_credit[LVP_QUEUE_LANES]; /*commands left to lane in its turn*/
+	int q_lane; /*lane in turn*/
+}TLVPReqRx;
+
 // --- process stdout fifo ---
 typedef struct{
   HANDLE th;
@@ -128,8 +292,21 @@ typedef struct{
 	CRITICAL_SECTION cs;
 	int c_stdout_bytes;
 	int c_stdin_bytes;
+	TLVPBitstream *bs;
+	TLVPFrameRx *fr;
+	TLVPReqRx *rq;
 }TLVPFifo;
 
+// --- process scheduling (see proc_create_ex()) ---
+#define LVP_MMCSS_MAX 64 /*maximum MMCSS task name length including '\0'*/
+#define LVP_PRIO_DEFAULT 0 /*priority class by ini or system*/
+#define LVP_PRIO_IDLE 1
+#define LVP_PRIO_BELOW_NORMAL 2
+#define LVP_PRIO_NORMAL 3
+#define LVP_PRIO_ABOVE_NORMAL 4
+#define LVP_PRIO_HIGH 5
+#define LVP_PRIO_REALTIME 6
+
 // --- process instance handles structure ---
 typedef struct{
 	// process and main thread handles and ids
@@ -155,8 +332,33 @@ typedef struct{
 	wchar_t dbg_path[MAX_PATH];
 	// config
   int read_th_idle;
+	wchar_t read_th_mmcss[LVP_MMCSS_MAX]; /*MMCSS task of readout thread (empty for none)*/
 }TLVPHndl;
 
+// --- pool of pre-initialized process instances (see proc_warm_pool_create()) ---
+#define LVP_WARM_MAX_PROCS 16 /*maximum instances count of pool*/
+typedef struct{
+	TLVPHndl proc; /*process instance*/
+	int state; /*WARM_STATE_xxx*/
+	int match; /*matched size of initialization done mark*/
+	LARGE_INTEGER t_start; /*start time of initialization*/
+}TLVPWarmProc;
+typedef struct{
+	CRITICAL_SECTION cs;
+	HANDLE th; /*refill thread*/
+	HANDLE wake; /*refill thread wakeup event*/
+	CONDITION_VARIABLE ready; /*signalled when instance is ready*/
+	int exit; /*refill thread exit request*/
+	int error; /*last instance start error*/
+	int count; /*instances count*/
+	int sterr; /*combine stderr to stdout*/
+	int timeout; /*initialization timeout [ms]*/
+	char *folder; /*working directory*/
+	char *cmd; /*process command*/
+	char *init; /*initialization script*/
+	TLVPWarmProc procs[LVP_WARM_MAX_PROCS];
+}TLVPWarmPool;
+
 
 #ifdef _LVPDLLEXPORT
 // --- configuration ---
@@ -170,6 +372,11 @@ typedef struct{
 	WORD console_clr_stdout;
 	int write_pipe_buf;
  	int read_pipe_buf;
+	unsigned __int64 affinity;
+	int numa_node;
+	DWORD priority_class;
+	unsigned __int64 th_affinity;
+	wchar_t th_mmcss[LVP_MMCSS_MAX];
 }TCfg;
 #endif
 
@@ -179,6 +386,7 @@ typedef struct{
 #define LVP_EC_CANT_CREATE_PROC 0x0003 /*can't create process*/
 #define LVP_EC_NO_EXIT 0x0004 /*process is still running*/
 #define LVP_EC_EXIT_TO 0x0005 /*exit code query timeout*/
+#define LVP_EC_AFFINITY 0x0006 /*invalid CPU affinity or NUMA node*/
 #define LVP_EC_NO_BUF 0x0010 /*no data buffer assigned*/
 #define LVP_EC_NO_LEN 0x0011 /*data buffer has zero length*/
 #define LVP_EC_WRITE_FAIL 0x0012 /*writting to stdin pipe failed*/
@@ -191,6 +399,96 @@ typedef struct{
 #define LVP_EC_STDOUT_RD_TH_FAILED 0x0040 /*creation of stdout readout thread failed*/
 #define LVP_EC_STDOUT_FIFO_FAILED 0x0041 /*allocation of the stdout fifo buffer failed*/
 #define LVP_EC_STDOUT_EVENT_FAILED 0x0042 /*creating wakup event of the stdout fifo buffer failed*/
+#define LVP_EC_BS_HEADER 0x0050 /*invalid bitstream header*/
+#define LVP_EC_BS_INCOMPLETE 0x0051 /*incomplete bitstream data*/
+#define LVP_EC_BS_SMALL_BUF 0x0052 /*buffer to small for decoded bitstream data*/
+#define LVP_EC_BS_NOT_ARMED 0x0053 /*bitstream receive is not armed*/
+#define LVP_EC_BS_ALLOC 0x0054 /*allocation of bitstream data buffer failed*/
+#define LVP_EC_STRUCT_FORMAT 0x0060 /*invalid structure stream*/
+#define LVP_EC_STRUCT_ALLOC 0x0061 /*allocation of structure index failed*/
+#define LVP_EC_STRUCT_NOT_FOUND 0x0062 /*structure item not found*/
+#define LVP_EC_STRUCT_SMALL_BUF 0x0063 /*buffer to small for structure item data*/
+#define LVP_EC_NUM_FORMAT 0x0070 /*invalid number format*/
+#define LVP_EC_NUM_SMALL_BUF 0x0071 /*buffer to small for formatted matrix*/
+#define LVP_EC_NUM_NAME 0x0072 /*invalid variable name or matrix size*/
+#define LVP_EC_NUM_ALLOC 0x0073 /*allocation of formatting buffer failed*/
+#define LVP_EC_MAT_OPEN 0x0080 /*cannot open MAT file*/
+#define LVP_EC_MAT_FORMAT 0x0081 /*invalid or unsupported MAT file*/
+#define LVP_EC_MAT_NOT_FOUND 0x0082 /*MAT file variable not found*/
+#define LVP_EC_MAT_SMALL_BUF 0x0083 /*buffer to small for MAT file variable*/
+#define LVP_EC_MAT_ALLOC 0x0084 /*mapping of MAT file failed*/
+#define LVP_EC_MAT_WRITE 0x0085 /*writing of MAT file failed*/
+#define LVP_EC_TMP_CREATE 0x0090 /*cannot create temporary file*/
+#define LVP_EC_TMP_BUSY 0x0091 /*all temporary files are in use*/
+#define LVP_EC_TMP_INVALID 0x0092 /*invalid temporary file index or pool size*/
+#define LVP_EC_TMP_ALLOC 0x0093 /*allocation of temporary files pool failed*/
+#define LVP_EC_FRAME_NOT_READY 0x00A0 /*binary frame receiver did not respond*/
+#define LVP_EC_FRAME_SIZE 0x00A1 /*invalid binary frame size*/
+#define LVP_EC_FRAME_ALLOC 0x00A2 /*allocation of binary frame message failed*/
+#define LVP_EC_FRAME_EMPTY 0x00A3 /*no binary frame message received*/
+#define LVP_EC_FRAME_SMALL_BUF 0x00A4 /*buffer to small for binary frame message*/
+#define LVP_EC_FRAME_DISCARDED 0x00A5 /*binary frame message discarded by sender*/
+#define LVP_EC_REQ_NO_SLOT 0x00B0 /*too many requests in flight*/
+#define LVP_EC_REQ_UNKNOWN 0x00B1 /*unknown request id*/
+#define LVP_EC_REQ_SMALL_BUF 0x00B2 /*buffer to small for request output*/
+#define LVP_EC_REQ_LOST 0x00B3 /*part of request output lost*/
+#define LVP_EC_REQ_ALLOC 0x00B4 /*allocation of request command failed*/
+#define LVP_EC_QUEUE_INVALID 0x00B8 /*invalid command queue lane or setup*/
+#define LVP_EC_QUEUE_THREAD 0x00B9 /*creation of command queue thread failed*/
+#define LVP_EC_WARM_INVALID 0x00C0 /*invalid instances count of pool*/
+#define LVP_EC_WARM_ALLOC 0x00C1 /*creation of instances pool failed*/
+#define LVP_EC_WARM_INIT 0x00C2 /*initialization of pool instance failed*/
+
+// --- GOLPI Bitstream 8-bit coding (see golpi_data2bits()) ---
+#define BS_ESC_OFFSET 42 /*offset added to each byte*/
+#define BS_ESC_CHAR '=' /*escape character (escaped are NUL, LF, CR, ESC and '=')*/
+#define BS_ESC_SHIFT 64 /*offset added to escaped character*/
+// --- GOLPI Bitstream header ---
+#define BS_HDR_ID "_GpBiT_"
+#define BS_HDR_ID_LEN 7
+// --- GOLPI Bitstream receiver states ---
+#define BS_STATE_IDLE 0 /*not armed*/
+#define BS_STATE_ARMED 1 /*searching for header*/
+#define BS_STATE_HEADER 2 /*receiving header*/
+#define BS_STATE_DATA 3 /*receiving data*/
+#define BS_STATE_READY 4 /*decoded data ready*/
+#define BS_STATE_ERROR 5 /*receive failed*/
+// --- GOLPI binary frames (see golpi_stdin_receive()) ---
+#define FRAME_ID "GpFr" /*frame start mark*/
+#define FRAME_ID_LEN 4
+#define FRAME_HEAD_SIZE (FRAME_ID_LEN + 4) /*start mark and record size*/
+#define FRAME_REC_HEAD_SIZE 12 /*variable type, rows, columns*/
+#define FRAME_READY "GOLPIready\n" /*printed by Octave when it waits for frame*/
+#define FRAME_READY_LEN 11
+#define FRAME_FLAG_LAST 0x01 /*last frame of message*/
+#define FRAME_FLAG_ERROR 0x02 /*discard message*/
+// --- GOLPI binary frames receiver states ---
+#define FRAME_STATE_IDLE 0 /*searching for start mark*/
+#define FRAME_STATE_HEADER 1 /*receiving header*/
+#define FRAME_STATE_DATA 2 /*receiving data*/
+// --- GOLPI tagged requests markers (see golpi_dispatch()) ---
+#define REQ_MARK_BEGIN 'B' /*"\x1bGpRqB<id>\n" before output*/
+#define REQ_MARK_END 'E' /*"\x1bGpRqE<id> <status>\n" after output*/
+// --- GOLPI tagged requests states ---
+#define REQ_STATE_FREE 0 /*slot not used*/
+#define REQ_STATE_SENT 1 /*command written, waiting for begin marker*/
+#define REQ_STATE_RUNNING 2 /*receiving output*/
+#define REQ_STATE_DONE 3 /*end marker received*/
+#define REQ_STATE_QUEUED 4 /*command waits in command queue*/
+// --- asynchronous command states (see proc_command_poll()) ---
+#define LVP_CMD_QUEUED REQ_STATE_SENT
+#define LVP_CMD_RUNNING REQ_STATE_RUNNING
+#define LVP_CMD_DONE REQ_STATE_DONE
+// --- command queue lanes (see proc_queue_submit()) ---
+#define LVP_LANE_CONTROL 0 /*always written first, not limited by commands in flight*/
+#define LVP_LANE_NORMAL 1
+#define LVP_LANE_BULK 2
+// --- pool of pre-initialized instances ---
+#define WARM_MARK "GOLPIwarm\n" /*printed by instance when initialization is done*/
+#define WARM_MARK_LEN 10
+#define WARM_STATE_FREE 0 /*no instance*/
+#define WARM_STATE_INIT 1 /*instance is running initialization script*/
+#define WARM_STATE_READY 2 /*instance is ready*/
 
 
 #ifdef _LVPDLLEXPORT
@@ -215,6 +513,8 @@ void strip_path(wchar_t *path,int size,wchar_t **name);
 // inis
 WORD ini_parse_color(wchar_t *str,WORD clr_in,wchar_t *clr_str_out,int size);
 WORD ini_parse_color(wchar_t *str);
+DWORD ini_parse_priority(wchar_t *str);
+DWORD ini_priority_class(int prio);
 int ini_read_ini(TCfg *cfg,int *dbg);
 // stdout fifo
 int fifo_alloc(TLVPHndl *proc,int size);
@@ -225,6 +525,26 @@ int fifo_clear(TLVPHndl *proc);
 int fifo_write(TLVPHndl *proc,char *data,int towr,int *written);
 int fifo_read(TLVPHndl *proc,char *data,int tord,int *read);
 DWORD WINAPI fifo_read_thread(LPVOID lpParam);
+// bitstream receiver
+TLVPBitstream *bs_alloc(void);
+void bs_free(TLVPBitstream *bs);
+int bs_stream_process(TLVPBitstream *bs,char *buf,int len,char *text);
+int bs_read_limit(TLVPBitstream *bs);
+// binary frames receiver
+TLVPFrameRx *frame_rx_alloc(void);
+void frame_rx_free(TLVPFrameRx *fr);
+int frame_stream_process(TLVPFrameRx *fr,char *buf,int len,char *text);
+int frame_read_limit(TLVPFrameRx *fr);
+// tagged requests
+TLVPReqRx *req_rx_alloc(void);
+void req_rx_free(TLVPReqRx *rq);
+int req_stream_process(TLVPReqRx *rq,char *buf,int len,char *text);
+int req_read_limit(TLVPReqRx *rq);
+void req_queue_stop(TLVPReqRx *rq);
+// text numbers
+int num_check_name(const char *name);
+// MAT files
+int mat_write_file(HANDLE hfile,char *name,double *data,int rows,int cols,int cplx,int rowmajor,int format);
 // other
 wchar_t *fmt_capacity(wchar_t *str,int maxstr,int size);
 int peek_stdout(TLVPHndl *proc,int *exit,char *buf,int bsize,int *rread,int *rtord);
@@ -270,6 +590,22 @@ DllExport __int32 proc_handle_size(void);
 //  hide: write 1 to hide console
 DllExport __int32 proc_create(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32 hide);
 
+//---------------------------------------------------------------------------
+// Try to create process and its pipes with scheduling options. Options left
+// at default value are taken from lv_proc.ini ([PROCESS] and [READ]).
+// Readout thread runs on the CPUs of the process unless its own mask is set.
+//  *proc: lv process instance handle
+//  *folder: working directory for the process
+//  *cmd: the command to execute (see proc_create())
+//  sterr: write 1 to combine stderr to stdout
+//  hide: write 1 to hide console
+//  affinity: CPU affinity mask of the process (0: default)
+//  numa_node: NUMA node of the process, used if no affinity mask (-1: default)
+//  priority: process priority class LVP_PRIO_xxx (0: default)
+//  th_affinity: CPU affinity mask of readout thread (0: default)
+//  *mmcss: MMCSS task of readout thread, e.g. "Pro Audio" (empty or NULL: default)
+DllExport __int32 proc_create_ex(TLVPHndl *proc,char *folder,char *cmd,__int32 sterr,__int32 hide,unsigned __int64 affinity,__int32 numa_node,__int32 priority,unsigned __int64 th_affinity,char *mmcss);
+
 //---------------------------------------------------------------------------
 // Close process instance handle. Call this to cleanup after the process has terminated.
 //  *proc: lv process instance handle
@@ -348,4 +684,509 @@ DllExport __int32 proc_peek_stdout(TLVPHndl *proc,__int32 *exit,char *buf,__int3
 // In case no command is sent, function only reads stdout pipe with timeout.
 DllExport __int32 proc_command(TLVPHndl *proc,__int32 *exit,char *cmd,__int32 cmdlen,char *buf,__int32 buflen,__int32 *bufret,__int32 rtime,__int32 rint);
 
+
+//====== GOLPI BITSTREAM ======
+//---------------------------------------------------------------------------
+// Decode 8-bit coded Bitstream data (see golpi_data2bits()).
+//  *src: coded data (without '_GpBiT_' header and terminating '\n')
+//  srclen: coded data size [B]
+//  *dst: decoded data buffer
+//  dstlen: decoded data buffer size [B]
+//  *dstret: returns decoded bytes count (optional)
+//  *used: returns processed coded bytes count (optional)
+//
+// Coded characters NUL, LF, CR, ESC and '=' are always escaped, so the coded
+// data never contain line ends nor ESC frame/request markers.
+// Decoding stops when 'dst' is full or before incomplete escape sequence at the
+// end of 'src', so the rest can be decoded by next call.
+DllExport __int32 proc_bitstream_decode_8bit(char *src,__int32 srclen,char *dst,__int32 dstlen,__int32 *dstret,__int32 *used);
+
+//---------------------------------------------------------------------------
+// Decode complete Bitstream (see golpi_data2bits()) to typed data buffer.
+//  *src: stream data starting with '_GpBiT_' header (terminating '\n' optional)
+//  srclen: stream size [B]
+//  *dst: decoded data buffer (NULL to parse header only)
+//  dstlen: decoded data buffer size [B]
+//  *type: returns data type (T) of header with coding flag cleared (optional):
+//         0: error (variable not sent), 1: signed integer, 2: unsigned integer,
+//         3: real float, 4: complex float, 5: string
+//  *elsize: returns element size [B] (optional)
+//  *dims: returns dimensions, up to 'maxdims' items (optional)
+//  maxdims: size of 'dims' buffer
+//  *ndims: returns count of dimensions (optional)
+//  *dstret: returns decoded data size [B] (optional)
+//
+// Elements are returned in native (little endian) byte order. Complex elements
+// are returned as real and imaginary part pairs. Large data are decoded by
+// multiple threads.
+DllExport __int32 proc_bitstream_decode(char *src,__int32 srclen,char *dst,__int32 dstlen,__int32 *type,__int32 *elsize,__int32 *dims,__int32 maxdims,__int32 *ndims,__int32 *dstret);
+
+//---------------------------------------------------------------------------
+// Arm receiving of Bitstream by stdout readout thread. Next '_GpBiT_' stream
+// appearing on stdout is decoded on the fly to separate data buffer instead
+// of passing it to stdout fifo. Other stdout data are passed as usual.
+// Previously received and not fetched data are discarded.
+//  *proc: lv process instance handle
+DllExport __int32 proc_bitstream_arm(TLVPHndl *proc);
+
+//---------------------------------------------------------------------------
+// Cancel armed Bitstream receive and discard its data.
+//  *proc: lv process instance handle
+DllExport __int32 proc_bitstream_disarm(TLVPHndl *proc);
+
+//---------------------------------------------------------------------------
+// Wait for armed Bitstream receive.
+//  *proc: lv process instance handle
+//  timeout: timeout in ms (0 to poll)
+//  *type: returns data type (T) of header with coding flag cleared (optional)
+//  *elsize: returns element size [B] (optional)
+//  *dims: returns dimensions, up to 'maxdims' items (optional)
+//  maxdims: size of 'dims' buffer
+//  *ndims: returns count of dimensions (optional)
+//  *size: returns decoded data size [B] (optional)
+//
+// Returns LVP_EC_TIMEOUT if stream was not received yet.
+DllExport __int32 proc_bitstream_wait(TLVPHndl *proc,__int32 timeout,__int32 *type,__int32 *elsize,__int32 *dims,__int32 maxdims,__int32 *ndims,__int32 *size);
+
+//---------------------------------------------------------------------------
+// Fetch decoded data of received Bitstream (see proc_bitstream_wait()) and
+// disarm the receive. Elements are in native (little endian) byte order.
+//  *proc: lv process instance handle
+//  *dst: decoded data buffer
+//  dstlen: decoded data buffer size [B]
+//  *dstret: returns decoded data size [B] (optional)
+DllExport __int32 proc_bitstream_fetch(TLVPHndl *proc,char *dst,__int32 dstlen,__int32 *dstret);
+
+
+//====== GOLPI STRUCTURE STREAM ======
+//---------------------------------------------------------------------------
+// Parse structure stream (see golpi_conv_struct()) and build index of its items.
+//  *src: structure stream
+//  srclen: structure stream size [B]
+//  **index: returns structure index handle, loose it by proc_struct_index_free()
+//  *count: returns items count (optional)
+//
+// Items are indexed in order of the stream, i.e. each array item is followed by
+// items of its element streams. Item paths are field names, items of element
+// streams of array items are prefixed by path of the array item and 1-based
+// element index in braces, e.g. "a", "s{1}.b", "c{2}{3}.x".
+DllExport __int32 proc_struct_index_create(char *src,__int32 srclen,TLVPStructIndex **index,__int32 *count);
+
+//---------------------------------------------------------------------------
+// Loose structure index.
+//  *index: structure index handle
+DllExport __int32 proc_struct_index_free(TLVPStructIndex *index);
+
+//---------------------------------------------------------------------------
+// Find item of structure index by its path.
+//  *index: structure index handle
+//  *path: item path (null terminated string)
+//  *item: returns item index
+DllExport __int32 proc_struct_index_find(TLVPStructIndex *index,char *path,__int32 *item);
+
+//---------------------------------------------------------------------------
+// Get item record of structure index.
+//  *index: structure index handle
+//  item: item index
+//  *type: returns item type (0bC000TTTT, see golpi_conv_struct()) (optional)
+//  *rows: returns rows count (optional)
+//  *cols: returns columns count (optional)
+//  *offset: returns offset of item data in the stream [B] (optional)
+//  *size: returns item data size [B] (optional)
+//  *parent: returns index of parent array item, -1 for top level items (optional)
+//
+// Data of array item are table of element offsets followed by element streams.
+DllExport __int32 proc_struct_index_item(TLVPStructIndex *index,__int32 item,__int32 *type,__int32 *rows,__int32 *cols,__int32 *offset,__int32 *size,__int32 *parent);
+
+//---------------------------------------------------------------------------
+// Get path of item of structure index.
+//  *index: structure index handle
+//  item: item index
+//  *path: path string buffer
+//  maxlen: size of path string buffer
+DllExport __int32 proc_struct_index_path(TLVPStructIndex *index,__int32 item,char *path,__int32 maxlen);
+
+//---------------------------------------------------------------------------
+// Copy data of item of structure index.
+//  *index: structure index handle
+//  *src: structure stream the index was created from
+//  srclen: structure stream size [B]
+//  item: item index
+//  *dst: destination buffer
+//  dstlen: destination buffer size [B]
+//  *dstret: returns item data size [B] (optional)
+//
+// Data are copied as they are in the stream (little endian, complex elements
+// as real and imaginary part pairs).
+DllExport __int32 proc_struct_index_copy(TLVPStructIndex *index,char *src,__int32 srclen,__int32 item,char *dst,__int32 dstlen,__int32 *dstret);
+
+
+//====== TEXT NUMBERS ======
+//---------------------------------------------------------------------------
+// Parse text of real or complex numbers (e.g. printed matrix) to array of doubles.
+//  *src: text data
+//  srclen: text data size [B]
+//  *dst: destination array
+//  dstlen: destination array size (count of numbers, i.e. pairs for complex)
+//  cplx: non-zero to store complex numbers as (re,im) pairs
+//  last: non-zero if this is the last text span (else the last number is not
+//        parsed if it may continue in next span)
+//  *count: returns count of parsed numbers (optional)
+//  *used: returns count of processed characters (optional)
+//
+// Numbers are delimited by whitespaces, ',' or ';'. Supported are decimal numbers
+// with optional exponent, Inf, NaN, NA and complex numbers "1.5+2i", "1.5 - 2i"
+// or "2i" ('i' or 'j'). Parsing stops when 'dst' is full, at the end of data
+// or at invalid text (LVP_EC_NUM_FORMAT error, 'used' points to the text).
+// Unprocessed characters have to be passed again with the next span.
+DllExport __int32 proc_parse_numbers(char *src,__int32 srclen,double *dst,__int32 dstlen,__int32 cplx,__int32 last,__int32 *count,__int32 *used);
+
+//---------------------------------------------------------------------------
+// Parse numbers directly from stdout fifo (see proc_parse_numbers()).
+//  *proc: lv process instance handle
+//  *dst: destination array
+//  dstlen: destination array size (count of numbers, i.e. pairs for complex)
+//  cplx: non-zero to store complex numbers as (re,im) pairs
+//  last: non-zero if no more numbers will be sent by process
+//  *count: returns count of parsed numbers (optional)
+//
+// Parsed text is removed from the fifo, the incomplete last number is left in
+// the fifo till next call. It can be called repeatedly as the data arrive.
+DllExport __int32 proc_read_numbers(TLVPHndl *proc,double *dst,__int32 dstlen,__int32 cplx,__int32 last,__int32 *count);
+
+
+//---------------------------------------------------------------------------
+// Format real or complex matrix to Octave assignment command "name=[a,b;c,d];\n".
+//  *name: variable name (null terminated string)
+//  *data: matrix data (row-major order, complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  *dst: command buffer
+//  dstlen: command buffer size [B]
+//  *dstret: returns command length [B], required buffer size if too small (optional)
+//
+// Each number is formatted to the shortest string that Octave converts back to
+// exactly the same double. Command is not null terminated.
+DllExport __int32 proc_format_matrix(char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,char *dst,__int32 dstlen,__int32 *dstret);
+
+//---------------------------------------------------------------------------
+// Format real or complex matrix to Octave assignment command and write it to
+// the process stdin (see proc_format_matrix()).
+//  *proc: lv process instance handle
+//  *name: variable name (null terminated string)
+//  *data: matrix data (row-major order, complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  *written: returns count of written bytes (optional)
+//
+// Command is formatted and written in chunks, so no buffer for whole command
+// is needed.
+DllExport __int32 proc_write_matrix(TLVPHndl *proc,char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,__int32 *written);
+
+
+//====== MAT FILES ======
+//---------------------------------------------------------------------------
+// Write real or complex matrix to MAT-4 or Octave binary file.
+//  *path: file path
+//  *name: variable name (null terminated string)
+//  *data: matrix data (complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  rowmajor: non-zero if data are row-major (LabVIEW 2D array), else column-major
+//  format: file format LVP_MAT_FORMAT_xxx
+//  append: non-zero to append variable to existing file
+//
+// Data are always stored as double. Octave loads both formats by 'load(path)'.
+DllExport __int32 proc_mat_write(char *path,char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,__int32 rowmajor,__int32 format,__int32 append);
+
+//---------------------------------------------------------------------------
+// Open MAT-4 file and build index of its variables.
+//  *path: file path
+//  **mat: returns MAT file handle, close it by proc_mat_close()
+//  *count: returns variables count (optional)
+//
+// File is mapped to memory till it is closed.
+DllExport __int32 proc_mat_open(char *path,TLVPMatFile **mat,__int32 *count);
+
+//---------------------------------------------------------------------------
+// Close MAT file.
+//  *mat: MAT file handle
+DllExport __int32 proc_mat_close(TLVPMatFile *mat);
+
+//---------------------------------------------------------------------------
+// Find variable of MAT file by name.
+//  *mat: MAT file handle
+//  *name: variable name (null terminated string)
+//  *var: returns variable index
+DllExport __int32 proc_mat_find(TLVPMatFile *mat,char *name,__int32 *var);
+
+//---------------------------------------------------------------------------
+// Get variable info of MAT file.
+//  *mat: MAT file handle
+//  var: variable index
+//  *name: variable name buffer (optional)
+//  maxlen: size of variable name buffer
+//  *type: returns data precision (0 double, 1 single, 2 int32, 3 int16, 4 uint16, 5 uint8) (optional)
+//  *text: returns non-zero for text matrix (optional)
+//  *rows: returns rows count (optional)
+//  *cols: returns columns count (optional)
+//  *cplx: returns non-zero for complex data (optional)
+DllExport __int32 proc_mat_info(TLVPMatFile *mat,__int32 var,char *name,__int32 maxlen,__int32 *type,__int32 *text,__int32 *rows,__int32 *cols,__int32 *cplx);
+
+//---------------------------------------------------------------------------
+// Get pointers to data of variable of MAT file (mapped file content).
+//  *mat: MAT file handle
+//  var: variable index
+//  **re: returns pointer to real part data (column-major, see proc_mat_info() for type)
+//  **im: returns pointer to imaginary part data, NULL for real data (optional)
+//  *size: returns size of each part [B] (optional)
+//
+// Pointers are valid till the file is closed.
+DllExport __int32 proc_mat_data(TLVPMatFile *mat,__int32 var,char **re,char **im,__int32 *size);
+
+//---------------------------------------------------------------------------
+// Read variable of MAT file to array of doubles.
+//  *mat: MAT file handle
+//  var: variable index
+//  *dst: destination array
+//  dstlen: destination array size (count of doubles)
+//  rowmajor: non-zero to store data row-major (LabVIEW 2D array), else column-major
+//  *dstret: returns count of doubles stored (optional)
+//
+// Complex data are stored as (re,im) pairs. Column-major double data are
+// copied by single bulk copy.
+DllExport __int32 proc_mat_read(TLVPMatFile *mat,__int32 var,double *dst,__int32 dstlen,__int32 rowmajor,__int32 *dstret);
+
+
+//====== TEMPORARY FILES ======
+//---------------------------------------------------------------------------
+// Create pool of temporary files.
+//  *folder: folder of the files (null terminated string), empty for system temp folder (optional)
+//  count: files count (1 to LVP_TMP_MAX_FILES)
+//  size: initially preallocated size of each file [B]
+//  **pool: returns pool handle, loose it by proc_tmp_pool_free()
+DllExport __int32 proc_tmp_pool_create(char *folder,__int32 count,__int32 size,TLVPTmpPool **pool);
+
+//---------------------------------------------------------------------------
+// Loose pool of temporary files and delete the files.
+//  *pool: pool handle
+DllExport __int32 proc_tmp_pool_free(TLVPTmpPool *pool);
+
+//---------------------------------------------------------------------------
+// Get free temporary file of the pool.
+//  *pool: pool handle
+//  size: expected data size to preallocate [B]
+//  *file: returns file index
+//  *path: file path buffer (optional)
+//  maxlen: size of file path buffer
+//
+// File is empty and it is reserved till proc_tmp_release(). Its path can be
+// passed to Octave or written by proc_tmp_write_matrix().
+DllExport __int32 proc_tmp_acquire(TLVPTmpPool *pool,__int32 size,__int32 *file,char *path,__int32 maxlen);
+
+//---------------------------------------------------------------------------
+// Return temporary file to the pool.
+//  *pool: pool handle
+//  file: file index
+DllExport __int32 proc_tmp_release(TLVPTmpPool *pool,__int32 file);
+
+//---------------------------------------------------------------------------
+// Append real or complex matrix to temporary file (see proc_mat_write()).
+//  *pool: pool handle
+//  file: file index
+//  *name: variable name (null terminated string)
+//  *data: matrix data (complex as (re,im) pairs)
+//  rows: rows count
+//  cols: columns count
+//  cplx: non-zero if data are complex
+//  rowmajor: non-zero if data are row-major (LabVIEW 2D array), else column-major
+//  format: file format LVP_MAT_FORMAT_xxx
+DllExport __int32 proc_tmp_write_matrix(TLVPTmpPool *pool,__int32 file,char *name,double *data,__int32 rows,__int32 cols,__int32 cplx,__int32 rowmajor,__int32 format);
+
+
+//====== BINARY FRAMES ======
+//---------------------------------------------------------------------------
+// Send variable to GOLPI via stdin pipe as binary frame. Function writes
+// command "name=golpi_stdin_receive(timeout);\n", waits till Octave is ready
+// and writes the frame. Stdout FIFO is cleared. Caller then reads stdout
+// for "GOLPImark" as usual.
+//  *proc: lv process instance handle
+//  *name: variable name (null terminated string)
+//  type: variable type id of GOLPI (VTYPE_xxx, see golpi_pipe.hpp)
+//  rows: rows count
+//  cols: columns count
+//  *data: variable data in GOLPI variable record format (column-major)
+//  size: data size [B]
+//  timeout: timeout of Octave response and of the transfer [ms]
+//  *written: returns total bytes written to stdin (optional)
+DllExport __int32 proc_write_binary_frame(TLVPHndl *proc,char *name,__int32 type,__int32 rows,__int32 cols,char *data,__int32 size,__int32 timeout,__int32 *written);
+
+//---------------------------------------------------------------------------
+// Wait for binary frame message sent by golpi_stdout_send(). Messages are
+// split from stdout by readout thread to separate queue, text goes to stdout
+// fifo as usual.
+//  *proc: lv process instance handle
+//  channel: message channel (0 to 255), -1 for any
+//  timeout: timeout [ms], 0 to just check the queue
+//  *chret: returns message channel (optional)
+//  *size: returns message size [B] (optional)
+DllExport __int32 proc_frame_wait(TLVPHndl *proc,__int32 channel,__int32 timeout,__int32 *chret,__int32 *size);
+
+//---------------------------------------------------------------------------
+// Fetch first queued binary frame message and remove it from the queue.
+// Message of golpi_stdout_send() is variable record: DWORD type (VTYPE_xxx),
+// DWORD rows, DWORD columns, data.
+//  *proc: lv process instance handle
+//  channel: message channel (0 to 255), -1 for any
+//  *dst: destination buffer
+//  dstlen: size of destination buffer, message stays queued if too small
+//  *chret: returns message channel (optional)
+//  *dstret: returns message size [B] (optional)
+DllExport __int32 proc_frame_fetch(TLVPHndl *proc,__int32 channel,char *dst,__int32 dstlen,__int32 *chret,__int32 *dstret);
+
+//---------------------------------------------------------------------------
+// Discard all queued binary frame messages.
+//  *proc: lv process instance handle
+DllExport __int32 proc_frame_clear(TLVPHndl *proc);
+
+
+//====== TAGGED REQUESTS ======
+//---------------------------------------------------------------------------
+// Send command tagged with request id without waiting for its output, so
+// more commands may be in flight. Command is wrapped to golpi_dispatch(),
+// which prints begin/end markers around its output, and the readout thread
+// routes the output to the request slot.
+//  *proc: lv process instance handle
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *id: returns request id
+DllExport __int32 proc_request_send(TLVPHndl *proc,char *cmd,__int32 cmdlen,__int32 *id);
+
+//---------------------------------------------------------------------------
+// Wait for output of request sent by proc_request_send() and release the
+// request. Output does not contain the markers.
+//  *proc: lv process instance handle
+//  id: request id
+//  timeout: timeout [ms], request stays pending on timeout
+//  *buf: output buffer (null terminated string)
+//  buflen: output buffer size, request stays pending if too small
+//  *bufret: returns output size [B] (optional)
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+DllExport __int32 proc_request_read(TLVPHndl *proc,__int32 id,__int32 timeout,char *buf,__int32 buflen,__int32 *bufret,__int32 *status);
+
+
+//====== ASYNCHRONOUS COMMANDS ======
+//---------------------------------------------------------------------------
+// Submit command without waiting for its output. Returns ticket for
+// proc_command_poll(), proc_command_wait() and proc_command_cancel(). Ticket
+// is request id (see proc_request_send()), so the output is read by
+// proc_request_read(). Completion is signalled by the readout thread, so
+// single caller thread may drive many process instances.
+//  *proc: lv process instance handle
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *ticket: returns command ticket
+DllExport __int32 proc_command_submit(TLVPHndl *proc,char *cmd,__int32 cmdlen,__int32 *ticket);
+
+//---------------------------------------------------------------------------
+// Get state of submitted command without waiting.
+//  *proc: lv process instance handle
+//  ticket: command ticket
+//  *state: returns command state LVP_CMD_xxx (1 - queued, 2 - running, 3 - done)
+//  *size: returns size of output received so far [B] (optional)
+DllExport __int32 proc_command_poll(TLVPHndl *proc,__int32 ticket,__int32 *state,__int32 *size);
+
+//---------------------------------------------------------------------------
+// Wait till submitted command is done. The caller thread sleeps till the
+// readout thread receives end of the output. Output stays in the request,
+// read it by proc_request_read().
+//  *proc: lv process instance handle
+//  ticket: command ticket
+//  timeout: timeout [ms]
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+//  *size: returns output size [B] (optional)
+DllExport __int32 proc_command_wait(TLVPHndl *proc,__int32 ticket,__int32 timeout,__int32 *status,__int32 *size);
+
+//---------------------------------------------------------------------------
+// Cancel submitted command and release its ticket. Command already written
+// to the process cannot be recalled, so it is still executed, but its output
+// is discarded by the readout thread.
+//  *proc: lv process instance handle
+//  ticket: command ticket
+DllExport __int32 proc_command_cancel(TLVPHndl *proc,__int32 ticket);
+
+
+//====== COMMAND QUEUE ======
+//---------------------------------------------------------------------------
+// Setup command queue of the process instance. Commands of LVP_LANE_NORMAL
+// and LVP_LANE_BULK lanes take turns by their weights, so no lane starves.
+// Defaults are 1 command in flight and weights 4:1.
+//  *proc: lv process instance handle
+//  inflight: maximum commands written to process (1 to LVP_REQ_MAX_SLOTS)
+//  weight_normal: commands of normal lane in its turn (1 or more)
+//  weight_bulk: commands of bulk lane in its turn (1 or more)
+DllExport __int32 proc_queue_config(TLVPHndl *proc,__int32 inflight,__int32 weight_normal,__int32 weight_bulk);
+
+//---------------------------------------------------------------------------
+// Submit command to the command queue, so more threads may share single
+// process instance. lv_proc holds the command till its turn, then writes it
+// as tagged request, so the output is routed to the ticket of submitter.
+// Command of LVP_LANE_CONTROL lane is written before all queued commands as
+// soon as possible, but it still waits till commands already written to
+// the process are done. Use ticket as in proc_command_submit().
+//  *proc: lv process instance handle
+//  lane: queue lane LVP_LANE_xxx (0 - control, 1 - normal, 2 - bulk)
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  *ticket: returns command ticket
+DllExport __int32 proc_queue_submit(TLVPHndl *proc,__int32 lane,char *cmd,__int32 cmdlen,__int32 *ticket);
+
+//---------------------------------------------------------------------------
+// Submit command to the command queue and wait for its output. Replacement
+// of proc_command() for threads sharing single process instance. Command is
+// cancelled on failure, so its output is lost.
+//  *proc: lv process instance handle
+//  lane: queue lane LVP_LANE_xxx (0 - control, 1 - normal, 2 - bulk)
+//  *cmd: command (without final new line)
+//  cmdlen: command size [B], negative for null terminated string (see proc_command())
+//  timeout: timeout including time in the queue [ms]
+//  *buf: output buffer (null terminated string)
+//  buflen: output buffer size
+//  *bufret: returns output size [B] (optional)
+//  *status: returns command status, 0 - ok, 1 - command failed (optional)
+DllExport __int32 proc_queue_command(TLVPHndl *proc,__int32 lane,char *cmd,__int32 cmdlen,__int32 timeout,char *buf,__int32 buflen,__int32 *bufret,__int32 *status);
+
+
+//====== PRE-INITIALIZED INSTANCES ======
+//---------------------------------------------------------------------------
+// Create pool of pre-initialized process instances. Instances are started
+// in background by proc_create() (hidden), each runs the initialization
+// script (e.g. "pkg load golpi") and waits in the pool. proc_warm_acquire()
+// then takes ready instance immediately and the pool starts new one in its
+// place, so the startup time is hidden from the caller.
+//  *folder: working directory for the processes
+//  *cmd: the command to execute (see proc_create())
+//  sterr: write 1 to combine stderr to stdout
+//  *init: initialization script (null terminated string, optional)
+//  count: instances count to keep ready (1 to LVP_WARM_MAX_PROCS)
+//  timeout: initialization timeout of instance [ms]
+//  **pool: returns pool handle, loose it by proc_warm_pool_free()
+DllExport __int32 proc_warm_pool_create(char *folder,char *cmd,__int32 sterr,char *init,__int32 count,__int32 timeout,TLVPWarmPool **pool);
+
+//---------------------------------------------------------------------------
+// Take ready instance from the pool. Instance is moved to the process handle,
+// so it is used and closed as if it was created by proc_create().
+//  *pool: pool handle
+//  *proc: lv process instance handle to be filled
+//  timeout: timeout to wait for ready instance [ms]
+DllExport __int32 proc_warm_acquire(TLVPWarmPool *pool,TLVPHndl *proc,__int32 timeout);
+
+//---------------------------------------------------------------------------
+// Loose pool and terminate instances not taken from the pool.
+//  *pool: pool handle
+DllExport __int32 proc_warm_pool_free(TLVPWarmPool *pool);
+
 #endif
@@ -13,6 +13,12 @@
 //  4) reads and prints response to the command
 //  5) sends 'exit' command to leave 'cmd.exe' process
 //  6) waits for 'cmd.exe' return code
+//
+// Self-test of lv_proc exports:
+//  test.exe test
+//  test.exe test "<octave command line>"
+// Tests of GOLPI process functions run only if Octave command line with installed
+// GOLPI package is passed, e.g. "octave-cli.exe -q --no-gui".
 //---------------------------------------------------------------------------------------------------------------------
 
 #include <string.h>
@@ -21,10 +27,868 @@
 #include <conio.h>
 #include "lv_proc.h"
 
+// --- self-test ---
+static int test_count = 0;
+static int test_failed = 0;
+
+// check test condition
+static void test_check(int cond,const char *name)
+{
+    test_count++;
+    if(!cond)
+    {
+        test_failed++;
+        printf("FAILED: %s\n",name);
+    }
+}
+
+// encode data to GOLPI Bitstream row vector as golpi_data2bits() does
+static int test_bits_encode(char *dst,const void *data,int elsize,int count,int type,int coding_8bit)
+{
+    const unsigned char *src = (const unsigned char*)data;
+    int len = sprintf(dst,BS_HDR_ID "%02X%01X%08X%08X%08X",elsize,type | (coding_8bit?8:0),2,1,count);
+
+    // big endian elements, padded to 7 bytes groups
+    int size = elsize*count;
+    unsigned char *be = (unsigned char*)calloc(size + 7,1);
+    for(int k = 0; k < size; k++)
+        be[k] = src[k - k%elsize + elsize - 1 - k%elsize];
+
+    if(coding_8bit)
+    {
+        for(int k = 0; k < size; k++)
+        {
+            unsigned char c = be[k] + BS_ESC_OFFSET;
+            if(c == 0x00 || c == '\n' || c == '\r' || c == 0x1B || c == BS_ESC_CHAR)
+            {
+                dst[len++] = BS_ESC_CHAR;
+                c += BS_ESC_SHIFT;
+            }
+            dst[len++] = (char)c;
+        }
+    }
+    else
+    {
+        for(int k = 0; k < size; k += 7)
+        {
+            unsigned __int64 x = 0;
+            for(int b = 0; b < 7; b++)
+                x |= (unsigned __int64)be[k + b] << (8*b);
+            for(int b = 0; b < 8; b++)
+                dst[len++] = (char)(((x >> (7*b)) & 0x7F) + '0');
+        }
+    }
+    dst[len++] = '\n';
+    free(be);
+    return(len);
+}
+
+// bitstream decoding
+static void test_bitstream(void)
+{
+    const int N = 100000;
+    double *x = (double*)malloc(N*sizeof(double));
+    double *y = (double*)malloc(N*sizeof(double));
+    char *bits = (char*)malloc(N*sizeof(double)*2 + 1024);
+    for(int k = 0; k < N; k++)
+        x[k] = k*0.37 - 1000.0;
+
+    for(int coding = 0; coding < 2; coding++)
+    {
+        // double vector (large enough for multithreaded decoding)
+        int len = test_bits_encode(bits,x,8,N,3,coding);
+        __int32 type,elsize,dims[4],ndims,ret;
+        memset(y,0,N*sizeof(double));
+        int err = proc_bitstream_decode(bits,len,(char*)y,N*sizeof(double),&type,&elsize,dims,4,&ndims,&ret);
+        test_check(!err && type == 3 && elsize == 8 && ndims == 2 && dims[0] == 1 && dims[1] == N && ret == N*(int)sizeof(double),"bitstream decode header");
+        test_check(memcmp(x,y,N*sizeof(double)) == 0,"bitstream decode double");
+
+        // header only
+        err = proc_bitstream_decode(bits,len,NULL,0,&type,NULL,dims,4,&ndims,NULL);
+        test_check(!err && type == 3 && dims[1] == N,"bitstream decode header only");
+
+        // int16 with odd size (7-bit padding) and without terminating '\n'
+        short i16[5] = {-32768,-1,0,10,32767};
+        short o16[5];
+        len = test_bits_encode(bits,i16,2,5,1,coding);
+        err = proc_bitstream_decode(bits,len - 1,(char*)o16,sizeof(o16),&type,&elsize,NULL,0,NULL,&ret);
+        test_check(!err && type == 1 && elsize == 2 && ret == sizeof(o16) && memcmp(i16,o16,sizeof(o16)) == 0,"bitstream decode int16");
+
+        // all byte values (critical characters of 8-bit coding)
+        unsigned char u8[256];
+        unsigned char o8[256];
+        for(int k = 0; k < 256; k++)
+            u8[k] = (unsigned char)k;
+        len = test_bits_encode(bits,u8,1,256,2,coding);
+        err = proc_bitstream_decode(bits,len,(char*)o8,sizeof(o8),&type,NULL,NULL,0,NULL,&ret);
+        test_check(!err && type == 2 && ret == 256 && memcmp(u8,o8,256) == 0,"bitstream decode uint8");
+
+        // errors
+        test_check(proc_bitstream_decode(bits,len,(char*)o8,255,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_SMALL_BUF,"bitstream small buffer");
+        test_check(proc_bitstream_decode(bits,len - 20,(char*)o8,256,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_INCOMPLETE,"bitstream incomplete");
+        test_check(proc_bitstream_decode(bits,20,(char*)o8,256,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_HEADER,"bitstream short header");
+    }
+    bits[1] = 'X';
+    test_check(proc_bitstream_decode(bits,100,NULL,0,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_HEADER,"bitstream invalid header");
+
+    // 8-bit decoding in spans, split inside escape sequence
+    unsigned char u8[256];
+    unsigned char o8[256];
+    for(int k = 0; k < 256; k++)
+        u8[k] = (unsigned char)(255 - k);
+    int len = test_bits_encode(bits,u8,1,256,2,1);
+    int hdr = BS_HDR_ID_LEN + 2 + 1 + 8 + 2*8;
+    char *data = &bits[hdr];
+    int datalen = len - hdr - 1;
+    int split = (int)(strchr(data,BS_ESC_CHAR) - data) + 1;
+    __int32 ret1,used1,ret2,used2;
+    int err = proc_bitstream_decode_8bit(data,split,(char*)o8,256,&ret1,&used1);
+    err |= proc_bitstream_decode_8bit(&data[used1],datalen - used1,(char*)&o8[ret1],256 - ret1,&ret2,&used2);
+    test_check(!err && used1 == split - 1 && ret1 + ret2 == 256 && used1 + used2 == datalen && memcmp(u8,o8,256) == 0,"bitstream decode 8-bit spans");
+
+    free(bits);
+    free(x);
+    free(y);
+}
+
+// append item record to structure stream as golpi_conv_struct() does
+static int test_struct_item(char *dst,const char *name,int type,int rows,int cols,const void *data,int size)
+{
+    int name_len = (int)strlen(name);
+    DWORD rec_size = 1 + name_len + 1 + 4 + 4 + size;
+    memcpy(dst,&rec_size,4);
+    dst[4] = (char)name_len;
+    memcpy(&dst[5],name,name_len);
+    dst[5 + name_len] = (char)type;
+    memcpy(&dst[6 + name_len],&rows,4);
+    memcpy(&dst[10 + name_len],&cols,4);
+    memcpy(&dst[14 + name_len],data,size);
+    return(4 + rec_size);
+}
+
+// structure stream index
+static void test_struct(void)
+{
+    char src[1024];
+    char arr[512];
+    char buf[256];
+    int a[3] = {1,2,3};
+    double c[2] = {1.5,-2.5};
+    double x = 5.0;
+    DWORD count;
+    int len,alen;
+
+    // array item of 2 elements: {x: double}, {y: string}
+    DWORD offs[2] = {0,0};
+    alen = 8;
+    count = 1;
+    memcpy(&arr[alen],&count,4);
+    alen += 4;
+    alen += test_struct_item(&arr[alen],"x",3,1,1,&x,8);
+    offs[1] = alen - 8;
+    memcpy(&arr[alen],&count,4);
+    alen += 4;
+    alen += test_struct_item(&arr[alen],"y",4,1,2,"ab",2);
+    memcpy(arr,offs,8);
+
+    // top level structure {a: int32 1x3, b: string, c: complex double, s: array}
+    count = 4;
+    memcpy(src,&count,4);
+    len = 4;
+    len += test_struct_item(&src[len],"a",0,1,3,a,sizeof(a));
+    len += test_struct_item(&src[len],"b",4,1,5,"hello",5);
+    len += test_struct_item(&src[len],"c",0x83,1,1,c,sizeof(c));
+    len += test_struct_item(&src[len],"s",5,1,2,arr,alen);
+
+    TLVPStructIndex *si = NULL;
+    __int32 items = 0;
+    int err = proc_struct_index_create(src,len,&si,&items);
+    test_check(!err && items == 6,"struct index create");
+    if(err)
+        return;
+
+    __int32 item,type,rows,cols,offset,size,parent,ret;
+    err = proc_struct_index_find(si,"a",&item);
+    err |= proc_struct_index_item(si,item,&type,&rows,&cols,&offset,&size,&parent);
+    err |= proc_struct_index_copy(si,src,len,item,buf,sizeof(buf),&ret);
+    test_check(!err && item == 0 && type == 0 && rows == 1 && cols == 3 && size == sizeof(a) && parent == -1 && ret == sizeof(a) && memcmp(buf,a,sizeof(a)) == 0 && memcmp(&src[offset],a,sizeof(a)) == 0,"struct index int32 item");
+
+    err = proc_struct_index_find(si,"c",&item);
+    err |= proc_struct_index_copy(si,src,len,item,buf,sizeof(buf),&ret);
+    test_check(!err && ret == sizeof(c) && memcmp(buf,c,sizeof(c)) == 0,"struct index complex item");
+
+    __int32 arr_item;
+    err = proc_struct_index_find(si,"s",&arr_item);
+    err |= proc_struct_index_find(si,"s{2}.y",&item);
+    err |= proc_struct_index_item(si,item,&type,&rows,&cols,NULL,NULL,&parent);
+    err |= proc_struct_index_copy(si,src,len,item,buf,sizeof(buf),&ret);
+    test_check(!err && arr_item == 3 && item == 5 && type == 4 && cols == 2 && parent == arr_item && ret == 2 && memcmp(buf,"ab",2) == 0,"struct index nested item");
+
+    err = proc_struct_index_path(si,4,buf,sizeof(buf));
+    test_check(!err && strcmp(buf,"s{1}.x") == 0,"struct index path");
+
+    test_check(proc_struct_index_find(si,"s{3}.y",&item) == LVP_EC_STRUCT_NOT_FOUND,"struct index not found");
+    proc_struct_index_find(si,"b",&item);
+    test_check(proc_struct_index_copy(si,src,len,item,buf,4,NULL) == LVP_EC_STRUCT_SMALL_BUF,"struct index small buffer");
+    proc_struct_index_free(si);
+
+    // truncated stream
+    si = NULL;
+    test_check(proc_struct_index_create(src,len - 1,&si,NULL) == LVP_EC_STRUCT_FORMAT && !si,"struct index truncated stream");
+}
+
+// random double of any exponent (xorshift)
+static double test_rand_double(unsigned __int64 *seed)
+{
+    double x;
+    do{
+        *seed ^= *seed << 13;
+        *seed ^= *seed >> 7;
+        *seed ^= *seed << 17;
+        memcpy(&x,seed,sizeof(double));
+    }while(x != x || x - x != 0.0);
+    return(x);
+}
+
+// text numbers parser
+static void test_parse(void)
+{
+    double y[64];
+    __int32 count,used;
+
+    // real numbers with all delimiters and special values
+    char txt[] = " 1 2.5\t-3e-2, 4;5\n\r  +6.25E+3 Inf -Inf NaN NA 0.1 1e-320 \n";
+    double ref[] = {1.0,2.5,-3e-2,4.0,5.0,6.25e3,HUGE_VAL,-HUGE_VAL,0.0,0.0,0.1,1e-320};
+    int err = proc_parse_numbers(txt,(int)strlen(txt),y,64,0,1,&count,&used);
+    int match = !err && count == 12 && used == (int)strlen(txt);
+    for(int k = 0; k < 12 && match; k++)
+        match = (k == 8 || k == 9)?(y[k] != y[k]):(y[k] == ref[k]);
+    test_check(match,"parse real numbers");
+
+    // more than 19 significant digits
+    char digits[] = "3.14159265358979323846264338 -0.000000000000000000000123456789012345678901234";
+    err = proc_parse_numbers(digits,(int)strlen(digits),y,64,0,1,&count,NULL);
+    test_check(!err && count == 2 && y[0] == strtod(digits,NULL) && y[1] == strtod(&digits[29],NULL),"parse long numbers");
+
+    // complex numbers
+    char cplx[] = "1.5+2i 1.5 - 2i 2j -3 Inf-NaNi";
+    err = proc_parse_numbers(cplx,(int)strlen(cplx),y,64,1,1,&count,NULL);
+    test_check(!err && count == 5 && y[0] == 1.5 && y[1] == 2.0 && y[2] == 1.5 && y[3] == -2.0 && y[4] == 0.0 && y[5] == 2.0 &&
+               y[6] == -3.0 && y[7] == 0.0 && y[8] == HUGE_VAL && y[9] != y[9],"parse complex numbers");
+
+    // spans: last number may continue in next span
+    char span[] = "12 34";
+    err = proc_parse_numbers(span,5,y,64,0,0,&count,&used);
+    test_check(!err && count == 1 && y[0] == 12.0 && used == 3,"parse span");
+    err = proc_parse_numbers(&span[used],5 - used,&y[1],63,0,1,&count,&used);
+    test_check(!err && count == 1 && y[1] == 34.0,"parse last span");
+
+    // full destination
+    err = proc_parse_numbers(txt,(int)strlen(txt),y,3,0,1,&count,&used);
+    test_check(!err && count == 3 && y[2] == -3e-2 && used < (int)strlen(txt),"parse full destination");
+
+    // invalid text
+    char inv[] = "1 2 abc 3";
+    err = proc_parse_numbers(inv,(int)strlen(inv),y,64,0,1,&count,&used);
+    test_check(err == LVP_EC_NUM_FORMAT && count == 2 && used == 4,"parse invalid text");
+
+    // exact conversion of random doubles
+    char num[64];
+    unsigned __int64 seed = 88172645463325252ull;
+    match = 1;
+    for(int k = 0; k < 100000 && match; k++)
+    {
+        double x = test_rand_double(&seed);
+        sprintf(num,"%.17g",x);
+        err = proc_parse_numbers(num,(int)strlen(num),y,1,0,1,&count,NULL);
+        match = !err && count == 1 && y[0] == x;
+    }
+    test_check(match,"parse random doubles");
+}
+
+// matrix formatter
+static void test_format(void)
+{
+    char buf[4096];
+    double y[256];
+    __int32 ret,count;
+
+    // shortest strings
+    double x[6] = {0.1,-2.5,1e-320,1e300,123456789.0,5e-324};
+    int err = proc_format_matrix("x",x,2,3,0,buf,sizeof(buf),&ret);
+    buf[ret] = '\0';
+    test_check(!err && strcmp(buf,"x=[.1,-2.5,1e-320;1e300,123456789,5e-324];\n") == 0,"format matrix");
+
+    // format and parse back
+    err = proc_parse_numbers(&buf[3],ret - 6,y,256,0,1,&count,NULL);
+    test_check(!err && count == 6 && memcmp(x,y,sizeof(x)) == 0,"format matrix round trip");
+
+    // complex
+    double c[4] = {1.5,-2.0,0.0,0.25};
+    err = proc_format_matrix("c",c,1,2,1,buf,sizeof(buf),&ret);
+    err |= proc_parse_numbers(&buf[3],ret - 6,y,256,1,1,&count,NULL);
+    test_check(!err && count == 2 && memcmp(c,y,sizeof(c)) == 0,"format complex round trip");
+
+    // random doubles
+    unsigned __int64 seed = 2463534242ull;
+    int match = 1;
+    for(int k = 0; k < 1000 && match; k++)
+    {
+        double r[100];
+        for(int n = 0; n < 100; n++)
+            r[n] = test_rand_double(&seed);
+        err = proc_format_matrix("r",r,10,10,0,buf,sizeof(buf),&ret);
+        err |= proc_parse_numbers(&buf[3],ret - 6,y,256,0,1,&count,NULL);
+        match = !err && count == 100 && memcmp(r,y,sizeof(r)) == 0;
+    }
+    test_check(match,"format random doubles round trip");
+
+    // errors
+    test_check(proc_format_matrix("1x",x,2,3,0,buf,sizeof(buf),NULL) == LVP_EC_NUM_NAME,"format invalid name");
+    err = proc_format_matrix("x",x,2,3,0,buf,10,&ret);
+    test_check(err == LVP_EC_NUM_SMALL_BUF && ret > 10,"format small buffer");
+}
+
+// MAT-4 file write and read
+static void test_mat(void)
+{
+    char path[MAX_PATH];
+    char name[LVP_MAT_MAX_NAME];
+    GetTempPathA(MAX_PATH - 32,path);
+    strcat(path,"lv_proc_test.mat");
+
+    // real matrix (row-major) and complex matrix (column-major)
+    double a[6] = {1.0,2.0,3.0,4.0,5.0,6.0};
+    double b[8] = {1.0,-1.0,2.0,-2.0,3.0,-3.0,4.0,-4.0};
+    int err = proc_mat_write(path,"a",a,2,3,0,1,LVP_MAT_FORMAT_MAT4,0);
+    err |= proc_mat_write(path,"b",b,2,2,1,0,LVP_MAT_FORMAT_MAT4,1);
+    test_check(!err,"MAT write");
+
+    TLVPMatFile *mat = NULL;
+    __int32 count = 0;
+    err = proc_mat_open(path,&mat,&count);
+    test_check(!err && count == 2,"MAT open");
+    if(!err)
+    {
+        __int32 var,type,text,rows,cols,cplx,ret,size;
+        double y[8];
+        char *re,*im;
+
+        err = proc_mat_find(mat,"a",&var);
+        err |= proc_mat_info(mat,var,name,sizeof(name),&type,&text,&rows,&cols,&cplx);
+        test_check(!err && var == 0 && strcmp(name,"a") == 0 && type == 0 && !text && rows == 2 && cols == 3 && !cplx,"MAT info");
+        err = proc_mat_read(mat,var,y,8,1,&ret);
+        test_check(!err && ret == 6 && memcmp(a,y,sizeof(a)) == 0,"MAT read row-major");
+        err = proc_mat_read(mat,var,y,8,0,&ret);
+        test_check(!err && ret == 6 && y[0] == 1.0 && y[1] == 4.0 && y[2] == 2.0 && y[5] == 6.0,"MAT read column-major");
+
+        err = proc_mat_find(mat,"b",&var);
+        err |= proc_mat_info(mat,var,NULL,0,NULL,NULL,&rows,&cols,&cplx);
+        err |= proc_mat_read(mat,var,y,8,0,&ret);
+        test_check(!err && var == 1 && rows == 2 && cols == 2 && cplx && ret == 8 && memcmp(b,y,sizeof(b)) == 0,"MAT read complex");
+        err = proc_mat_data(mat,var,&re,&im,&size);
+        test_check(!err && size == 4*sizeof(double) && im && ((double*)re)[3] == 4.0 && ((double*)im)[3] == -4.0,"MAT data pointers");
+
+        test_check(proc_mat_find(mat,"c",&var) == LVP_EC_MAT_NOT_FOUND,"MAT variable not found");
+        test_check(proc_mat_read(mat,1,y,7,0,NULL) == LVP_EC_MAT_SMALL_BUF,"MAT small buffer");
+        proc_mat_close(mat);
+    }
+
+    // overwrite, invalid name
+    err = proc_mat_write(path,"c",a,1,6,0,0,LVP_MAT_FORMAT_MAT4,0);
+    err |= proc_mat_open(path,&mat,&count);
+    if(!err)
+        proc_mat_close(mat);
+    test_check(!err && count == 1,"MAT overwrite");
+    test_check(proc_mat_write(path,"1c",a,1,6,0,0,LVP_MAT_FORMAT_MAT4,0) == LVP_EC_NUM_NAME,"MAT invalid name");
+
+    // not a MAT file
+    FILE *fw = fopen(path,"wb");
+    if(fw)
+    {
+        fwrite("not a MAT file, just some text data",1,35,fw);
+        fclose(fw);
+    }
+    test_check(proc_mat_open(path,&mat,NULL) == LVP_EC_MAT_FORMAT,"MAT invalid file");
+    DeleteFileA(path);
+}
+
+// pool of temporary files
+static void test_tmp(void)
+{
+    char path[MAX_PATH];
+    char path2[MAX_PATH];
+    double a[4] = {1.0,2.0,3.0,4.0};
+    TLVPTmpPool *pool = NULL;
+    TLVPMatFile *mat = NULL;
+    __int32 f1,f2,f3,count,var;
+
+    test_check(proc_tmp_pool_create(NULL,0,0,&pool) == LVP_EC_TMP_INVALID,"tmp invalid pool size");
+    int err = proc_tmp_pool_create(NULL,2,65536,&pool);
+    test_check(!err,"tmp pool create");
+    if(err)
+        return;
+
+    // all files of pool
+    err = proc_tmp_acquire(pool,1024,&f1,path,sizeof(path));
+    err |= proc_tmp_acquire(pool,1024,&f2,path2,sizeof(path2));
+    test_check(!err && f1 != f2 && strcmp(path,path2) != 0,"tmp acquire");
+    test_check(proc_tmp_acquire(pool,1024,&f3,NULL,0) == LVP_EC_TMP_BUSY,"tmp pool busy");
+
+    // matrices appended to file
+    err = proc_tmp_write_matrix(pool,f1,"a",a,2,2,0,0,LVP_MAT_FORMAT_MAT4);
+    err |= proc_tmp_write_matrix(pool,f1,"b",a,1,4,0,0,LVP_MAT_FORMAT_MAT4);
+    err |= proc_mat_open(path,&mat,&count);
+    if(!err)
+    {
+        double y[4];
+        err = proc_mat_find(mat,"b",&var);
+        err |= proc_mat_read(mat,var,y,4,0,NULL);
+        test_check(!err && count == 2 && memcmp(a,y,sizeof(a)) == 0,"tmp write matrix");
+        proc_mat_close(mat);
+    }
+    else
+        test_check(0,"tmp write matrix");
+
+    // reused file is empty
+    test_check(proc_tmp_release(pool,f1) == 0,"tmp release");
+    test_check(proc_tmp_write_matrix(pool,f1,"c",a,2,2,0,0,LVP_MAT_FORMAT_MAT4) == LVP_EC_TMP_INVALID,"tmp write released file");
+    err = proc_tmp_acquire(pool,0,&f3,path2,sizeof(path2));
+    err |= proc_tmp_write_matrix(pool,f3,"c",a,2,2,0,0,LVP_MAT_FORMAT_MAT4);
+    err |= proc_mat_open(path2,&mat,&count);
+    if(!err)
+        proc_mat_close(mat);
+    test_check(!err && f3 == f1 && strcmp(path,path2) == 0 && count == 1,"tmp reuse file");
+
+    // files are deleted with pool
+    proc_tmp_pool_free(pool);
+    FILE *fr = fopen(path,"rb");
+    test_check(!fr,"tmp pool free");
+    if(fr)
+        fclose(fr);
+}
+
+// read process stdout till mark appears, returns 0 if found
+static int test_read_until(TLVPHndl *proc,const char *mark,char *buf,int buflen,int timeout)
+{
+    int len = 0;
+    DWORD start = GetTickCount();
+    buf[0] = '\0';
+    while(!strstr(buf,mark))
+    {
+        __int32 read = 0;
+        if(len >= buflen - 1 || (int)(GetTickCount() - start) > timeout)
+            return(1);
+        proc_peek_stdout(proc,NULL,&buf[len],buflen - len,&read,NULL);
+        len += read;
+        if(!read)
+            Sleep(1);
+    }
+    return(0);
+}
+
+// start Octave with GOLPI package loaded
+static int test_octave_open(TLVPHndl *proc,char *octave)
+{
+    char buf[4096];
+    if(proc_create(proc,NULL,octave,1,1))
+        return(1);
+    proc_write_stdin(proc,"pkg load golpi;disp('GOLPIinit');fflush(stdout);\n",-100,NULL);
+    if(test_read_until(proc,"GOLPIinit\n",buf,sizeof(buf),30000))
+    {
+        proc_terminate(proc,1000);
+        proc_cleanup(proc);
+        return(1);
+    }
+    return(0);
+}
+
+// exit Octave
+static void test_octave_close(TLVPHndl *proc)
+{
+    proc_write_stdin(proc,"exit\n",-100,NULL);
+    if(proc_wait_exit(proc,NULL,5000))
+        proc_terminate(proc,1000);
+    proc_cleanup(proc);
+}
+
+// evaluate condition in Octave, returns non-zero if true
+static int test_octave_check(TLVPHndl *proc,const char *cond)
+{
+    char buf[4096];
+    char cmd[1024];
+    sprintf(cmd,"printf('GOLPIcheck%%d',all(%s(:)));disp('GOLPIdone');fflush(stdout);\n",cond);
+    proc_write_stdin(proc,cmd,-(int)sizeof(cmd),NULL);
+    return(!test_read_until(proc,"GOLPIdone\n",buf,sizeof(buf),10000) && strstr(buf,"GOLPIcheck1GOLPIdone\n"));
+}
+
+// Bitstream receive by stdout readout thread
+static void test_octave_bitstream(TLVPHndl *proc)
+{
+    const int N = 50000;
+    double *y = (double*)malloc(N*sizeof(double));
+    char buf[4096];
+    char cmd[256];
+
+    test_check(proc_bitstream_wait(proc,0,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_NOT_ARMED,"bitstream receive not armed");
+
+    for(int coding = 0; coding < 2; coding++)
+    {
+        test_check(proc_bitstream_arm(proc) == 0,"bitstream arm");
+        sprintf(cmd,"disp('before');golpi_data2bits((1:%d)*0.5,3,1,%d);disp('after');fflush(stdout);\n",N,coding);
+        proc_write_stdin(proc,cmd,-(int)sizeof(cmd),NULL);
+
+        __int32 type,elsize,dims[4],ndims,size,ret;
+        int err = proc_bitstream_wait(proc,10000,&type,&elsize,dims,4,&ndims,&size);
+        test_check(!err && type == 3 && elsize == 8 && ndims == 2 && dims[0] == 1 && dims[1] == N && size == N*(int)sizeof(double),"bitstream receive header");
+        memset(y,0,N*sizeof(double));
+        err = proc_bitstream_fetch(proc,(char*)y,N*sizeof(double),&ret);
+        int match = !err && ret == N*(int)sizeof(double);
+        for(int k = 0; k < N && match; k++)
+            match = (y[k] == (k + 1)*0.5);
+        test_check(match,"bitstream receive data");
+
+        // text around the stream goes to stdout fifo
+        test_check(!test_read_until(proc,"after\n",buf,sizeof(buf),5000) && strstr(buf,"before\n") && !strstr(buf,BS_HDR_ID),"bitstream receive text");
+        test_check(proc_bitstream_wait(proc,0,NULL,NULL,NULL,0,NULL,NULL) == LVP_EC_BS_NOT_ARMED,"bitstream disarmed by fetch");
+    }
+
+    // disarmed receive leaves stream in stdout fifo
+    proc_bitstream_arm(proc);
+    test_check(proc_bitstream_disarm(proc) == 0,"bitstream disarm");
+    proc_write_stdin(proc,"golpi_data2bits(1:3,3,1);disp('after');fflush(stdout);\n",-100,NULL);
+    test_check(!test_read_until(proc,"after\n",buf,sizeof(buf),5000) && strstr(buf,BS_HDR_ID),"bitstream disarmed text");
+
+    free(y);
+}
+
+// variables sent as binary frames via stdin
+static void test_octave_frame_in(TLVPHndl *proc)
+{
+    char buf[4096];
+
+    // double matrix (column-major)
+    double x[6] = {0.5,1.0,1.5,2.0,2.5,3.0};
+    int err = proc_write_binary_frame(proc,"x",8,2,3,(char*)x,sizeof(x),10000,NULL);
+    test_check(!err && !test_read_until(proc,"GOLPImark\n",buf,sizeof(buf),10000),"binary frame write");
+    test_check(test_octave_check(proc,"isequal(x,reshape(0.5:0.5:3,2,3))"),"binary frame double");
+
+    // string and int16
+    err = proc_write_binary_frame(proc,"s",1,1,5,"hello",5,10000,NULL);
+    test_check(!err && !test_read_until(proc,"GOLPImark\n",buf,sizeof(buf),10000) && test_octave_check(proc,"strcmp(s,'hello')"),"binary frame string");
+    short i16[3] = {-1,0,32767};
+    err = proc_write_binary_frame(proc,"i",4,3,1,(char*)i16,sizeof(i16),10000,NULL);
+    test_check(!err && !test_read_until(proc,"GOLPImark\n",buf,sizeof(buf),10000) && test_octave_check(proc,"isequal(i,int16([-1;0;32767]))"),"binary frame int16");
+
+    // large frame
+    const int N = 1000000;
+    double *y = (double*)malloc(N*sizeof(double));
+    for(int k = 0; k < N; k++)
+        y[k] = k;
+    err = proc_write_binary_frame(proc,"y",8,N,1,(char*)y,N*sizeof(double),10000,NULL);
+    test_check(!err && !test_read_until(proc,"GOLPImark\n",buf,sizeof(buf),10000) && test_octave_check(proc,"isequal(y,(0:999999)')"),"binary frame large");
+    free(y);
+
+    // invalid variable name is not sent
+    test_check(proc_write_binary_frame(proc,"1x",8,1,1,(char*)x,8,1000,NULL) == LVP_EC_NUM_NAME,"binary frame invalid name");
+}
+
+// variables sent by Octave as binary frames via stdout
+static void test_octave_frame_out(TLVPHndl *proc)
+{
+    const int N = 200000;
+    int bufsize = 12 + N*sizeof(double);
+    char *buf = (char*)malloc(bufsize);
+    char txt[4096];
+    __int32 ch,size,ret;
+    DWORD head[3];
+
+    // multi-frame message and short message of other channel between text lines
+    proc_write_stdin(proc,"disp('before');golpi_stdout_send(reshape(1:200000,1000,200),3);golpi_stdout_send('abc',5);disp('after');fflush(stdout);\n",-200,NULL);
+    int err = proc_frame_wait(proc,5,10000,&ch,&size);
+    test_check(!err && ch == 5 && size == 12 + 3,"frame wait");
+    err = proc_frame_wait(proc,-1,0,&ch,&size);
+    test_check(!err && ch == 3 && size == bufsize,"frame wait any channel");
+
+    // too small buffer leaves message queued
+    test_check(proc_frame_fetch(proc,3,buf,bufsize - 1,NULL,&ret) == LVP_EC_FRAME_SMALL_BUF && ret == bufsize,"frame small buffer");
+    err = proc_frame_fetch(proc,3,buf,bufsize,&ch,&ret);
+    memcpy(head,buf,sizeof(head));
+    int match = !err && ch == 3 && ret == bufsize && head[0] == 8 && head[1] == 1000 && head[2] == 200;
+    for(int k = 0; k < N && match; k++)
+    {
+        double x;
+        memcpy(&x,&buf[12 + k*sizeof(double)],sizeof(double));
+        match = (x == k + 1);
+    }
+    test_check(match,"frame fetch double");
+    err = proc_frame_fetch(proc,-1,buf,bufsize,&ch,&ret);
+    memcpy(head,buf,sizeof(head));
+    test_check(!err && ch == 5 && ret == 15 && head[0] == 1 && head[1] == 1 && head[2] == 3 && memcmp(&buf[12],"abc",3) == 0,"frame fetch string");
+    test_check(proc_frame_fetch(proc,-1,buf,bufsize,NULL,NULL) == LVP_EC_FRAME_EMPTY && proc_frame_wait(proc,-1,0,NULL,NULL) == LVP_EC_FRAME_EMPTY,"frame queue empty");
+
+    // text goes to stdout fifo without frames
+    test_check(!test_read_until(proc,"after\n",txt,sizeof(txt),5000) && strstr(txt,"before\n") && strstr(txt,"GOLPImark\n") && !strchr(txt,0x1B),"frame text");
+
+    // discard queued messages
+    proc_write_stdin(proc,"golpi_stdout_send(1:10);fflush(stdout);\n",-100,NULL);
+    err = proc_frame_wait(proc,0,10000,NULL,NULL);
+    err |= proc_frame_clear(proc);
+    test_check(!err && proc_frame_fetch(proc,-1,buf,bufsize,NULL,NULL) == LVP_EC_FRAME_EMPTY,"frame clear");
+    test_read_until(proc,"GOLPImark\n",txt,sizeof(txt),5000);
+
+    free(buf);
+}
+
+// tagged requests pipelining
+static void test_octave_request(TLVPHndl *proc)
+{
+    char buf[4096];
+    __int32 id1,id2,id3,ret,status;
+
+    // more requests in flight, read in reverse order
+    int err = proc_request_send(proc,"pause(0.2);disp('first')",-100,&id1);
+    err |= proc_request_send(proc,"x = 1;\ny = x + 1",-100,&id2);
+    err |= proc_request_send(proc,"error('request failed')",-100,&id3);
+    test_check(!err && id1 != id2 && id2 != id3,"request send");
+
+    err = proc_request_read(proc,id3,10000,buf,sizeof(buf),&ret,&status);
+    test_check(!err && status == 1 && strstr(buf,"request failed") && !strchr(buf,0x1B),"request failed command");
+    test_check(proc_request_read(proc,id2,10000,buf,4,&ret,&status) == LVP_EC_REQ_SMALL_BUF,"request small buffer");
+    err = proc_request_read(proc,id2,10000,buf,sizeof(buf),&ret,&status);
+    test_check(!err && status == 0 && strstr(buf,"y = 2") && ret == (int)strlen(buf),"request multi-line command");
+    err = proc_request_read(proc,id1,10000,buf,sizeof(buf),&ret,&status);
+    test_check(!err && status == 0 && strcmp(buf,"first\n") == 0,"request output");
+
+    // released request
+    test_check(proc_request_read(proc,id1,0,buf,sizeof(buf),NULL,NULL) == LVP_EC_REQ_UNKNOWN,"request released");
+
+    // untagged output goes to stdout fifo
+    proc_write_stdin(proc,"disp('untagged');fflush(stdout);\n",-100,NULL);
+    err = proc_request_send(proc,"disp('tagged')",-100,&id1);
+    err |= proc_request_read(proc,id1,10000,buf,sizeof(buf),NULL,NULL);
+    test_check(!err && strcmp(buf,"tagged\n") == 0,"request tagged output");
+    test_check(!test_read_until(proc,"untagged\n",buf,sizeof(buf),5000) && !strstr(buf,"\ntagged") && strncmp(buf,"tagged",6) != 0,"request untagged output");
+}
+
+// asynchronous commands
+static void test_octave_async(TLVPHndl *proc)
+{
+    char buf[4096];
+    __int32 t1,t2,t3,state,size,status;
+
+    int err = proc_command_submit(proc,"pause(0.5);disp('slow')",-100,&t1);
+    err |= proc_command_submit(proc,"disp('fast')",-100,&t2);
+    err |= proc_command_poll(proc,t2,&state,&size);
+    test_check(!err && (state == LVP_CMD_QUEUED || state == LVP_CMD_RUNNING),"command poll pending");
+
+    // commands are done in order of submission
+    err = proc_command_wait(proc,t2,10000,&status,&size);
+    test_check(!err && status == 0 && size == 5,"command wait");
+    err = proc_command_poll(proc,t1,&state,&size);
+    test_check(!err && state == LVP_CMD_DONE && size == 5,"command poll done");
+    err = proc_request_read(proc,t1,0,buf,sizeof(buf),NULL,&status);
+    test_check(!err && status == 0 && strcmp(buf,"slow\n") == 0,"command output");
+    proc_request_read(proc,t2,0,buf,sizeof(buf),NULL,NULL);
+
+    // wait timeout leaves command pending
+    err = proc_command_submit(proc,"pause(1);disp('timeout')",-100,&t1);
+    test_check(!err && proc_command_wait(proc,t1,100,NULL,NULL) == LVP_EC_TIMEOUT,"command wait timeout");
+
+    // cancelled command output is discarded
+    test_check(proc_command_cancel(proc,t1) == 0,"command cancel");
+    test_check(proc_command_poll(proc,t1,&state,NULL) == LVP_EC_REQ_UNKNOWN,"command cancelled ticket");
+    err = proc_command_submit(proc,"disp('next')",-100,&t3);
+    err |= proc_command_wait(proc,t3,10000,&status,NULL);
+    err |= proc_request_read(proc,t3,0,buf,sizeof(buf),NULL,NULL);
+    test_check(!err && strcmp(buf,"next\n") == 0,"command after cancel");
+    proc_peek_stdout(proc,NULL,buf,sizeof(buf),NULL,NULL);
+    test_check(!strstr(buf,"timeout"),"command cancelled output");
+}
+
+// pool of pre-initialized instances
+static void test_octave_warm(char *octave)
+{
+    TLVPWarmPool *pool = NULL;
+    TLVPHndl *p1 = (TLVPHndl*)malloc(sizeof(TLVPHndl));
+    TLVPHndl *p2 = (TLVPHndl*)malloc(sizeof(TLVPHndl));
+
+    test_check(proc_warm_pool_create(NULL,octave,1,"pkg load golpi",0,30000,&pool) == LVP_EC_WARM_INVALID,"warm pool invalid count");
+    int err = proc_warm_pool_create(NULL,octave,1,"pkg load golpi;warm_x = 5;",1,30000,&pool);
+    test_check(!err,"warm pool create");
+    if(!err)
+    {
+        // initialized instance
+        err = proc_warm_acquire(pool,p1,30000);
+        test_check(!err && test_octave_check(p1,"warm_x == 5 && exist('golpi_dispatch')"),"warm acquire");
+        if(!err)
+        {
+            // replacement instance is being initialized
+            test_check(proc_warm_acquire(pool,p2,0) == LVP_EC_TIMEOUT,"warm acquire timeout");
+            err = proc_warm_acquire(pool,p2,30000);
+            test_check(!err && test_octave_check(p2,"warm_x == 5"),"warm acquire replacement");
+            if(!err)
+                test_octave_close(p2);
+            test_octave_close(p1);
+        }
+        proc_warm_pool_free(pool);
+    }
+
+    free(p1);
+    free(p2);
+}
+
+// process scheduling options
+static void test_octave_sched(char *octave)
+{
+    TLVPHndl *p = (TLVPHndl*)malloc(sizeof(TLVPHndl));
+    DWORD_PTR avail,sys,mask;
+    GetProcessAffinityMask(GetCurrentProcess(),&avail,&sys);
+
+    // first available CPU for process and readout thread
+    DWORD_PTR first = avail & (~avail + 1);
+    int err = proc_create_ex(p,NULL,octave,1,1,first,-1,LVP_PRIO_BELOW_NORMAL,first,NULL);
+    test_check(!err,"create with affinity");
+    if(!err)
+    {
+        test_check(GetProcessAffinityMask(p->hproc,&mask,&sys) && mask == first,"process affinity");
+        test_check(GetPriorityClass(p->hproc) == BELOW_NORMAL_PRIORITY_CLASS,"process priority");
+        test_check(test_octave_check(p,"true"),"process with affinity runs");
+        test_octave_close(p);
+    }
+
+    // no available CPU
+    if(~avail)
+        test_check(proc_create_ex(p,NULL,octave,1,1,~avail,-1,LVP_PRIO_DEFAULT,0,NULL) == LVP_EC_AFFINITY,"create with unavailable CPUs");
+    test_check(proc_create_ex(p,NULL,octave,1,1,0,200,LVP_PRIO_DEFAULT,0,NULL) == LVP_EC_AFFINITY,"create with invalid NUMA node");
+
+    free(p);
+}
+
+// thread sharing process instance by command queue
+typedef struct{
+    TLVPHndl *proc;
+    int index;
+    int errors;
+}TTestQueueThread;
+static DWORD WINAPI test_queue_thread(LPVOID arg)
+{
+    TTestQueueThread *th = (TTestQueueThread*)arg;
+    char cmd[64];
+    char buf[256];
+    char ref[64];
+    for(int k = 0; k < 20; k++)
+    {
+        sprintf(cmd,"disp(%d)",1000*th->index + k);
+        sprintf(ref,"%d\n",1000*th->index + k);
+        __int32 status;
+        if(proc_queue_command(th->proc,(k%2)?LVP_LANE_BULK:LVP_LANE_NORMAL,cmd,-64,10000,buf,sizeof(buf),NULL,&status) || status || strcmp(buf,ref) != 0)
+            th->errors++;
+    }
+    return(0);
+}
+
+// command queue
+static void test_octave_queue(TLVPHndl *proc)
+{
+    char buf[256];
+    __int32 t[4],state,status;
+
+    test_check(proc_queue_config(proc,0,4,1) == LVP_EC_QUEUE_INVALID,"queue invalid config");
+    test_check(proc_queue_config(proc,1,4,1) == 0,"queue config");
+
+    // control lane goes before queued bulk commands
+    int err = 0;
+    for(int k = 0; k < 3; k++)
+    {
+        sprintf(buf,"pause(0.3);disp('bulk%d')",k);
+        err |= proc_queue_submit(proc,LVP_LANE_BULK,buf,-100,&t[k]);
+    }
+    err |= proc_queue_submit(proc,LVP_LANE_CONTROL,"disp('control')",-100,&t[3]);
+    err |= proc_command_wait(proc,t[3],10000,&status,NULL);
+    err |= proc_command_poll(proc,t[2],&state,NULL);
+    test_check(!err && state != LVP_CMD_DONE,"queue control lane");
+    for(int k = 0; k < 4; k++)
+    {
+        err |= proc_command_wait(proc,t[k],10000,&status,NULL);
+        err |= proc_request_read(proc,t[k],0,buf,sizeof(buf),NULL,NULL);
+        if(k < 3)
+            err |= (strncmp(buf,"bulk",4) != 0 || buf[4] != '0' + k);
+    }
+    test_check(!err && strcmp(buf,"control\n") == 0,"queue submit");
+
+    // threads sharing process instance
+    proc_queue_config(proc,4,4,1);
+    TTestQueueThread th[4];
+    HANDLE hth[4];
+    int started = 0;
+    for(int k = 0; k < 4; k++)
+    {
+        th[k].proc = proc;
+        th[k].index = k + 1;
+        th[k].errors = 0;
+        hth[k] = CreateThread(NULL,0,test_queue_thread,(LPVOID)&th[k],0,NULL);
+        if(!hth[k])
+            break;
+        started++;
+    }
+    WaitForMultipleObjects(started,hth,TRUE,INFINITE);
+    int errors = 0;
+    for(int k = 0; k < started; k++)
+    {
+        errors += th[k].errors;
+        CloseHandle(hth[k]);
+    }
+    test_check(started == 4 && !errors,"queue shared by threads");
+
+    // failed command status
+    err = proc_queue_command(proc,LVP_LANE_NORMAL,"error('queue failed')",-100,10000,buf,sizeof(buf),NULL,&status);
+    test_check(!err && status == 1 && strstr(buf,"queue failed"),"queue failed command");
+}
+
+// run self-test
+static int self_test(char *octave)
+{
+    test_bitstream();
+    test_struct();
+    test_parse();
+    test_format();
+    test_mat();
+    test_tmp();
+
+    // tests with Octave process
+    if(octave)
+    {
+        TLVPHndl *proc = (TLVPHndl*)malloc(sizeof(TLVPHndl));
+        int err = test_octave_open(proc,octave);
+        test_check(!err,"Octave start");
+        if(!err)
+        {
+            test_octave_bitstream(proc);
+            test_octave_frame_in(proc);
+            test_octave_frame_out(proc);
+            test_octave_request(proc);
+            test_octave_async(proc);
+            test_octave_queue(proc);
+            test_octave_close(proc);
+        }
+        free(proc);
+        test_octave_warm(octave);
+        test_octave_sched(octave);
+    }
+
+    printf("%d checks, %d failed\n",test_count,test_failed);
+    return(test_failed != 0);
+}
+
 int main(int argc,char **argv)
 {
 	char str[256];
 
+    // self-test mode
+    if(argc >= 2 && strcmp(argv[1],"test") == 0)
+        return(self_test((argc >= 3)?argv[2]:NULL));
+
     // get DLL version string
     proc_get_dll_version(str,sizeof(str));
     // print it